@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal Google Benchmark style harness, kept in tree so the project has no extra dependency.
+//   static void BM_Something(Benchmarks::State& state) {
+//     for (auto _ : state) { ... }
+//   }
+//   BENCHMARK(BM_Something)->arg(64)->arg(1024);
+namespace Benchmarks {
+  template <typename T>
+  inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+  }
+  inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+  class State {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    State(uint64_t iterations, std::vector<int64_t> args) : iterations(iterations), args(std::move(args)) {}
+
+    int64_t arg(size_t index = 0) const { return this->args.at(index); }
+    uint64_t getIterations() const { return this->iterations; }
+    // Excludes setup done inside the loop from the measurement
+    void pauseTiming() { this->elapsed += Clock::now() - this->start; }
+    void resumeTiming() { this->start = Clock::now(); }
+    void setItemsProcessed(int64_t items) { this->itemsProcessed = items; }
+    // Reports a failed check, called before the loop it skips the measurement
+    void skipWithError(std::string message) { this->error = std::move(message); }
+    const std::string& getError() const { return this->error; }
+    // Reported as is in the results, e.g. frame time percentiles of macro benchmarks
+    std::map<std::string, double> counters;
+
+    struct Iterator {
+      State* state;
+      uint64_t remaining;
+      bool operator!=(const Iterator&) const {
+        if (this->remaining != 0)
+          return true;
+        this->state->finish();
+        return false;
+      }
+      Iterator& operator++() { this->remaining--; return *this; }
+      int operator*() const { return 0; }
+    };
+    Iterator begin() { this->start = Clock::now(); return { this, this->error.empty() ? this->iterations : 0 }; }
+    Iterator end() { return { this, 0 }; }
+
+    double getSeconds() const { return std::chrono::duration<double>(this->elapsed).count(); }
+    int64_t getItemsProcessed() const { return this->itemsProcessed; }
+  private:
+    void finish() { this->elapsed += Clock::now() - this->start; }
+
+    uint64_t iterations;
+    std::vector<int64_t> args;
+    Clock::time_point start{};
+    Clock::duration elapsed{};
+    int64_t itemsProcessed = 0;
+    std::string error;
+  };
+
+  using Function = void (*)(State&);
+
+  class Benchmark {
+  public:
+    Benchmark(std::string name, Function function) : name(std::move(name)), function(function) {}
+
+    Benchmark* arg(int64_t value) { this->argSets.push_back({ value }); return this; }
+    Benchmark* args(std::vector<int64_t> values) { this->argSets.push_back(std::move(values)); return this; }
+    // Fixed iteration count instead of calibrating against the minimum time, for macro benchmarks
+    Benchmark* iterations(uint64_t count) { this->fixedIterations = count; return this; }
+
+    std::string name;
+    Function function;
+    std::vector<std::vector<int64_t>> argSets;
+    uint64_t fixedIterations = 0;
+  };
+
+  struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    // median over the repetitions
+    double nanosecondsPerIteration = 0.0;
+    double minNanosecondsPerIteration = 0.0;
+    double maxNanosecondsPerIteration = 0.0;
+    double itemsPerSecond = 0.0;
+    std::map<std::string, double> counters;
+    // set when a check of the benchmark failed, the timings are meaningless then
+    std::string error;
+  };
+
+  struct RunOptions {
+    // substring of the benchmark names to run, everything when empty
+    std::string filter;
+    double minSeconds = .2;
+    uint32_t repetitions = 5;
+  };
+
+  Benchmark* Register(const char* name, Function function);
+  std::vector<Result> RunAll(const RunOptions& options);
+  void PrintResults(const std::vector<Result>& results);
+  bool WriteJson(std::string_view path, const std::vector<Result>& results, const std::map<std::string, std::string>& context);
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+#define BENCHMARK(function) \
+  static ::Benchmarks::Benchmark* BENCHMARK_CONCAT(benchmark_, __LINE__) = ::Benchmarks::Register(#function, function)
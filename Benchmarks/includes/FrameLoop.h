@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Benchmarks {
+  // Frames rendered before the frame times start being recorded
+  constexpr uint32_t FrameLoopWarmupFrames = 30;
+  constexpr uint32_t FrameLoopMeasuredFrames = 300;
+
+  // Absolute path of the benchmark executable, the Application resolves the working directory from it
+  void SetExecutablePath(std::string path);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <engine/events/Event.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Benchmarks::Legacy {
+  using Engine::Event;
+  using Engine::EventTag;
+
+  // Frozen copy of the EventSystem before the typed channel rewrite (std::function listeners behind a dynamic_cast,
+  // priority_queue storage, heap allocated queued events), kept as the baseline of the event benchmarks.
+  class EventSystem {
+  private:
+    struct EventListener {
+      std::function<bool(Event&)> listener;
+      uint8_t priority = 0;
+      uint32_t handle = 0;
+
+      bool operator>(const EventListener& other) const { return this->priority < other.priority; }
+      bool operator<(const EventListener& other) const { return this->priority > other.priority; }
+    };
+    class EventListenerQueue : public std::priority_queue<EventListener, std::vector<EventListener>, std::greater<EventListener>> {
+    public:
+      bool operator()(Event& event) {
+        bool handled = false;
+        for (auto& listener : this->c) {
+          handled |= listener.listener(event);
+          if (event.handled)
+            break;
+        }
+        return handled;
+      }
+      bool pop(uint64_t handle) {
+        auto it = std::find_if(this->c.begin(), this->c.end(), [handle](const EventListener& listener) {
+          return listener.handle == handle;
+        });
+        if (it == this->c.end())
+          return false;
+        this->c.erase(it);
+        return true;
+      }
+    };
+  public:
+    template <typename T, typename F>
+    uint64_t on(F cb, uint8_t priority = 0) {
+      auto tag = typename T::Tag{};
+      uint32_t handle = this->listenerId++;
+      this->listeners[static_cast<EventTag::ID>(tag)].push({ [cb](Event& raw) {
+        T& event = dynamic_cast<T&>(raw);
+        if constexpr (std::is_same_v<std::invoke_result_t<F, T&>, bool>) {
+          return cb(event);
+        }
+        else {
+          cb(event);
+          return false;
+        }
+      }, priority, handle });
+      return handle;
+    }
+    template <typename T>
+    bool off(uint64_t handle) {
+      auto tag = typename T::Tag{};
+      auto it = this->listeners.find(static_cast<EventTag::ID>(tag));
+      return it != this->listeners.end() && it->second.pop(handle);
+    }
+
+    template <typename T>
+    bool emit(T& event) {
+      auto it = this->listeners.find(static_cast<EventTag::ID>(event));
+      if (it == this->listeners.end())
+        return false;
+      return it->second(event);
+    }
+    template <typename T, typename... Args>
+    bool emit(Args&&... args) {
+      T event(std::forward<Args>(args)...);
+      return this->emit(event);
+    }
+
+    template <typename T, typename... Args>
+    bool queue(Args&&... args) {
+      this->eventQueue.push(std::make_unique<T>(std::forward<Args>(args)...));
+      return true;
+    }
+
+    uint32_t dispatchQueue() {
+      uint32_t count = 0;
+      while (!this->eventQueue.empty()) {
+        auto event = std::move(this->eventQueue.front());
+        this->eventQueue.pop();
+        count += this->emit(*event);
+      }
+      return count;
+    }
+  private:
+    std::unordered_map<EventTag::ID, EventListenerQueue> listeners;
+    std::queue<std::unique_ptr<Event>> eventQueue;
+    uint32_t listenerId = 0;
+  };
+}
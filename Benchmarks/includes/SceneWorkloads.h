@@ -0,0 +1,19 @@
+#pragma once
+
+#include <engine/scene/Scene.h>
+#include <engine/renderer/Mesh.h>
+#include <engine/utils/memory.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Benchmarks {
+  // Seeded so every run and every commit measures the same scene
+  constexpr uint32_t WorkloadSeed = 0x5eed;
+
+  // Transforms scattered over a square grid with a seeded jitter, rotation and scale
+  std::vector<Engine::Components::Transform> GenerateTransforms(uint32_t count, uint32_t seed = WorkloadSeed);
+  // Square grid of count entities centered on the origin, with a mesh component when mesh is set.
+  // Returns the grid half extent.
+  float PopulateGrid(Engine::Scene& scene, uint32_t count, Engine::Ref<Engine::Mesh> mesh = nullptr, uint32_t seed = WorkloadSeed);
+}
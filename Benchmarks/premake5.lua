@@ -0,0 +1,58 @@
+project "Benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir(PROJECT_TARGET_DIR)
+	objdir(PROJECT_OBJ_DIR)
+
+	files {
+		"includes/**.h",
+		"src/**.cpp"
+	}
+
+	includedirs {
+    "includes",
+    "%{Vendors.Engine.shared.include}",
+    -- the Vulkan headers include their siblings from the engine root
+    "%{Vendors.Engine.shared.include}/engine",
+    "%{Vendors.spdlog.shared.include}",
+    "%{Vendors.glm.shared.include}",
+    "%{Vendors.entt.shared.include}",
+	}
+
+	links {
+		"Engine"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+    defines { '_WIN32' }
+    includedirs {
+      "%{Vendors.Vulkan:getInclude('win32')}"
+    }
+
+  filter "system:linux"
+    pic "On"
+    systemversion "latest"
+    defines { '_LINUX' }
+    -- since gmake2 doesn't link agaisnt Engine dependencies, we have to do that ourselves
+    links {
+      "GLFW",
+      "ImGui",
+      "yaml-cpp",
+      "spdlog",
+      "stb_image"
+    }
+
+	filter "configurations:Debug"
+		defines "DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	-- numbers tracked across commits come from Release, Profile adds the allocation counts
+	filter "configurations:Release or Profile"
+		defines "RELEASE"
+		runtime "Release"
+		optimize "on"
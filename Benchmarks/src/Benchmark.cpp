@@ -0,0 +1,156 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+namespace Benchmarks {
+  namespace {
+    std::vector<std::unique_ptr<Benchmark>>& GetRegistry() {
+      static std::vector<std::unique_ptr<Benchmark>> registry;
+      return registry;
+    }
+
+    std::string GetRunName(const Benchmark& benchmark, const std::vector<int64_t>& args) {
+      std::string name = benchmark.name;
+      for (int64_t arg : args)
+        name += "/" + std::to_string(arg);
+      return name;
+    }
+
+    // Grows the iteration count until a run lasts minSeconds
+    uint64_t Calibrate(const Benchmark& benchmark, const std::vector<int64_t>& args, double minSeconds) {
+      uint64_t iterations = 1;
+      for (;;) {
+        State state(iterations, args);
+        benchmark.function(state);
+        double seconds = state.getSeconds();
+        if (!state.getError().empty() || seconds >= minSeconds || iterations >= (uint64_t{ 1 } << 40))
+          return iterations;
+        double scale = seconds > 0.0 ? minSeconds * 1.4 / seconds : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+      }
+    }
+
+    void WriteJsonString(std::ofstream& file, std::string_view text) {
+      file << '"';
+      for (char c : text) {
+        if (c == '"' || c == '\\')
+          file << '\\';
+        file << c;
+      }
+      file << '"';
+    }
+  }
+
+  Benchmark* Register(const char* name, Function function) {
+    return GetRegistry().emplace_back(std::make_unique<Benchmark>(name, function)).get();
+  }
+
+  std::vector<Result> RunAll(const RunOptions& options) {
+    std::vector<Result> results;
+    for (auto& benchmark : GetRegistry()) {
+      auto argSets = benchmark->argSets;
+      if (argSets.empty())
+        argSets.push_back({});
+      for (auto& args : argSets) {
+        Result result{};
+        result.name = GetRunName(*benchmark, args);
+        if (!options.filter.empty() && result.name.find(options.filter) == std::string::npos)
+          continue;
+        result.iterations = benchmark->fixedIterations ? benchmark->fixedIterations : Calibrate(*benchmark, args, options.minSeconds);
+        uint32_t repetitions = benchmark->fixedIterations ? 1 : std::max(options.repetitions, 1u);
+
+        std::vector<double> samples;
+        std::vector<double> itemRates;
+        for (uint32_t i = 0; i < repetitions; i++) {
+          State state(result.iterations, args);
+          benchmark->function(state);
+          if (!state.getError().empty()) {
+            result.error = state.getError();
+            break;
+          }
+          double seconds = state.getSeconds();
+          samples.push_back(seconds * 1e9 / result.iterations);
+          itemRates.push_back(seconds > 0.0 ? state.getItemsProcessed() / seconds : 0.0);
+          // counters of the last repetition, macro benchmarks only run once
+          result.counters = state.counters;
+        }
+        if (!result.error.empty()) {
+          std::printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+          std::fflush(stdout);
+          results.push_back(std::move(result));
+          continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        std::sort(itemRates.begin(), itemRates.end());
+        result.nanosecondsPerIteration = samples[samples.size() / 2];
+        result.minNanosecondsPerIteration = samples.front();
+        result.maxNanosecondsPerIteration = samples.back();
+        result.itemsPerSecond = itemRates[itemRates.size() / 2];
+        std::printf("%-48s %14.1f ns %12llu\n", result.name.c_str(), result.nanosecondsPerIteration, static_cast<unsigned long long>(result.iterations));
+        std::fflush(stdout);
+        results.push_back(std::move(result));
+      }
+    }
+    return results;
+  }
+
+  void PrintResults(const std::vector<Result>& results) {
+    std::printf("\n%-48s %14s %14s %16s\n", "Benchmark", "Time (ns)", "Min (ns)", "Items/s");
+    for (auto& result : results) {
+      if (!result.error.empty()) {
+        std::printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+        continue;
+      }
+      std::printf(
+        "%-48s %14.1f %14.1f %16.0f\n",
+        result.name.c_str(), result.nanosecondsPerIteration, result.minNanosecondsPerIteration, result.itemsPerSecond
+      );
+      for (auto& [name, value] : result.counters)
+        std::printf("  %-46s %14.3f\n", name.c_str(), value);
+    }
+  }
+
+  bool WriteJson(std::string_view path, const std::vector<Result>& results, const std::map<std::string, std::string>& context) {
+    std::ofstream file{ std::string(path) };
+    if (!file)
+      return false;
+    file << "{\n  \"context\": {";
+    bool first = true;
+    for (auto& [key, value] : context) {
+      file << (first ? "\n    " : ",\n    ");
+      WriteJsonString(file, key);
+      file << ": ";
+      WriteJsonString(file, value);
+      first = false;
+    }
+    file << "\n  },\n  \"benchmarks\": [";
+    first = true;
+    for (auto& result : results) {
+      file << (first ? "\n    {" : ",\n    {");
+      file << "\"name\": ";
+      WriteJsonString(file, result.name);
+      if (!result.error.empty()) {
+        file << ", \"error_occurred\": true, \"error_message\": ";
+        WriteJsonString(file, result.error);
+      }
+      file << ", \"iterations\": " << result.iterations
+        << ", \"real_time\": " << result.nanosecondsPerIteration
+        << ", \"min_time\": " << result.minNanosecondsPerIteration
+        << ", \"max_time\": " << result.maxNanosecondsPerIteration
+        << ", \"time_unit\": \"ns\""
+        << ", \"items_per_second\": " << result.itemsPerSecond;
+      for (auto& [name, value] : result.counters) {
+        file << ", ";
+        WriteJsonString(file, name);
+        file << ": " << value;
+      }
+      file << "}";
+      first = false;
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+  }
+}
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include <engine/core/Callbacks.h>
+#include <engine/core/FrameAllocator.h>
+#include <engine/utils/hash.h>
+
+#include <string>
+
+using Benchmarks::State;
+
+namespace {
+  // Argument is the number of connected listeners, like the LayersManager callbacks with several layers
+  void BM_CallbackInvoke(State& state) {
+    Engine::Callback<float> callback;
+    float sum = 0.f;
+    for (int64_t i = 0; i < state.arg(); i++)
+      callback.connect([&sum](float dt) { sum += dt; return true; });
+    for (auto _ : state)
+      Benchmarks::DoNotOptimize(callback(.016f));
+    Benchmarks::DoNotOptimize(sum);
+    state.setItemsProcessed(state.getIterations() * state.arg());
+  }
+
+  void BM_CallbackConnectDisconnect(State& state) {
+    Engine::Callback<float> callback;
+    for (int64_t i = 0; i < state.arg(); i++)
+      callback.connect([](float) { return true; });
+    for (auto _ : state) {
+      auto handle = callback.connect([](float) { return true; });
+      callback.disconnect(handle);
+      Benchmarks::ClobberMemory();
+    }
+    state.setItemsProcessed(state.getIterations());
+  }
+
+  // Transient list filled once per frame, argument is the element count
+  template <typename Vector>
+  void FillTransientVector(State& state, Engine::FrameAllocator& allocator) {
+    const int64_t count = state.arg();
+    for (auto _ : state) {
+      Vector values;
+      values.reserve(count);
+      for (int64_t i = 0; i < count; i++)
+        values.push_back(static_cast<int>(i));
+      Benchmarks::DoNotOptimize(values.data());
+      allocator.newFrame();
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+  }
+  void BM_HeapVector(State& state) {
+    Engine::FrameAllocator allocator;
+    FillTransientVector<std::vector<int>>(state, allocator);
+  }
+  void BM_FrameVector(State& state) {
+    Engine::FrameAllocator allocator;
+    FillTransientVector<Engine::FrameVector<int>>(state, allocator);
+  }
+
+  // Argument is the string length, event tags and asset names are short
+  void BM_Hash(State& state) {
+    const std::string text(static_cast<size_t>(state.arg()), 'a');
+    for (auto _ : state) {
+      std::string_view view = text;
+      Benchmarks::DoNotOptimize(view);
+      Benchmarks::DoNotOptimize(Engine::Hash(view));
+    }
+    state.setItemsProcessed(state.getIterations() * state.arg());
+  }
+
+  // Same shape as the vertex and position hashes of the mesh loaders
+  void BM_HashCombine(State& state) {
+    float x = 1.f, y = 2.f, z = 3.f;
+    for (auto _ : state) {
+      size_t seed = 0;
+      Benchmarks::DoNotOptimize(x);
+      Engine::HashCombine(seed, x, y, z);
+      Benchmarks::DoNotOptimize(seed);
+    }
+    state.setItemsProcessed(state.getIterations());
+  }
+}
+
+BENCHMARK(BM_CallbackInvoke)->arg(1)->arg(8);
+BENCHMARK(BM_CallbackConnectDisconnect)->arg(8);
+BENCHMARK(BM_HeapVector)->arg(16)->arg(4096);
+BENCHMARK(BM_FrameVector)->arg(16)->arg(4096);
+BENCHMARK(BM_Hash)->arg(16)->arg(256);
+BENCHMARK(BM_HashCombine);
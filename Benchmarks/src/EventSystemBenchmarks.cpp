@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "LegacyEventSystem.h"
+
+#include <engine/events/EventSystem.h>
+
+using Benchmarks::State;
+
+namespace {
+  struct BenchmarkEvent : Engine::Event {
+    struct Tag : Engine::EventTag {
+      Tag() : Engine::EventTag{ "BenchmarkEvent" } {}
+    };
+    BenchmarkEvent(int value = 0) : Engine::Event(Tag{}), value(value) {}
+    int value = 0;
+  };
+
+  template <typename System>
+  void AddListeners(System& system, int64_t count, int64_t& sum) {
+    for (int64_t i = 0; i < count; i++)
+      system.template on<BenchmarkEvent>([&sum](BenchmarkEvent& event) { sum += event.value; });
+  }
+
+  // Synchronous dispatch to every listener of the channel, argument is the listener count
+  template <typename System>
+  void Emit(State& state) {
+    System system;
+    int64_t sum = 0;
+    AddListeners(system, state.arg(), sum);
+    int value = 0;
+    for (auto _ : state)
+      Benchmarks::DoNotOptimize(system.template emit<BenchmarkEvent>(value++));
+    Benchmarks::DoNotOptimize(sum);
+    state.setItemsProcessed(state.getIterations());
+  }
+
+  // Frame worth of queued events drained at once, argument is the batch size
+  template <typename System>
+  void QueueDispatch(State& state) {
+    System system;
+    int64_t sum = 0;
+    AddListeners(system, 1, sum);
+    const int64_t batch = state.arg();
+    for (auto _ : state) {
+      for (int64_t i = 0; i < batch; i++)
+        system.template queue<BenchmarkEvent>(static_cast<int>(i));
+      Benchmarks::DoNotOptimize(system.dispatchQueue());
+    }
+    Benchmarks::DoNotOptimize(sum);
+    state.setItemsProcessed(state.getIterations() * batch);
+  }
+
+  // Listener registration churn, e.g. layers attached and detached at runtime
+  template <typename System>
+  void OnOff(State& state) {
+    System system;
+    int64_t sum = 0;
+    AddListeners(system, state.arg(), sum);
+    for (auto _ : state) {
+      auto handle = system.template on<BenchmarkEvent>([&sum](BenchmarkEvent& event) { sum += event.value; });
+      Benchmarks::DoNotOptimize(system.template off<BenchmarkEvent>(handle));
+    }
+    state.setItemsProcessed(state.getIterations());
+  }
+
+  void BM_EventSystemEmit(State& state) { Emit<Engine::EventSystem>(state); }
+  void BM_LegacyEventSystemEmit(State& state) { Emit<Benchmarks::Legacy::EventSystem>(state); }
+  void BM_EventSystemQueueDispatch(State& state) { QueueDispatch<Engine::EventSystem>(state); }
+  void BM_LegacyEventSystemQueueDispatch(State& state) { QueueDispatch<Benchmarks::Legacy::EventSystem>(state); }
+  void BM_EventSystemOnOff(State& state) { OnOff<Engine::EventSystem>(state); }
+  void BM_LegacyEventSystemOnOff(State& state) { OnOff<Benchmarks::Legacy::EventSystem>(state); }
+
+  // Posted from the main thread, measures the ring round trip without contention
+  void BM_EventSystemPostDispatch(State& state) {
+    Engine::EventSystem system;
+    int64_t sum = 0;
+    AddListeners(system, 1, sum);
+    const int64_t batch = state.arg();
+    for (auto _ : state) {
+      for (int64_t i = 0; i < batch; i++)
+        system.post<BenchmarkEvent>(static_cast<int>(i));
+      Benchmarks::DoNotOptimize(system.dispatchQueue());
+    }
+    Benchmarks::DoNotOptimize(sum);
+    state.setItemsProcessed(state.getIterations() * batch);
+  }
+}
+
+BENCHMARK(BM_EventSystemEmit)->arg(1)->arg(8);
+BENCHMARK(BM_LegacyEventSystemEmit)->arg(1)->arg(8);
+BENCHMARK(BM_EventSystemQueueDispatch)->arg(64)->arg(1024);
+BENCHMARK(BM_LegacyEventSystemQueueDispatch)->arg(64)->arg(1024);
+BENCHMARK(BM_EventSystemOnOff)->arg(8);
+BENCHMARK(BM_LegacyEventSystemOnOff)->arg(8);
+BENCHMARK(BM_EventSystemPostDispatch)->arg(64)->arg(1024);
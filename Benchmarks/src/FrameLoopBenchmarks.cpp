@@ -0,0 +1,161 @@
+#include "Benchmark.h"
+#include "FrameLoop.h"
+#include "SceneWorkloads.h"
+
+#include <engine/core/Application.h>
+#include <engine/core/MemoryTracker.h>
+#include <engine/renderer/Camera.h>
+
+#include <algorithm>
+#include <string>
+
+using Benchmarks::State;
+
+namespace {
+  std::string ExecutablePath;
+
+  struct FrameSamples {
+    std::vector<float> frameTimes;
+    // heap allocations of each frame, a steady state frame should make none
+    std::vector<uint64_t> allocations;
+  };
+
+  // Renders the generated grid from a fixed camera and records every frame past the warmup
+  class FrameLoopLayer : public Engine::AppLayer {
+  public:
+    FrameLoopLayer(uint32_t entityCount, FrameSamples& samples)
+      : Engine::AppLayer("FrameLoopLayer"), entityCount(entityCount), samples(samples) {}
+
+    void onAttach() override {
+      auto& window = this->app.getWindow();
+      this->camera.setPerspective(45.f, .1f, 1000.f);
+      this->camera.setViewportSize(window.getWidth(), window.getHeight());
+      float extent = Benchmarks::PopulateGrid(
+        this->scene, this->entityCount, Engine::Renderer::Get()->createMesh("assets/models/test.obj")
+      );
+      // looks down on the whole grid at 45 degrees
+      glm::mat4 view = glm::lookAt(glm::vec3{ 0.f, extent, extent * 1.5f }, glm::vec3{ 0.f }, glm::vec3{ 0.f, 1.f, 0.f });
+      this->view = view;
+      this->inverseView = glm::inverse(view);
+
+      this->cbHandles.onUpdate = this->manager().getOnUpdateCallback().connect([this](Engine::DeltaTime dt) {
+        this->onUpdate(dt);
+        return true;
+      });
+      this->cbHandles.onBeginFrame = this->manager().getOnBeginFrameCallback().connect([this](Engine::FrameInfo& frameInfo) {
+        this->onBeginFrame(frameInfo);
+        return true;
+      });
+      this->cbHandles.onRender = this->manager().getOnRenderCallback().connect([this](Engine::FrameInfo& frameInfo) {
+        this->onRender(frameInfo);
+        return true;
+      });
+    }
+    void onDetach() override {
+      this->manager().getOnUpdateCallback().disconnect(this->cbHandles.onUpdate);
+      this->manager().getOnBeginFrameCallback().disconnect(this->cbHandles.onBeginFrame);
+      this->manager().getOnRenderCallback().disconnect(this->cbHandles.onRender);
+    }
+    void onUpdate(Engine::DeltaTime dt) override {
+      // the first update measures the time since run started, not a frame
+      if (this->updates++ > Benchmarks::FrameLoopWarmupFrames) {
+        this->samples.frameTimes.push_back(dt.asMilliseconds());
+        this->samples.allocations.push_back(Engine::MemoryTracker::GetLastFrame().allocations);
+      }
+    }
+    void onBeginFrame(Engine::FrameInfo& frameInfo) override {
+      const auto& projection = this->camera.getProjection();
+      frameInfo.uploadCameraParameters(this->view, projection, projection * this->view, this->inverseView);
+    }
+    void onRender(Engine::FrameInfo& frameInfo) override {
+      this->scene.render(this->camera, frameInfo);
+    }
+  private:
+    struct {
+      uint64_t onUpdate = -1;
+      uint64_t onBeginFrame = -1;
+      uint64_t onRender = -1;
+    } cbHandles;
+    uint32_t entityCount;
+    FrameSamples& samples;
+    uint32_t updates = 0;
+    Engine::Scene scene;
+    Engine::Camera camera;
+    glm::mat4 view{ 1.f };
+    glm::mat4 inverseView{ 1.f };
+  };
+
+  class FrameLoopApplication : public Engine::Application {
+  public:
+    FrameLoopApplication(const Engine::ApplicationInfo& info, uint32_t entityCount, FrameSamples& samples)
+      : Engine::Application(info), entityCount(entityCount), samples(samples) {}
+
+    bool init() override {
+      if (!this->Engine::Application::init())
+        return false;
+      this->pushLayer<FrameLoopLayer>(this->entityCount, this->samples);
+      return true;
+    }
+  private:
+    uint32_t entityCount;
+    FrameSamples& samples;
+  };
+
+  float Percentile(const std::vector<float>& sorted, float percentile) {
+    if (sorted.empty())
+      return 0.f;
+    size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + .5f);
+    return sorted[std::min(index, sorted.size() - 1)];
+  }
+
+  // Headless run of the generated grid, argument is the entity count.
+  // The iteration time covers the whole run, the frame time distribution is reported as counters.
+  void BM_HeadlessFrameLoop(State& state) {
+    std::string frames = std::to_string(Benchmarks::FrameLoopWarmupFrames + 1 + Benchmarks::FrameLoopMeasuredFrames);
+    char* args[] = { ExecutablePath.data(), const_cast<char*>("--headless"), const_cast<char*>("--frames"), frames.data() };
+    Engine::ApplicationInfo info{};
+    info.windowInfo.size = { 1280, 720 };
+    info.windowInfo.title = "Benchmarks";
+    info.args = { 4, args };
+
+    FrameSamples samples;
+    samples.frameTimes.reserve(Benchmarks::FrameLoopMeasuredFrames);
+    samples.allocations.reserve(Benchmarks::FrameLoopMeasuredFrames);
+    {
+      FrameLoopApplication app(info, static_cast<uint32_t>(state.arg()), samples);
+      if (!app.init()) {
+        LOG_APP_ERROR("BM_HeadlessFrameLoop: application failed to initialize");
+        for (auto _ : state) {}
+        return;
+      }
+      for (auto _ : state)
+        app.run();
+    }
+
+    auto& frameTimes = samples.frameTimes;
+    std::sort(frameTimes.begin(), frameTimes.end());
+    float total = 0.f;
+    for (float frameTime : frameTimes)
+      total += frameTime;
+    state.counters["frames"] = static_cast<double>(frameTimes.size());
+    state.counters["frame_ms_avg"] = frameTimes.empty() ? 0.0 : total / frameTimes.size();
+    state.counters["frame_ms_p50"] = Percentile(frameTimes, .5f);
+    state.counters["frame_ms_p95"] = Percentile(frameTimes, .95f);
+    state.counters["frame_ms_p99"] = Percentile(frameTimes, .99f);
+    state.counters["frame_ms_max"] = frameTimes.empty() ? 0.0 : frameTimes.back();
+    if (Engine::MemoryTracker::IsEnabled() && !samples.allocations.empty()) {
+      uint64_t allocations = 0;
+      for (uint64_t count : samples.allocations)
+        allocations += count;
+      state.counters["allocations_per_frame_avg"] = static_cast<double>(allocations) / samples.allocations.size();
+      state.counters["allocations_per_frame_max"] = static_cast<double>(*std::max_element(samples.allocations.begin(), samples.allocations.end()));
+    }
+    state.setItemsProcessed(static_cast<int64_t>(frameTimes.size()));
+  }
+}
+
+void Benchmarks::SetExecutablePath(std::string path) {
+  ExecutablePath = std::move(path);
+}
+
+BENCHMARK(BM_HeadlessFrameLoop)->arg(1024)->arg(16384)->iterations(1);
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include <engine/renderer/apis/Vulkan/HostAllocator.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using Benchmarks::State;
+using Engine::Renderers::Vulkan::HostAllocator;
+
+namespace {
+  // Odd sizes next to every alignment drivers ask for, blocks must stay apart whatever the previous size was
+  constexpr std::array<size_t, 8> CommandSizes = { 1, 13, 24, 7, 100, 3, 64, 250 };
+  constexpr std::array<size_t, 5> CommandAlignments = { 1, 4, 8, 16, 64 };
+
+  void* AllocateCommand(const VkAllocationCallbacks& callbacks, int64_t i) {
+    return callbacks.pfnAllocation(
+      callbacks.pUserData,
+      CommandSizes[i % CommandSizes.size()],
+      CommandAlignments[i % CommandAlignments.size()],
+      VK_SYSTEM_ALLOCATION_SCOPE_COMMAND
+    );
+  }
+
+  // Keeps count allocations alive at once, each filled with its own byte.
+  // A block or header written over a previous block shows up as a changed byte.
+  std::string CheckCommandAllocations(const VkAllocationCallbacks& callbacks, int64_t count) {
+    std::vector<std::byte*> blocks;
+    blocks.reserve(count);
+    std::string error;
+    for (int64_t i = 0; i < count && error.empty(); i++) {
+      auto* block = static_cast<std::byte*>(AllocateCommand(callbacks, i));
+      if (!block) {
+        error = "allocation " + std::to_string(i) + " failed";
+        break;
+      }
+      if (reinterpret_cast<uintptr_t>(block) % CommandAlignments[i % CommandAlignments.size()] != 0)
+        error = "allocation " + std::to_string(i) + " is misaligned";
+      std::memset(block, static_cast<int>(i & 0xff), CommandSizes[i % CommandSizes.size()]);
+      blocks.push_back(block);
+    }
+    for (size_t i = 0; i < blocks.size() && error.empty(); i++) {
+      for (size_t b = 0; b < CommandSizes[i % CommandSizes.size()]; b++) {
+        if (blocks[i][b] != static_cast<std::byte>(i & 0xff)) {
+          error = "allocation " + std::to_string(i) + " was overwritten";
+          break;
+        }
+      }
+    }
+    for (std::byte* block : blocks)
+      callbacks.pfnFree(callbacks.pUserData, block);
+    return error;
+  }
+
+  // Argument is the number of command scope allocations alive at once, like the driver building a large pipeline
+  void RunCommandAllocations(State& state, bool useCommandArena) {
+    HostAllocator allocator(useCommandArena);
+    const auto& callbacks = *allocator.getCallbacks();
+    const int64_t count = state.arg();
+    std::string error = CheckCommandAllocations(callbacks, count);
+    if (!error.empty())
+      state.skipWithError(error);
+
+    std::vector<void*> blocks(count);
+    for (auto _ : state) {
+      for (int64_t i = 0; i < count; i++)
+        blocks[i] = AllocateCommand(callbacks, i);
+      Benchmarks::ClobberMemory();
+      for (void* block : blocks)
+        callbacks.pfnFree(callbacks.pUserData, block);
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+  }
+  // 4096 allocations overflow the arena, the last ones fall back to the heap
+  void BM_HostCommandArena(State& state) {
+    RunCommandAllocations(state, true);
+  }
+  void BM_HostCommandHeap(State& state) {
+    RunCommandAllocations(state, false);
+  }
+}
+
+BENCHMARK(BM_HostCommandArena)->arg(64)->arg(4096);
+BENCHMARK(BM_HostCommandHeap)->arg(64)->arg(4096);
@@ -0,0 +1,65 @@
+#include "Benchmark.h"
+#include "SceneWorkloads.h"
+
+#include <engine/scene/Entity.h>
+
+using Benchmarks::State;
+
+namespace {
+  // Argument is the entity count created then destroyed per iteration
+  void BM_SceneCreateDestroy(State& state) {
+    Engine::Scene scene;
+    const int64_t count = state.arg();
+    std::vector<Engine::Entity> entities;
+    entities.reserve(count);
+    for (auto _ : state) {
+      for (int64_t i = 0; i < count; i++)
+        entities.push_back(scene.createEntity("Benchmark"));
+      for (auto& entity : entities)
+        scene.destroyEntity(entity);
+      entities.clear();
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+  }
+
+  // Iterates the Transform storage of a populated scene, the access pattern of Scene::render
+  void BM_SceneViewTransforms(State& state) {
+    Engine::Scene scene;
+    Benchmarks::PopulateGrid(scene, static_cast<uint32_t>(state.arg()));
+    for (auto _ : state) {
+      glm::vec3 sum{ 0.f };
+      for (auto [handle, transform] : scene.viewEntitiesWith<Engine::Components::Transform>().each())
+        sum += transform.translation;
+      Benchmarks::DoNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.getIterations() * state.arg());
+  }
+
+  // Argument is the transform count composed per iteration
+  void BM_TransformMatrix(State& state) {
+    auto transforms = Benchmarks::GenerateTransforms(static_cast<uint32_t>(state.arg()));
+    for (auto _ : state) {
+      for (auto& transform : transforms) {
+        glm::mat4 matrix = static_cast<glm::mat4>(transform);
+        Benchmarks::DoNotOptimize(matrix);
+      }
+    }
+    state.setItemsProcessed(state.getIterations() * state.arg());
+  }
+
+  void BM_TransformNormalMatrix(State& state) {
+    auto transforms = Benchmarks::GenerateTransforms(static_cast<uint32_t>(state.arg()));
+    for (auto _ : state) {
+      for (auto& transform : transforms) {
+        glm::mat3 matrix = transform.computeNormalMatrix();
+        Benchmarks::DoNotOptimize(matrix);
+      }
+    }
+    state.setItemsProcessed(state.getIterations() * state.arg());
+  }
+}
+
+BENCHMARK(BM_SceneCreateDestroy)->arg(1024)->arg(16384);
+BENCHMARK(BM_SceneViewTransforms)->arg(1024)->arg(16384);
+BENCHMARK(BM_TransformMatrix)->arg(1024);
+BENCHMARK(BM_TransformNormalMatrix)->arg(1024);
@@ -0,0 +1,48 @@
+#include "SceneWorkloads.h"
+
+#include <engine/scene/Entity.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+#include <random>
+
+namespace Benchmarks {
+  namespace {
+    constexpr float GridSpacing = 3.f;
+  }
+
+  std::vector<Engine::Components::Transform> GenerateTransforms(uint32_t count, uint32_t seed) {
+    std::mt19937 generator{ seed };
+    std::uniform_real_distribution<float> jitter{ -.5f, .5f };
+    std::uniform_real_distribution<float> angle{ 0.f, glm::two_pi<float>() };
+    std::uniform_real_distribution<float> scale{ .5f, 1.5f };
+
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+    const float offset = (side - 1) * GridSpacing * .5f;
+    std::vector<Engine::Components::Transform> transforms(count);
+    for (uint32_t i = 0; i < count; i++) {
+      auto& transform = transforms[i];
+      transform.translation = {
+        (i % side) * GridSpacing - offset + jitter(generator),
+        jitter(generator),
+        (i / side) * GridSpacing - offset + jitter(generator)
+      };
+      transform.rotation = { angle(generator), angle(generator), angle(generator) };
+      transform.scale = glm::vec3{ scale(generator) };
+    }
+    return transforms;
+  }
+
+  float PopulateGrid(Engine::Scene& scene, uint32_t count, Engine::Ref<Engine::Mesh> mesh, uint32_t seed) {
+    auto transforms = GenerateTransforms(count, seed);
+    for (auto& transform : transforms) {
+      auto entity = scene.createEntity("Benchmark");
+      entity.getComponent<Engine::Components::Transform>() = transform;
+      if (mesh)
+        entity.addComponent<Engine::Components::Mesh>(mesh);
+    }
+    const float side = std::ceil(std::sqrt(static_cast<float>(count)));
+    return side * GridSpacing * .5f;
+  }
+}
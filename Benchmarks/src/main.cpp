@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "FrameLoop.h"
+
+#include <engine/utils/logger.h>
+#include <engine/core/PoolManager.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <filesystem>
+#include <string_view>
+#include <thread>
+
+// Usage: Benchmarks [--filter <substring>] [--json <file>] [--min-time <seconds>] [--repetitions <count>] [--commit <id>]
+int main(int argc, char** argv) {
+  Engine::Logger::Init();
+  Engine::PoolManager::Init();
+  Benchmarks::SetExecutablePath(std::filesystem::absolute(argv[0]).string());
+
+  Benchmarks::RunOptions options{};
+  std::string_view jsonPath;
+  std::map<std::string, std::string> context;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Unknown or incomplete argument %s\n", argv[i]);
+      return 1;
+    }
+    if (arg == "--filter")
+      options.filter = argv[++i];
+    else if (arg == "--json")
+      jsonPath = argv[++i];
+    else if (arg == "--min-time")
+      options.minSeconds = std::strtod(argv[++i], nullptr);
+    else if (arg == "--repetitions")
+      options.repetitions = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    // recorded in the json context so results can be tracked per commit
+    else if (arg == "--commit")
+      context["commit"] = argv[++i];
+    else {
+      std::fprintf(stderr, "Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  char date[32]{};
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  context["date"] = date;
+  context["executable"] = argv[0];
+  context["num_cpus"] = std::to_string(std::thread::hardware_concurrency());
+#if defined(DEBUG)
+  context["build_type"] = "debug";
+#else
+  context["build_type"] = "release";
+#endif
+
+  auto results = Benchmarks::RunAll(options);
+  Benchmarks::PrintResults(results);
+  if (!jsonPath.empty() && !Benchmarks::WriteJson(jsonPath, results, context)) {
+    std::fprintf(stderr, "Failed to write %.*s\n", static_cast<int>(jsonPath.size()), jsonPath.data());
+    return 1;
+  }
+  // failed checks fail the run so scripts tracking the results notice them
+  for (auto& result : results) {
+    if (!result.error.empty())
+      return 1;
+  }
+  return 0;
+}
@@ -18,6 +18,7 @@ namespace Editor {
     virtual void onRender(Engine::FrameInfo& frameInfo) override;
     virtual void onBeginFrame(Engine::FrameInfo& frameInfo) override;
     virtual void onEndFrame(Engine::FrameInfo& frameInfo) override;
+    virtual void onImGuiRender() override;
   private:
     Profiler profiler;
     EditorCamera camera;
@@ -26,6 +27,7 @@ namespace Editor {
       uint64_t onRender{ static_cast<uint64_t>(-1) };
       uint64_t onBeginFrame{ static_cast<uint64_t>(-1) };
       uint64_t onEndFrame{ static_cast<uint64_t>(-1) };
+      uint64_t onImGuiRender{ static_cast<uint64_t>(-1) };
     } cbHandles;
   };
 }
\ No newline at end of file
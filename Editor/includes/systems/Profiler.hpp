@@ -1,16 +1,41 @@
 #pragma once
 
+#include <engine/core/Profiler.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
 namespace Editor {
+  // ImGui profiler panel: frame time graph and percentiles, CPU zones of the last frame, GPU scope
+  // timings, host memory per tag and pool usage.
+  // Toggled with P.
   class Profiler {
   public:
+    static constexpr size_t HistorySize = 240;
+    // zones copied from the main thread ring to find the last frame
+    static constexpr size_t MaxZones = 4096;
+
     Profiler() = default;
     Profiler(const Profiler&) = default;
     Profiler& operator=(const Profiler&) = default;
     virtual ~Profiler() = default;
 
     void update(float deltaTime);
+    void onImGuiRender();
   private:
-    bool enabled = false;
-    float lastOutput = 0.f;
+    void drawFrameTimes();
+    void drawCpuZones();
+    void drawGpuTimings();
+    void drawMemory();
+    void drawPools();
+
+    bool visible = true;
+    // milliseconds, circular
+    std::array<float, HistorySize> frameTimes{};
+    size_t frameTimeIndex = 0;
+    size_t frameTimeCount = 0;
+    std::vector<Engine::Profiler::Zone> zones;
+    std::vector<float> sortedFrameTimes;
   };
-}
\ No newline at end of file
+}
@@ -17,6 +17,7 @@ project "Editor"
     "%{Vendors.Engine.shared.include}",
     "%{Vendors.spdlog.shared.include}",
     "%{Vendors.glm.shared.include}",
+    "%{Vendors.ImGui.shared.include}",
     "%{Vendors.ImGuizmo.shared.include}",
     "%{Vendors.entt.shared.include}",
 	}
@@ -47,7 +48,7 @@ project "Editor"
 		runtime "Debug"
 		symbols "on"
 
-	filter "configurations:Release"
+	filter "configurations:Release or Profile"
 		defines "RELEASE"
 		runtime "Release"
 		optimize "on"
\ No newline at end of file
@@ -16,10 +16,15 @@ void MainLayer::onAttach() {
     this->onBeginFrame(frameInfo);
     return true;
   });
+  this->cbHandles.onImGuiRender = this->manager().getOnImGuiRenderCallback().connect([this]() {
+    this->onImGuiRender();
+    return true;
+  });
 }
 void MainLayer::onDetach() {
   this->manager().getOnUpdateCallback().disconnect(this->cbHandles.onUpdate);
   this->manager().getOnBeginFrameCallback().disconnect(this->cbHandles.onBeginFrame);
+  this->manager().getOnImGuiRenderCallback().disconnect(this->cbHandles.onImGuiRender);
 }
 void MainLayer::onUpdate(Engine::DeltaTime dt) {
   this->profiler.update(dt);
@@ -29,4 +34,7 @@ void MainLayer::onRender(Engine::FrameInfo& frameInfo) {}
 void MainLayer::onBeginFrame(Engine::FrameInfo& frameInfo) {
   this->camera.onRender(frameInfo);
 }
-void MainLayer::onEndFrame(Engine::FrameInfo& frameInfo) {}
\ No newline at end of file
+void MainLayer::onEndFrame(Engine::FrameInfo& frameInfo) {}
+void MainLayer::onImGuiRender() {
+  this->profiler.onImGuiRender();
+}
\ No newline at end of file
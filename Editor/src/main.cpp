@@ -25,6 +25,7 @@ namespace Engine {
     info.windowInfo.size = { 1280, 720 };
     info.windowInfo.title = "Editor";
     info.windowInfo.resizable = true;
+    info.imgui = true;
     info.args = args;
     return new Editor::App(info);
   }
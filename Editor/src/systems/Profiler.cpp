@@ -1,20 +1,197 @@
 #include "systems/Profiler.hpp"
 
 #include <engine/input/Input.h>
+#include <engine/renderer/RendererAPI.h>
+#include <engine/core/MemoryTracker.h>
+#include <engine/core/PoolManager.h>
 
-#include <engine/utils/logger.h>
+#include <imgui.h>
+
+#include <algorithm>
+#include <string_view>
 
 using Editor::Profiler;
-using namespace Engine;
 
 void Profiler::update(float deltaTime) {
-  if (Input::IsKeyDown(Input::Key::P))
-    this->enabled = !this->enabled;
-  if (!this->enabled)
+  if (Engine::Input::IsKeyDown(Engine::Input::Key::P))
+    this->visible = !this->visible;
+  this->frameTimes[this->frameTimeIndex] = deltaTime * 1000.f;
+  this->frameTimeIndex = (this->frameTimeIndex + 1) % HistorySize;
+  this->frameTimeCount = std::min(this->frameTimeCount + 1, HistorySize);
+}
+
+void Profiler::onImGuiRender() {
+  if (!this->visible)
+    return;
+  ImGui::SetNextWindowSize({ 480.f, 560.f }, ImGuiCond_FirstUseEver);
+  if (ImGui::Begin("Profiler", &this->visible)) {
+    this->drawFrameTimes();
+    if (ImGui::CollapsingHeader("CPU", ImGuiTreeNodeFlags_DefaultOpen))
+      this->drawCpuZones();
+    if (ImGui::CollapsingHeader("GPU", ImGuiTreeNodeFlags_DefaultOpen))
+      this->drawGpuTimings();
+    if (ImGui::CollapsingHeader("Memory", ImGuiTreeNodeFlags_DefaultOpen))
+      this->drawMemory();
+    if (ImGui::CollapsingHeader("Pools"))
+      this->drawPools();
+  }
+  ImGui::End();
+}
+
+void Profiler::drawFrameTimes() {
+  if (this->frameTimeCount == 0)
+    return;
+  auto& sorted = this->sortedFrameTimes;
+  sorted.clear();
+  for (size_t i = 0; i < this->frameTimeCount; i++)
+    sorted.push_back(this->frameTimes[i]);
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&sorted](float p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+  float total = 0.f;
+  for (float time : sorted)
+    total += time;
+  float average = total / sorted.size();
+
+  ImGui::Text("avg %.2fms (%.0f fps)", average, 1000.f / average);
+  ImGui::Text("p50 %.2fms  p95 %.2fms  p99 %.2fms  max %.2fms", percentile(.5f), percentile(.95f), percentile(.99f), sorted.back());
+  // oldest frame first
+  int offset = this->frameTimeCount < HistorySize ? 0 : static_cast<int>(this->frameTimeIndex);
+  ImGui::PlotHistogram(
+    "##frameTimes", this->frameTimes.data(), static_cast<int>(this->frameTimeCount), offset,
+    nullptr, 0.f, std::max(percentile(.99f) * 1.5f, 1.f), { ImGui::GetContentRegionAvail().x, 80.f }
+  );
+}
+
+void Profiler::drawCpuZones() {
+  Engine::Profiler::CopyThreadZones(this->zones, MaxZones);
+  // zones are stored as they complete, the last "Frame" is the previous frame
+  auto frame = std::find_if(this->zones.rbegin(), this->zones.rend(), [](const Engine::Profiler::Zone& zone) {
+    return std::string_view(zone.name) == "Frame";
+  });
+  if (frame == this->zones.rend()) {
+    ImGui::TextDisabled("No CPU zones recorded, build with ENABLE_PROFILING");
+    return;
+  }
+  const uint64_t frameBegin = frame->begin, frameEnd = frame->end;
+  const double tickPeriod = Engine::Profiler::GetTickPeriod();
+  std::erase_if(this->zones, [frameBegin, frameEnd](const Engine::Profiler::Zone& zone) {
+    return zone.begin < frameBegin || zone.end > frameEnd;
+  });
+  std::sort(this->zones.begin(), this->zones.end(), [](const auto& a, const auto& b) {
+    return a.begin < b.begin || (a.begin == b.begin && a.end > b.end);
+  });
+  ImGui::Text("Frame %.3fms", (frameEnd - frameBegin) * tickPeriod / 1e6);
+
+  const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+  const float width = ImGui::GetContentRegionAvail().x;
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const double scale = width / double(std::max<uint64_t>(frameEnd - frameBegin, 1));
+  auto* drawList = ImGui::GetWindowDrawList();
+  // end times of the enclosing zones give the depth
+  std::vector<uint64_t> stack;
+  uint32_t maxDepth = 0;
+  for (const auto& zone : this->zones) {
+    while (!stack.empty() && stack.back() <= zone.begin)
+      stack.pop_back();
+    uint32_t depth = static_cast<uint32_t>(stack.size());
+    stack.push_back(zone.end);
+    maxDepth = std::max(maxDepth, depth);
+
+    ImVec2 min{ origin.x + float((zone.begin - frameBegin) * scale), origin.y + depth * rowHeight };
+    ImVec2 max{ origin.x + float((zone.end - frameBegin) * scale), min.y + rowHeight - 1.f };
+    max.x = std::max(max.x, min.x + 1.f);
+    ImU32 color = ImGui::GetColorU32(ImVec4{ .25f + .1f * (depth % 4), .45f, .7f - .1f * (depth % 4), 1.f });
+    drawList->AddRectFilled(min, max, color);
+    drawList->PushClipRect(min, max, true);
+    drawList->AddText({ min.x + 2.f, min.y }, IM_COL32_WHITE, zone.name);
+    drawList->PopClipRect();
+    if (ImGui::IsMouseHoveringRect(min, max))
+      ImGui::SetTooltip("%s: %.3fms", zone.name, (zone.end - zone.begin) * tickPeriod / 1e6);
+  }
+  ImGui::Dummy({ width, (maxDepth + 1) * rowHeight });
+}
+
+void Profiler::drawGpuTimings() {
+  auto* renderer = Engine::Renderer::Get();
+  // toggled here so the pass timings can be compared
+  bool depthPrepass = renderer->isDepthPrepassEnabled();
+  if (ImGui::Checkbox("Depth prepass", &depthPrepass))
+    renderer->setDepthPrepass(depthPrepass);
+  auto& timings = renderer->getGpuTimings();
+  if (timings.scopes.empty()) {
+    ImGui::TextDisabled("No GPU timings available");
+    return;
+  }
+  if (!ImGui::BeginTable("##gpu", 2, ImGuiTableFlags_RowBg))
+    return;
+  for (auto& scope : timings.scopes) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Indent(scope.depth * ImGui::GetStyle().IndentSpacing + 1.f);
+    ImGui::TextUnformatted(scope.name.data(), scope.name.data() + scope.name.size());
+    ImGui::Unindent(scope.depth * ImGui::GetStyle().IndentSpacing + 1.f);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.3fms", scope.milliseconds);
+  }
+  ImGui::EndTable();
+}
+
+void Profiler::drawMemory() {
+  if (!Engine::MemoryTracker::IsEnabled()) {
+    ImGui::TextDisabled("Memory tracking disabled, build with ENABLE_MEMORY_TRACKING");
+    return;
+  }
+  const auto& frame = Engine::MemoryTracker::GetLastFrame();
+  ImGui::Text("%llu allocations, %.1fKB last frame", static_cast<unsigned long long>(frame.allocations), frame.allocatedBytes / 1024.f);
+  if (!ImGui::BeginTable("##memory", 5, ImGuiTableFlags_RowBg))
+    return;
+  ImGui::TableSetupColumn("Tag");
+  ImGui::TableSetupColumn("Live");
+  ImGui::TableSetupColumn("Peak");
+  ImGui::TableSetupColumn("Allocs/frame");
+  ImGui::TableSetupColumn("Rate");
+  ImGui::TableHeadersRow();
+  for (size_t i = 0; i < Engine::MemoryTracker::TagCount; i++) {
+    const auto& tag = frame.tags[i];
+    auto name = Engine::MemoryTracker::GetTagName(static_cast<Engine::MemoryTag>(i));
+    bool overBudget = tag.budget && tag.liveBytes > tag.budget;
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(name.data(), name.data() + name.size());
+    ImGui::TableNextColumn();
+    if (overBudget)
+      ImGui::TextColored({ 1.f, .35f, .35f, 1.f }, "%.2fMB", tag.liveBytes / (1024.f * 1024.f));
+    else
+      ImGui::Text("%.2fMB", tag.liveBytes / (1024.f * 1024.f));
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2fMB", tag.peakBytes / (1024.f * 1024.f));
+    ImGui::TableNextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(tag.allocations));
+    ImGui::TableNextColumn();
+    ImGui::Text("%.1fKB/s", tag.bytesPerSecond / 1024.0);
+  }
+  ImGui::EndTable();
+}
+
+void Profiler::drawPools() {
+  if (!ImGui::BeginTable("##pools", 4, ImGuiTableFlags_RowBg))
     return;
-  this->lastOutput -= deltaTime;
-  if (this->lastOutput <= 0.f) {
-    this->lastOutput = 1.f;
-    LOG_APP_INFO("Profiler: {0}ms, fps: {1}", deltaTime * 1000, 1.f / deltaTime);
+  ImGui::TableSetupColumn("Pool");
+  ImGui::TableSetupColumn("Used");
+  ImGui::TableSetupColumn("High water");
+  ImGui::TableSetupColumn("Capacity");
+  ImGui::TableHeadersRow();
+  for (auto it = Engine::PoolManager::Begin(); it != Engine::PoolManager::End(); ++it) {
+    auto name = it->getName();
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(name.data(), name.data() + name.size());
+    ImGui::TableNextColumn();
+    ImGui::Text("%llu (%.0f%%)", static_cast<unsigned long long>(it->getSize()), it->getUsage() * 100.f);
+    ImGui::TableNextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(it->getHighWaterMark()));
+    ImGui::TableNextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(it->getMaxSize()));
   }
-}
\ No newline at end of file
+  ImGui::EndTable();
+}
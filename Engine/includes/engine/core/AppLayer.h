@@ -20,6 +20,8 @@ namespace Engine {
     virtual void onRender(FrameInfo& frameInfo) {}
     virtual void onBeginFrame(FrameInfo& frameInfo) {}
     virtual void onEndFrame(FrameInfo& frameInfo) {}
+    // ImGui calls are only valid here
+    virtual void onImGuiRender() {}
 
     const std::string_view getName() const { return this->debugName; }
   protected:
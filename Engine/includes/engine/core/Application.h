@@ -5,11 +5,15 @@
 #include <engine/utils/asserts.h>
 #include <engine/utils/memory.h>
 #include <engine/events/EventSystem.h>
+#include <engine/core/FrameAllocator.h>
 #include <engine/renderer/RendererAPI.h>
 #include <engine/scene/Scene.h>
 #include "LayersManager.h"
+#include <engine/imgui/ImGuiLayer.h>
 #include "DeltaTime.h"
 
+#include <fstream>
+
 namespace Engine {
   struct ApplicationCmdArgs {
     uint32_t count = 1;
@@ -29,6 +33,8 @@ namespace Engine {
     std::string_view workingDirectory;
     ApplicationCmdArgs args;
     ApplicationVersion version{};
+    // Creates the ImGui overlay, ignored when headless
+    bool imgui = false;
   };
   class Application {
   public:
@@ -46,6 +52,8 @@ namespace Engine {
       return this->layersManager.pushLayer<T>(std::forward<Args>(args)...);
     }
     LayersManager& getLayersManager() { return this->layersManager; }
+    // null unless ApplicationInfo::imgui is set
+    ImGuiLayer* getImGuiLayer() { return this->imguiLayer.get(); }
 
     Window& getWindow() { return *this->platform.window; }
     Input::InputManager& getInputManager() { return *this->platform.input; }
@@ -54,6 +62,7 @@ namespace Engine {
   protected:
     ApplicationInfo spec;
     EventSystem eventSystem;
+    FrameAllocator frameAllocator;
     Platform platform;
     std::unique_ptr<Renderer> renderer;
     bool running = false;
@@ -61,11 +70,30 @@ namespace Engine {
 
   private:
     LayersManager layersManager;
+    Ref<ImGuiLayer> imguiLayer = nullptr;
+    std::vector<float> replayFrameTimes;
+    // stop after this many rendered frames, 0 runs until closed
+    uint64_t frameLimit = 0;
+    uint64_t frameCount = 0;
+    // every frame is written there when set
+    std::string captureDirectory;
+    // csv sink of the resolved GPU timings
+    std::ofstream gpuTimingsCsv;
+    uint64_t lastGpuTimingsFrame = UINT64_MAX;
+    // chrome trace of the CPU zones written on exit when set
+    std::string tracePath;
+
+    // Applies the command line options that must be known before the platform is created
+    static ApplicationInfo ParseEarlyArgs(const ApplicationInfo& info);
 
     void onUpdate(DeltaTime dt);
     void onRender(FrameInfo& frameInfo);
     void onBeginFrame(FrameInfo& frameInfo);
     void onEndFrame(FrameInfo& frameInfo);
+    // Logs the frame time distribution of the replayed session and stops the application
+    void onReplayFinished();
+    // Appends the GPU timings to the csv sink once per resolved frame
+    void writeGpuTimings();
   private:
     static Application* s_instance;
   };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <engine/utils/memory.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Engine {
+  // Linear allocator for transient per frame CPU data, owned by the Application and reset by its run loop.
+  // Allocations are a pointer bump and are never freed individually, they stay valid for FrameCount frames
+  // (so data read by the frames in flight can live there). Main thread only.
+  // A frame outgrowing its block gets overflow blocks, merged into one larger block on its next reset,
+  // so steady state frames never touch the heap.
+  class FrameAllocator {
+  public:
+    static constexpr uint32_t FrameCount = 3;
+    static constexpr size_t DefaultBlockSize = 1024 * 1024;
+
+    static FrameAllocator* Get() { return instance; }
+    FrameAllocator(size_t blockSize = DefaultBlockSize);
+    ~FrameAllocator();
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+      static_assert(std::is_trivially_destructible_v<T>, "Frame allocations are never destroyed");
+      return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    template <typename T>
+    T* allocateArray(size_t count) {
+      static_assert(std::is_trivially_destructible_v<T>, "Frame allocations are never destroyed");
+      return static_cast<T*>(this->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Moves to the buffer used FrameCount frames ago and resets it
+    void newFrame();
+
+    uint64_t getFrame() const { return this->frame; }
+    // bytes handed out in the current frame, padding included
+    size_t getUsedBytes() const { return this->buffers[this->current].used; }
+    // most bytes used by a single frame
+    size_t getPeakBytes() const { return this->peakBytes; }
+  private:
+    struct Block {
+      Scope<std::byte[]> data;
+      size_t size = 0;
+    };
+    struct Buffer {
+      std::vector<Block> blocks;
+      size_t block = 0;
+      size_t offset = 0;
+      size_t used = 0;
+    };
+    void reset(Buffer& buffer);
+
+    std::array<Buffer, FrameCount> buffers;
+    uint32_t current = 0;
+    uint64_t frame = 0;
+    size_t blockSize;
+    size_t peakBytes = 0;
+    static FrameAllocator* instance;
+  };
+
+  // STL allocator over a FrameAllocator, deallocate is a no-op.
+  // Containers using it must not outlive the frame, reserve up front since every reallocation leaks the old buffer
+  // until the reset.
+  template <typename T>
+  class FrameStlAllocator {
+  public:
+    using value_type = T;
+
+    FrameStlAllocator() : allocator(FrameAllocator::Get()) {}
+    FrameStlAllocator(FrameAllocator& allocator) : allocator(&allocator) {}
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other) : allocator(other.allocator) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(this->allocator->allocate(sizeof(T) * count, alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>& other) const { return this->allocator == other.allocator; }
+  private:
+    template <typename U>
+    friend class FrameStlAllocator;
+    FrameAllocator* allocator;
+  };
+
+  template <typename T>
+  using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
@@ -33,11 +33,13 @@ namespace Engine {
     Callback<FrameInfo&>& getOnRenderCallback() { return this->onRenderCallback; }
     Callback<FrameInfo&>& getOnBeginFrameCallback() { return this->onBeginFrameCallback; }
     Callback<FrameInfo&>& getOnEndFrameCallback() { return this->onEndFrameCallback; }
+    Callback<>& getOnImGuiRenderCallback() { return this->onImGuiRenderCallback; }
   private:
     void onUpdate(DeltaTime dt);
     void onRender(FrameInfo& frameInfo);
     void onBeginFrame(FrameInfo& frameInfo);
     void onEndFrame(FrameInfo& frameInfo);
+    void onImGuiRender();
     friend class Application;
     friend class AppLayer;
   private:
@@ -48,5 +50,6 @@ namespace Engine {
     Callback<FrameInfo&> onRenderCallback;
     Callback<FrameInfo&> onBeginFrameCallback;
     Callback<FrameInfo&> onEndFrameCallback;
+    Callback<> onImGuiRenderCallback;
   };
 }
\ No newline at end of file
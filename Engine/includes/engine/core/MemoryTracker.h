@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Engine {
+  // Subsystem an allocation is attributed to, set per thread with MEMORY_TAG
+  enum class MemoryTag : uint8_t {
+    Untagged,
+    Renderer,
+    Scene,
+    Events,
+    Assets,
+    Count
+  };
+
+  // Host heap tracker.
+  // When ENABLE_MEMORY_TRACKING is defined the global operator new/delete are replaced, every allocation carries a small
+  // header with its size and tag so frees are attributed to the tag that allocated. Counters are relaxed atomics per tag.
+  // NewFrame must be called once per frame from the main thread, it closes the frame and checks the budgets.
+  class MemoryTracker {
+  public:
+    static constexpr size_t TagCount = static_cast<size_t>(MemoryTag::Count);
+
+    struct TagStats {
+      uint64_t liveBytes = 0;
+      uint64_t peakBytes = 0;
+      uint64_t allocations = 0;
+      uint64_t allocatedBytes = 0;
+      // allocatedBytes over the frame duration
+      double bytesPerSecond = 0.0;
+      // 0 when unbounded
+      uint64_t budget = 0;
+    };
+    struct FrameStats {
+      uint64_t frame = 0;
+      float milliseconds = 0.f;
+      // totals over every tag, all threads
+      uint64_t allocations = 0;
+      uint64_t allocatedBytes = 0;
+      std::array<TagStats, TagCount> tags{};
+    };
+
+    static constexpr bool IsEnabled() {
+#ifdef ENABLE_MEMORY_TRACKING
+      return true;
+#else
+      return false;
+#endif
+    }
+    static std::string_view GetTagName(MemoryTag tag);
+    static MemoryTag GetThreadTag();
+    // Returns the previous tag of the calling thread
+    static MemoryTag SetThreadTag(MemoryTag tag);
+
+    static void NewFrame();
+    // Stats of the last closed frame
+    static const FrameStats& GetLastFrame();
+    // Allocations since the last NewFrame, on every thread
+    static uint64_t GetFrameAllocationCount();
+    static uint64_t GetLiveBytes(MemoryTag tag);
+    static uint64_t GetPeakBytes(MemoryTag tag);
+    // Logs a warning when the tag's live bytes exceed the budget at the end of a frame, 0 removes it
+    static void SetBudget(MemoryTag tag, uint64_t bytes);
+
+    // Hooks of the replaced operator new/delete
+    static void OnAllocate(MemoryTag tag, size_t size);
+    static void OnFree(MemoryTag tag, size_t size);
+  };
+
+  class MemoryTagScope {
+  public:
+    MemoryTagScope(MemoryTag tag) : previous(MemoryTracker::SetThreadTag(tag)) {}
+    ~MemoryTagScope() { MemoryTracker::SetThreadTag(this->previous); }
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+  private:
+    MemoryTag previous;
+  };
+}
+
+#ifdef ENABLE_MEMORY_TRACKING
+# define MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+# define MEMORY_TAG_CONCAT(a, b) MEMORY_TAG_CONCAT_IMPL(a, b)
+# define MEMORY_TAG(tag) ::Engine::MemoryTagScope MEMORY_TAG_CONCAT(memoryTag, __LINE__)(::Engine::MemoryTag::tag)
+#else
+# define MEMORY_TAG(tag)
+#endif
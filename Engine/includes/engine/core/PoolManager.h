@@ -1,76 +1,158 @@
 #pragma once
 
-#include <engine/utils/hash.h>
+#include <engine/utils/memory.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
 #include <string_view>
-#include <unordered_map>
 
 namespace Engine {
-  enum class Pools : uint64_t {
-    RendererVertices = Hash("RENDERER_VERTICES"),
-    RendererIndices = Hash("RENDERER_INDICES"),
+  // Indices into the PoolManager, configured by name from pool_sizes.yaml
+  enum class Pools : uint16_t {
+    RendererVertices,
+    RendererIndices,
+    RendererMeshes,
+    Count
   };
   class PoolManager {
   public:
+    static constexpr size_t PoolCount = static_cast<size_t>(Pools::Count);
+    // configuration names, in Pools order
+    static constexpr std::array<std::string_view, PoolCount> PoolNames = {
+      "RENDERER_VERTICES",
+      "RENDERER_INDICES",
+      "RENDERER_MESHES",
+    };
+
+    // Fixed capacity, used either as a counter (fill/empty, e.g. slots of a GPU buffer)
+    // or as a slab of fixed size objects (allocate/free, O(1) through an intrusive free list).
+    // The slab is created by the first allocation, which also sets the block size.
+    // With the thread cache enabled every thread keeps up to ThreadCacheSize free blocks and only locks the pool
+    // to exchange batches of them, otherwise each allocation takes the pool lock.
     class Pool {
     public:
-      Pool() = delete;
-#ifdef _DEBUG
-      Pool(std::string_view name, uint64_t size);
-#endif
-      Pool(uint16_t id, uint64_t size);
+      static constexpr uint32_t ThreadCacheSize = 32;
+
+      Pool() = default;
       ~Pool() = default;
 
       Pool(const Pool& other) = delete;
       Pool& operator=(const Pool& other) = delete;
-      Pool(Pool&& other) noexcept = default;
-      Pool& operator=(Pool&& other) noexcept = default;
 
       // will abort in debug mode if the pool is full
-      bool isEmpty() const { return this->used == 0; }
-      bool isFull() const { return this->used == this->size; }
+      bool isEmpty() const { return this->getSize() == 0; }
+      bool isFull() const { return this->getSize() == this->size; }
       bool fill(uint64_t amount = 1);
       bool empty(uint64_t amount = 1);
       bool operator+=(uint64_t amount) { return this->fill(amount); }
       bool operator-=(uint64_t amount) { return this->empty(amount); }
-      float getUsage() const { return static_cast<float>(this->used) / this->size; }
+      float getUsage() const { return this->size ? static_cast<float>(this->getSize()) / this->size : 0.f; }
+
+      // null when the pool is exhausted or blockSize does not match the slab
+      void* allocate(size_t blockSize, size_t alignment);
+      void free(void* block);
+      bool owns(const void* block) const;
+      template <typename T, typename... Args>
+      T* create(Args&&... args) {
+        void* block = this->allocate(sizeof(T), alignof(T));
+        return block ? new (block) T(std::forward<Args>(args)...) : nullptr;
+      }
+      template <typename T>
+      void destroy(T* object) {
+        if (!object)
+          return;
+        object->~T();
+        this->free(object);
+      }
 
-      uint64_t getSize() const { return this->used; }
+      uint64_t getSize() const { return this->used.load(std::memory_order_relaxed); }
       uint64_t getMaxSize() const { return this->size; }
-#ifdef _DEBUG
-      std::string_view getName() const { return this->name; }
-#endif
-      uint64_t getId() const { return this->id; }
+      uint64_t getHighWaterMark() const { return this->highWaterMark.load(std::memory_order_relaxed); }
+      size_t getBlockSize() const { return this->blockSize; }
+      std::string_view getName() const { return PoolNames[static_cast<size_t>(this->id)]; }
+      Pools getId() const { return this->id; }
     private:
       friend class PoolManager;
-#ifdef _DEBUG
-      std::string name;
-#endif
-      uint64_t id;
-      uint64_t size;
-      uint64_t used = 0;
+      friend struct PoolThreadCaches;
+      void configure(Pools id, uint64_t size, bool threadCache);
+      void addUsed(uint64_t amount);
+      bool createSlab(size_t blockSize, size_t alignment);
+      // shared free list, the lock must be held
+      void* popFree();
+      void pushFree(void* block);
+    private:
+      Pools id = Pools::Count;
+      uint64_t size = 0;
+      std::atomic<uint64_t> used{ 0 };
+      std::atomic<uint64_t> highWaterMark{ 0 };
+      bool threadCache = false;
+
+      Scope<std::byte[]> slab;
+      std::byte* blocks = nullptr;
+      size_t blockSize = 0;
+      void* freeList = nullptr;
+      mutable std::mutex mutex;
     };
-    using iterator = std::unordered_map<uint64_t, Pool>::iterator;
+    using iterator = std::array<Pool, PoolCount>::iterator;
     static bool Init();
     static iterator Begin() { return instance.pools.begin(); }
     static iterator End() { return instance.pools.end(); }
     static Pool* Get(Pools pool) {
-      auto it = instance.pools.find(static_cast<uint64_t>(pool));
-      if (it == instance.pools.end())
-        return nullptr;
-      return &it->second;
+      return static_cast<size_t>(pool) < PoolCount ? &instance.pools[static_cast<size_t>(pool)] : nullptr;
     }
     template<Pools P>
-    static constexpr Pool* Get() { return Get(P); }
-    static uint64_t Count() { return instance.pools.size(); }
+    static Pool* Get() {
+      static_assert(P < Pools::Count, "Invalid pool");
+      return &instance.pools[static_cast<size_t>(P)];
+    }
+    // Linear search over the names, for tools and configuration only
+    static Pool* Get(std::string_view name);
+    static uint64_t Count() { return PoolCount; }
   private:
     static constexpr std::string_view PoolConfigFilePath = "assets/configs/pool_sizes.yaml";
 
     PoolManager() = default;
     ~PoolManager() = default;
   private:
-    std::unordered_map<uint64_t, Pool> pools;
+    std::array<Pool, PoolCount> pools;
     bool initialized = false;
     static PoolManager instance;
   };
-}
\ No newline at end of file
+
+  // STL allocator handing single objects out of a Pool, e.g. for std::allocate_shared.
+  // Falls back to the heap when the pool is exhausted or sized for another type.
+  template <typename T>
+  class PoolAllocator {
+  public:
+    using value_type = T;
+
+    PoolAllocator(PoolManager::Pool& pool) : pool(&pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t count) {
+      if (count == 1) {
+        if (void* block = this->pool->allocate(sizeof(T), alignof(T)))
+          return static_cast<T*>(block);
+      }
+      return static_cast<T*>(::operator new(sizeof(T) * count, std::align_val_t{ alignof(T) }));
+    }
+    void deallocate(T* pointer, size_t count) {
+      if (this->pool->owns(pointer))
+        this->pool->free(pointer);
+      else
+        ::operator delete(pointer, std::align_val_t{ alignof(T) });
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return this->pool == other.pool; }
+  private:
+    template <typename U>
+    friend class PoolAllocator;
+    PoolManager::Pool* pool;
+  };
+}
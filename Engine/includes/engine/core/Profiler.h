@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define PROFILER_RDTSC
+#endif
+
+namespace Engine {
+  // CPU zone profiler.
+  // Every thread records completed zones into its own ring, written only by that thread, so recording takes no lock.
+  // The rings keep the last RingCapacity zones per thread and are exported as Chrome trace JSON (chrome://tracing, Perfetto).
+  // Zones are compiled out unless ENABLE_PROFILING is defined.
+  class Profiler {
+  public:
+    static constexpr size_t RingCapacity = 1 << 16;
+
+    struct Zone {
+      // string literals only, the pointer is kept
+      const char* name;
+      // ticks, see Now
+      uint64_t begin;
+      uint64_t end;
+    };
+
+    // Raw time stamp counter where available, it is about half the cost of steady_clock and converted at export
+    static uint64_t Now() {
+#ifdef PROFILER_RDTSC
+      return __rdtsc();
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    // Nanoseconds per Now tick, measured against steady_clock since the first zone
+    static double GetTickPeriod();
+    static void Record(const char* name, uint64_t begin, uint64_t end);
+    // Names the calling thread in exported traces, the name must be a string literal
+    static void SetThreadName(const char* name);
+    // Can be called while other threads keep recording, zones overwritten during the export are skipped
+    static bool ExportChromeTrace(std::string_view path);
+    // Copies the calling thread's last zones, at most maxCount, oldest completed first
+    static void CopyThreadZones(std::vector<Zone>& zones, size_t maxCount);
+  };
+
+  class ProfileZone {
+  public:
+    ProfileZone(const char* name) : name(name), begin(Profiler::Now()) {}
+    ~ProfileZone() { Profiler::Record(this->name, this->begin, Profiler::Now()); }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+  private:
+    const char* name;
+    uint64_t begin;
+  };
+}
+
+#ifdef ENABLE_PROFILING
+# define PROFILE_CONCAT_IMPL(a, b) a##b
+# define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+# define PROFILE_SCOPE(name) ::Engine::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+# define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+# define PROFILE_THREAD(name) ::Engine::Profiler::SetThreadName(name)
+#else
+# define PROFILE_SCOPE(name)
+# define PROFILE_FUNCTION()
+# define PROFILE_THREAD(name)
+#endif
@@ -34,6 +34,27 @@ namespace Engine {
     bool handled = false;
   };
 
+  // Process wide id per event type, used instead of RTTI to index channels and check listener types
+  class EventType {
+  public:
+    using ID = uint32_t;
+    static constexpr ID Invalid = ~ID{ 0 };
+
+    template <typename T>
+    static ID Of() {
+      static const ID id = Next();
+      return id;
+    }
+    // tag id of T's default tag, hashed once
+    template <typename T>
+    static EventTag::ID TagOf() {
+      static const EventTag::ID id = static_cast<EventTag::ID>(typename T::Tag{});
+      return id;
+    }
+  private:
+    static ID Next();
+  };
+
   template<typename OStream>
   inline OStream& operator<<(OStream& os, const Event& event)
   {
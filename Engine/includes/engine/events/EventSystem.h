@@ -3,125 +3,114 @@
 #include <string_view>
 #include "Event.h"
 
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <unordered_map>
-#include <any>
-#include <functional>
-#include <memory>
+#include <vector>
+#include <engine/utils/memory.h>
+#include <engine/core/MemoryTracker.h>
 #include <engine/utils/logger.h>
+#include <engine/utils/asserts.h>
 
 namespace Engine {
+  // Event bus with one channel per event tag.
+  // - listeners are type erased once at registration and kept sorted by priority, dispatch is a straight loop
+  // - queued events live in a linear arena reset after every dispatchQueue, no per event allocation
+  // - post can be called from any thread, events go through a bounded lock-free MPSC ring drained by dispatchQueue
+  // Everything but post must be called from the main thread.
   class EventSystem {
+  public:
+    // Bytes available to a single posted event
+    static constexpr size_t PostedEventSize = 128;
+    // Must be a power of two
+    static constexpr size_t PostedEventCapacity = 1024;
+    static constexpr size_t ArenaBlockSize = 64 * 1024;
   private:
-    using EventListenerCallback = std::function<bool(Event&)>;
+    struct ListenerCallback {
+      virtual ~ListenerCallback() = default;
+      virtual bool operator()(Event& event) = 0;
+    };
+    template <typename T, typename F>
+    struct TypedListenerCallback : ListenerCallback {
+      F callback;
+      TypedListenerCallback(F callback) : callback(std::move(callback)) {}
+      // the channel guarantees the event type, no dynamic_cast needed
+      bool operator()(Event& event) override { return this->callback(static_cast<T&>(event)); }
+    };
     struct EventListener {
-      EventListenerCallback listener;
+      Scope<ListenerCallback> callback;
       uint8_t priority = 0;
       uint32_t handle = 0;
+      // set when removed during a dispatch, erased once the channel is idle
+      bool removed = false;
+    };
 
-      bool operator>(const EventListener& other) const {
-        return this->priority < other.priority;
-      }
-      bool operator<(const EventListener& other) const {
-        return this->priority > other.priority;
-      }
+    struct Channel {
+      EventType::ID type = EventType::Invalid;
+      // highest priority first, registration order within a priority
+      std::vector<EventListener> listeners;
+      // listeners added while the channel is dispatching, merged once it returns
+      std::vector<EventListener> pendingListeners;
+      bool hasRemovedListeners = false;
+      uint32_t dispatchDepth = 0;
+      // indices of this channel's events in the queue, for queueUnique
+      std::vector<uint32_t> queued;
 
-      EventListener() = default;
-      EventListener(EventListenerCallback listener, uint8_t priority, uint32_t handle)
-        : listener(listener), priority(priority), handle(handle) {}
+      void insert(EventListener&& listener);
+      bool remove(uint32_t handle);
+      bool dispatch(Event& event);
     };
-    using Container = std::priority_queue<EventListener, std::vector<EventListener>, std::greater<EventListener>>;
-    class EventListenerQueue : public Container {
-    public:
-      bool operator()(Event& event) {
-        bool handled = false;
-        for (auto& listener : this->c) {
-          try {
-            handled |= listener.listener(event);
-            if (event.handled) {
-              break;
-            }
-          }
-          catch (const std::bad_cast& e) {
-            LOG_ERROR("Event listener threw an exception: {}", e.what());
-          }
-        }
-        return handled;
-      }
-      bool pop(uint64_t handle) {
-        auto it = std::find_if(this->c.begin(), this->c.end(), [handle](const EventListener& listener) {
-          return listener.handle == handle;
-        });
-        if (it != this->c.end()) {
-          this->c.erase(it);
-          return true;
-        }
-        return false;
-      }
-      bool empty() const {
-        return this->c.empty();
-      }
-    };
-    class EventQueue : public std::queue<std::unique_ptr<Event>> {
-    public:
-      bool empty() const {
-        return this->std::queue<std::unique_ptr<Event>>::empty();
-      }
-      template <typename T>
-      bool contains() {
-        auto tag = typename T::Tag{};
-        return this->contains(tag);
-      }
-      bool contains(EventTag tag) {
-        for (const auto& event : this->c) {
-          if (event->tag == tag)
-            return true;
-        }
-        return false;
-      }
 
-      bool remove(EventTag tag) {
-        for (auto it = this->c.begin(); it != this->c.end(); ++it) {
-          if ((*it)->tag == tag) {
-            this->c.erase(it);
-            return true;
-          }
-        }
-        return false;
-      }
-      template <typename T>
-      bool remove() {
-        auto tag = typename T::Tag{};
-        return this->remove(tag);
-      }
+    struct QueuedEvent {
+      Event* event = nullptr;
+      Channel* channel = nullptr;
+      void (*destroy)(Event*) = nullptr;
+    };
 
-      auto find(EventTag tag) {
-        return std::find_if(this->c.begin(), this->c.end(), [&tag](const std::unique_ptr<Event>& event) {
-          return event->tag == tag;
-        });
-      }
+    // Bump allocator backing queued events, blocks are kept across resets
+    class Arena {
+    public:
+      void* allocate(size_t size, size_t alignment);
+      void reset();
+    private:
+      struct Block {
+        Scope<std::byte[]> data;
+        size_t size = 0;
+      };
+      std::vector<Block> blocks;
+      size_t block = 0;
+      size_t offset = 0;
+    };
 
-      bool remove(std::deque<std::unique_ptr<Event>>::iterator it) {
-        if (it != this->c.end()) {
-          this->c.erase(it);
-          return true;
-        }
-        return false;
-      }
+    // Bounded MPSC ring (Vyukov), each slot holds one event constructed in place
+    struct PostedSlot {
+      std::atomic<size_t> sequence{ 0 };
+      bool (*dispatch)(EventSystem&, void*) = nullptr;
+      alignas(std::max_align_t) std::byte storage[PostedEventSize];
     };
   public:
     static EventSystem* Get() { return instance; }
     EventSystem();
     ~EventSystem();
+    EventSystem(const EventSystem&) = delete;
+    EventSystem& operator=(const EventSystem&) = delete;
 
   private:
     template <typename T, typename F>
     uint64_t _on(EventTag tag, F cb, uint8_t priority) {
+      MEMORY_TAG(Events);
+      auto* channel = this->getChannel<T>(static_cast<EventTag::ID>(tag));
+      if (!channel)
+        return ~uint64_t{ 0 };
       uint32_t handle = this->listenerId++;
-      this->listeners[static_cast<EventTag::ID>(tag)].emplace([cb](Event& raw) {
-        T& event = dynamic_cast<T&>(raw);
-        return cb(event);
-      }, priority, handle);
+      EventListener listener{ MakeScope<TypedListenerCallback<T, F>>(std::move(cb)), priority, handle };
+      if (channel->dispatchDepth)
+        channel->pendingListeners.push_back(std::move(listener));
+      else
+        channel->insert(std::move(listener));
       return handle;
     }
   public:
@@ -129,10 +118,10 @@ namespace Engine {
     template <typename T, typename F>
     uint64_t on(EventTag tag, F cb, uint8_t priority = 0) {
       if constexpr (std::is_same_v<std::invoke_result_t<F, T&>, bool>) {
-        return this->_on<T>(tag, cb, priority);
+        return this->_on<T>(tag, std::move(cb), priority);
       }
       else {
-        return this->_on<T>(tag, [cb](T& event) {
+        return this->_on<T>(tag, [cb = std::move(cb)](T& event) {
           cb(event);
           return false;
         }, priority);
@@ -141,18 +130,19 @@ namespace Engine {
     template <typename T, typename F>
     uint64_t on(F cb, uint8_t priority = 0) {
       auto tag = typename T::Tag{};
-      return this->on<T, F>(tag, cb, priority);
+      return this->on<T, F>(tag, std::move(cb), priority);
     }
     template <typename T, typename F>
     uint64_t on(std::string_view eventName, F cb, uint8_t priority = 0) {
       EventTag tag{ eventName };
-      return this->on<T, F>(tag, cb, priority);
+      return this->on<T, F>(tag, std::move(cb), priority);
     }
 
     bool off(EventTag tag, uint64_t handle) {
-      if (this->listeners.count(static_cast<EventTag::ID>(tag))) {
-        return this->listeners[static_cast<EventTag::ID>(tag)].pop(handle);
-      }
+      auto it = this->channels.find(static_cast<EventTag::ID>(tag));
+      if (it == this->channels.end())
+        return false;
+      return it->second->remove(static_cast<uint32_t>(handle));
     }
     template <typename T>
     bool off(uint64_t handle) {
@@ -162,10 +152,10 @@ namespace Engine {
 
     template <typename T>
     bool emit(T& event) {
-      if (this->listeners.count(static_cast<EventTag::ID>(event))) {
-        return this->listeners[static_cast<EventTag::ID>(event)](event);
-      }
-      return false;
+      auto* channel = this->findChannel<T>(event.tag.id);
+      if (!channel)
+        return false;
+      return channel->dispatch(event);
     }
     template <typename T, typename... Args>
     bool emit(Args&&... args) {
@@ -175,25 +165,120 @@ namespace Engine {
 
     template <typename T, typename... Args>
     bool queue(Args&&... args) {
-      this->eventQueue.push(std::make_unique<T>(std::forward<Args>(args)...));
+      MEMORY_TAG(Events);
+      void* memory = this->arena.allocate(sizeof(T), alignof(T));
+      T* event = new (memory) T(std::forward<Args>(args)...);
+      auto* channel = this->getChannel<T>(event->tag.id);
+      if (!channel) {
+        event->~T();
+        return false;
+      }
+      channel->queued.push_back(static_cast<uint32_t>(this->eventQueue.size()));
+      this->eventQueue.push_back({ event, channel, [](Event* e) { static_cast<T*>(e)->~T(); } });
       return true;
     }
 
     // Queue an event and remove any other events of the same type
     template <typename T, typename... Args>
     bool queueUnique(Args&&... args) {
-      auto tag = typename T::Tag{};
-      auto it = this->eventQueue.find(tag);
-      this->eventQueue.remove(it);
+      if (auto* channel = this->findChannel<T>(EventType::TagOf<T>())) {
+        for (uint32_t index : channel->queued) {
+          auto& queued = this->eventQueue[index];
+          if (queued.event) {
+            queued.destroy(queued.event);
+            queued.event = nullptr;
+          }
+        }
+        channel->queued.clear();
+      }
       return this->queue<T>(std::forward<Args>(args)...);
     }
 
+    // Thread safe, the event is dispatched by the next dispatchQueue on the main thread.
+    // Returns false if the ring is full.
+    template <typename T, typename... Args>
+    bool post(Args&&... args) {
+      static_assert(sizeof(T) <= PostedEventSize, "Event too large to be posted");
+      static_assert(alignof(T) <= alignof(std::max_align_t), "Event over aligned");
+      size_t position = this->postWritePosition.load(std::memory_order_relaxed);
+      PostedSlot* slot = nullptr;
+      for (;;) {
+        slot = &this->postedEvents[position & (PostedEventCapacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (diff == 0) {
+          if (this->postWritePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (diff < 0) {
+          LOG_WARN("EventSystem::post: queue full, event dropped");
+          return false;
+        }
+        else {
+          position = this->postWritePosition.load(std::memory_order_relaxed);
+        }
+      }
+      new (slot->storage) T(std::forward<Args>(args)...);
+      slot->dispatch = [](EventSystem& system, void* storage) {
+        T* event = std::launder(reinterpret_cast<T*>(storage));
+        bool handled = system.emit(*event);
+        event->~T();
+        return handled;
+      };
+      slot->sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
     uint32_t dispatchQueue();
   private:
-    std::unordered_map<EventTag::ID, EventListenerQueue> listeners;
-    EventQueue eventQueue;
+    // Typed channels are cached by static type id, named channels go through the tag map
+    template <typename T>
+    Channel* findChannel(EventTag::ID tagId) {
+      if (tagId == EventType::TagOf<T>()) {
+        EventType::ID type = EventType::Of<T>();
+        if (type < this->typedChannels.size() && this->typedChannels[type])
+          return this->typedChannels[type];
+      }
+      auto it = this->channels.find(tagId);
+      if (it == this->channels.end())
+        return nullptr;
+      ASSERT(it->second->type == EventType::Of<T>(), "EventSystem: event type does not match its channel");
+      return it->second.get();
+    }
+    template <typename T>
+    Channel* getChannel(EventTag::ID tagId) {
+      EventType::ID type = EventType::Of<T>();
+      bool typed = tagId == EventType::TagOf<T>();
+      if (typed && type < this->typedChannels.size() && this->typedChannels[type])
+        return this->typedChannels[type];
+      auto& channel = this->channels[tagId];
+      if (!channel) {
+        channel = MakeScope<Channel>();
+        channel->type = type;
+      }
+      else if (channel->type != type) {
+        LOG_ERROR("EventSystem: channel {} is already used by another event type", tagId);
+        return nullptr;
+      }
+      if (typed) {
+        if (type >= this->typedChannels.size())
+          this->typedChannels.resize(type + 1, nullptr);
+        this->typedChannels[type] = channel.get();
+      }
+      return channel.get();
+    }
+
+    uint32_t dispatchPosted();
+
+    std::unordered_map<EventTag::ID, Scope<Channel>> channels;
+    std::vector<Channel*> typedChannels;
+    std::vector<QueuedEvent> eventQueue;
+    Arena arena;
+    Scope<PostedSlot[]> postedEvents;
+    std::atomic<size_t> postWritePosition{ 0 };
+    size_t postReadPosition = 0;
     uint32_t listenerId = 0;
     static EventSystem* instance;
   };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <engine/core/AppLayer.h>
+
+namespace Engine {
+  // Owns the ImGui context and its GLFW platform backend, the renderer draws the UI at the end of the main render pass.
+  // UI is submitted from AppLayer::onImGuiRender, between begin and end which the application calls every rendered frame.
+  class ImGuiLayer : public AppLayer {
+  public:
+    ImGuiLayer() : AppLayer("ImGuiLayer") {}
+    ~ImGuiLayer() override = default;
+
+    void onAttach() override;
+    void onDetach() override;
+
+    void begin();
+    void end();
+    // false when headless or when the renderer could not set up its backend
+    bool isEnabled() const { return this->enabled; }
+  private:
+    bool enabled = false;
+  };
+}
@@ -4,6 +4,8 @@
 #include <glm/glm.hpp>
 #include <engine/events/Event.h>
 
+#include <span>
+
 namespace Engine {
   class Platform;
 }
@@ -42,6 +44,31 @@ namespace Engine::Input {
     glm::vec2 offset;
     MouseScrollEvent(const glm::vec2& offset) : Event(Tag{}), offset(offset) {}
   };
+  // Input as received from the platform, kept in arrival order for the current frame
+  struct RawInputEvent {
+    enum class Type : uint8_t {
+      Key,
+      MouseButton,
+      MouseMove,
+      MouseScroll
+    };
+    Type type = Type::Key;
+    bool pressed = false;
+    // key or mouse button
+    uint16_t code = 0;
+    // cursor position or scroll offset
+    glm::vec2 value{ 0.f };
+    // seconds, monotonic, see InputManager::GetTime
+    double timestamp = 0.0;
+  };
+  // Emitted once per frame, after the coalesced events, when the raw stream is enabled
+  struct RawInputBatchEvent : public Event {
+    struct Tag : public EventTag {
+      Tag() : EventTag("engine:input:onRawBatch") {}
+    };
+    std::span<const RawInputEvent> events;
+    RawInputBatchEvent(std::span<const RawInputEvent> events) : Event(Tag{}), events(events) {}
+  };
   bool IsKeyPressed(KeyCode key);
   bool IsKeyDown(KeyCode key);
   bool IsKeyUp(KeyCode key);
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "Input.h"
+#include "InputRecording.h"
 #include <engine/utils/asserts.h>
+#include <engine/utils/memory.h>
+#include <engine/core/DeltaTime.h>
 
 #include <array>
 #include <unordered_set>
+#include <vector>
 #include <functional>
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
@@ -133,7 +137,30 @@ namespace Engine::Input {
     float getScrollX() const {
       return this->mouse.scrollOffset.x;
     }
+    // Consumers needing every sample (drawing tools, recording) can opt in to a RawInputBatchEvent per frame
+    void setRawInputEnabled(bool enabled) { this->rawInputEnabled = enabled; }
+    bool isRawInputEnabled() const { return this->rawInputEnabled; }
+    // Raw events delivered by the last flush, valid until the next update
+    const std::vector<RawInputEvent>& getRawEvents() const { return this->rawEvents; }
+
+    // Starts a new frame, must be called before polling the platform
     void update();
+    // Applies the raw events of the frame and delivers them in one batch:
+    // key and button changes in order, a single move and a single scroll event with the accumulated deltas
+    void flush();
+    // Called once the frame's delta time is known: records it, or replaces it with the recorded one while replaying
+    void onFrame(DeltaTime& deltaTime);
+
+    // Records every raw event and frame delta time into a binary log
+    bool startRecording(const std::string_view path);
+    void stopRecording();
+    bool isRecording() const { return this->recorder != nullptr; }
+    // Feeds a recorded log back instead of the platform events, frame by frame
+    bool startReplay(const std::string_view path);
+    void stopReplay();
+    bool isReplaying() const { return this->replay != nullptr; }
+    // True on the frame after the last recorded one was consumed
+    bool isReplayFinished() const { return this->replay && this->replay->isFinished() && !this->replayFrameConsumed; }
   private:
     GLFWwindow* getWindowHandle();
     void handleKeyInput(uint16_t key, int action);
@@ -142,6 +169,9 @@ namespace Engine::Input {
     static void GlfwMouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
     static void GlfwCursorPosCallback(GLFWwindow* window, double x, double y);
     static void GlfwScrollCallback(GLFWwindow* window, double x, double y);
+    void pushRawEvent(RawInputEvent::Type type, uint16_t code, bool pressed, glm::vec2 value);
+    // Seconds since the first call, timestamps every raw event
+    static double GetTime();
     struct KeyState {
       bool pressed = false;
       bool wasPressed = false;
@@ -155,8 +185,18 @@ namespace Engine::Input {
     };
   private:
     Platform& platform;
-    KeyStateMap<KeyState, GLFW_KEY_LAST, KeyCode> keyboard{};
-    KeyStateMap<KeyState, GLFW_MOUSE_BUTTON_LAST, KeyCode> mouseButtons{};
+    // the LAST codes are valid keys and buttons
+    KeyStateMap<KeyState, GLFW_KEY_LAST + 1, KeyCode> keyboard{};
+    KeyStateMap<KeyState, GLFW_MOUSE_BUTTON_LAST + 1, KeyCode> mouseButtons{};
     MouseData mouse{};
+    std::vector<RawInputEvent> rawEvents;
+    size_t flushedRawEvents = 0;
+    Scope<InputRecorder> recorder;
+    // flushed events waiting for their frame's delta time, includes frames skipped while suspended
+    std::vector<RawInputEvent> recordedEvents;
+    Scope<InputReplay> replay;
+    float replayDeltaTime = 0.f;
+    bool replayFrameConsumed = false;
+    bool rawInputEnabled = false;
   };
 };
\ No newline at end of file
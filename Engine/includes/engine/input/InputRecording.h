@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Input.h"
+#include <engine/utils/MappedFile.h>
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Engine::Input {
+  // Layout of an input log:
+  // [InputLogHeader] then per frame [InputLogFrame][InputLogEvent * eventCount]
+  struct InputLogHeader {
+    static constexpr uint32_t Magic = 0x504E4947; // "GINP"
+    static constexpr uint16_t Version = 1;
+
+    uint32_t magic = Magic;
+    uint16_t version = Version;
+    uint16_t _pad0 = 0;
+    // patched when the recording is closed
+    uint32_t frameCount = 0;
+  };
+  struct InputLogFrame {
+    float deltaTime = 0.f;
+    uint32_t eventCount = 0;
+  };
+  struct InputLogEvent {
+    uint8_t type = 0;
+    uint8_t pressed = 0;
+    uint16_t code = 0;
+    float value[2] = {};
+    // seconds since the recording started
+    float timestamp = 0.f;
+  };
+  static_assert(sizeof(InputLogEvent) == 16);
+
+  class InputRecorder {
+  public:
+    InputRecorder() = default;
+    ~InputRecorder();
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    // startTime is the platform time the event timestamps are made relative to
+    bool open(const std::string_view path, double startTime);
+    void close();
+    bool isOpen() const { return this->file.is_open(); }
+
+    void writeFrame(float deltaTime, std::span<const RawInputEvent> events);
+    uint32_t getFrameCount() const { return this->frameCount; }
+  private:
+    std::ofstream file;
+    std::vector<InputLogEvent> buffer;
+    double startTime = 0.0;
+    uint32_t frameCount = 0;
+  };
+
+  class InputReplay {
+  public:
+    bool open(const std::string_view path, double startTime);
+    void close();
+    bool isOpen() const { return this->file.isOpen(); }
+    bool isFinished() const { return this->frame >= this->frameCount; }
+
+    // Appends the next frame's events to out, returns false once every frame was read
+    bool readFrame(float& deltaTime, std::vector<RawInputEvent>& out);
+    uint32_t getFrameCount() const { return this->frameCount; }
+    uint32_t getFrame() const { return this->frame; }
+  private:
+    MappedFile file;
+    size_t offset = 0;
+    double startTime = 0.0;
+    uint32_t frame = 0;
+    uint32_t frameCount = 0;
+  };
+}
\ No newline at end of file
@@ -20,6 +20,8 @@ namespace Engine {
     std::string_view title;
     bool vSync = false;
     bool resizable = true;
+    // No native window nor surface, the renderer draws to offscreen targets of the given size
+    bool headless = false;
   };
   struct WindowCloseEvent : public Event {
     struct Tag : public EventTag {
@@ -51,6 +53,7 @@ namespace Engine {
     const glm::uvec2& getSize() const { return this->size; }
     uint32_t getWidth() const { return this->size.x; }
     uint32_t getHeight() const { return this->size.y; }
+    bool isHeadless() const { return this->spec.headless; }
     bool shouldClose() const;
     void close();
     void pollEvents();
@@ -65,5 +68,7 @@ namespace Engine {
     glm::uvec2 size;
     const std::string_view title;
     void* handle = nullptr;
+    // headless windows have no native close flag
+    bool closeRequested = false;
   };
 }
\ No newline at end of file
@@ -45,6 +45,11 @@ namespace Engine {
 
     Projection getProjectionType() const { return this->projectionType; }
     void setProjectionType(Projection type) { this->projectionType = type; this->computeProjection(); }
+
+    const glm::mat4& getProjection() const { return this->projection; }
+    const glm::uvec2& getViewportSize() const { return this->viewportSize; }
+    // Size in pixels of one world unit seen at the given view distance (ignored by orthographic cameras)
+    float getPixelsPerUnit(float distance) const;
   private:
     void computeProjection();
     virtual void onProjectionUpdate() {}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Engine {
+  // GPU duration of a named scope, scopes are stored in the order they were opened
+  struct GpuTiming {
+    // names must be string literals or otherwise outlive the renderer
+    std::string_view name;
+    uint32_t depth = 0;
+    // index of the enclosing scope, -1 for the frame roots
+    int32_t parent = -1;
+    float milliseconds = 0.f;
+  };
+  struct GpuFrameTimings {
+    // frame the timings were recorded in, they are resolved a few frames later
+    uint64_t frame = 0;
+    std::vector<GpuTiming> scopes;
+  };
+}
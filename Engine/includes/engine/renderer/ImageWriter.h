@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Engine {
+  enum class ImageFileFormat : uint8_t {
+    Png,
+    // tightly packed RGBA8 rows, e.g. for ffmpeg -f rawvideo -pix_fmt rgba
+    Raw
+  };
+
+  // Minimal image file output for frame captures.
+  // PNGs are written with stored (uncompressed) deflate blocks, trading file size for a writer cheap enough to run every frame.
+  class ImageWriter {
+  public:
+    // Picks the format from the extension, .raw or png otherwise
+    static ImageFileFormat GetFormat(std::string_view path);
+    // pixels are RGBA8 rows of stride bytes
+    static bool Write(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride);
+    static bool WritePng(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride);
+    static bool WriteRaw(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride);
+  };
+}
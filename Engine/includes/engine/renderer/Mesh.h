@@ -0,0 +1,136 @@
+#pragma once
+
+#include <engine/utils/memory.h>
+#include <engine/utils/hash.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Engine {
+  class Camera;
+
+  // CPU side vertex used by the importers and the cooked .mesh format.
+  // Matches the layout of the object shader vertex so cooked data can be uploaded as is.
+  struct MeshVertex {
+    glm::vec3 position{ 0.f };
+    glm::vec3 color{ 1.f };
+    glm::vec3 normal{ 0.f };
+    glm::vec2 uv{ 0.f };
+
+    bool operator==(const MeshVertex& other) const = default;
+  };
+
+  enum class MeshVertexFormat : uint16_t {
+    Standard = 0, // MeshVertex, 44 bytes
+    Packed = 1 // PackedMeshVertex, 20 bytes
+  };
+
+  // Quantized vertex, dequantized in the vertex shader:
+  // - position: 16 bit unorm relative to the mesh bounds (w is padding)
+  // - normal: octahedral encoding, 16 bit snorm
+  // - uv: half floats, so tiling coordinates outside of [0, 1] survive
+  // - color: rgba8 unorm
+  struct PackedMeshVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+    uint8_t color[4];
+  };
+  static_assert(sizeof(PackedMeshVertex) == 20);
+
+  struct MeshBounds {
+    glm::vec3 min{ 0.f };
+    glm::vec3 max{ 0.f };
+
+    glm::vec3 getCenter() const { return (this->min + this->max) * .5f; }
+    glm::vec3 getExtent() const { return (this->max - this->min) * .5f; }
+    float getRadius() const { return glm::length(this->getExtent()); }
+  };
+
+  // Range of the index buffer drawn for a level of detail.
+  // All the levels of a mesh share the same vertices.
+  struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // max object space distance from the full mesh's vertices to this level, see MeshSimplifier::Simplify
+    float error = 0.f;
+    uint32_t _pad0 = 0;
+  };
+
+  struct MeshData {
+    std::string name;
+    std::vector<MeshVertex> vertices;
+    // every lod range, lod 0 first
+    std::vector<uint32_t> indices;
+    // empty until lods are generated, the whole index buffer is then lod 0
+    std::vector<MeshLod> lods;
+    MeshBounds bounds{};
+
+    void computeBounds();
+  };
+
+  // Layout of a cooked .mesh file:
+  // [MeshFileHeader][vertices, vertexStride * vertexCount][indices, uint32 * indexCount][MeshLod * lodCount]
+  // Every section is 16 bytes aligned so it can be consumed straight from a memory mapping.
+  struct MeshFileHeader {
+    static constexpr uint32_t Magic = 0x48534D47; // "GMSH"
+    static constexpr uint16_t Version = 3;
+
+    uint32_t magic = Magic;
+    uint16_t version = Version;
+    MeshVertexFormat vertexFormat = MeshVertexFormat::Standard;
+    uint32_t vertexStride = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t flags = 0;
+    MeshBounds bounds{};
+    uint64_t vertexDataOffset = 0;
+    uint64_t indexDataOffset = 0;
+    uint32_t lodCount = 0;
+    uint32_t _pad0 = 0;
+    uint64_t lodDataOffset = 0;
+  };
+
+  class Mesh {
+  public:
+    virtual ~Mesh() = default;
+
+    virtual std::string_view getPath() const = 0;
+    virtual uint32_t getVertexCount() const = 0;
+    virtual uint32_t getIndexCount() const = 0;
+    virtual const MeshBounds& getBounds() const = 0;
+    virtual MeshVertexFormat getVertexFormat() const = 0;
+    virtual uint32_t getLodCount() const = 0;
+    virtual const MeshLod& getLod(uint32_t lod) const = 0;
+
+    // Screen space error, in pixels, tolerated by default when picking a lod.
+    static constexpr float DefaultLodPixelError = 1.f;
+    // Picks the coarsest lod whose error, projected on screen at the instance's distance, stays under maxPixelError.
+    uint32_t selectLod(const glm::mat4& model, const glm::vec3& cameraPosition, const Camera& camera, float maxPixelError = DefaultLodPixelError) const;
+
+    // Accepts either a source model (.obj, .gltf, .glb) or a cooked .mesh file.
+    // Source models are cooked next to the source on first load and whenever the source is newer or was cooked with another format.
+    static Ref<Mesh> CreateFromFile(std::string_view path, MeshVertexFormat format = MeshVertexFormat::Standard);
+  protected:
+    Mesh() = default;
+  };
+}
+
+template <>
+struct std::hash<Engine::MeshVertex> {
+  size_t operator()(const Engine::MeshVertex& vertex) const {
+    size_t seed = 0;
+    Engine::HashCombine(
+      seed,
+      vertex.position.x, vertex.position.y, vertex.position.z,
+      vertex.color.x, vertex.color.y, vertex.color.z,
+      vertex.normal.x, vertex.normal.y, vertex.normal.z,
+      vertex.uv.x, vertex.uv.y
+    );
+    return seed;
+  }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <engine/utils/MappedFile.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Engine {
+  // View into a memory mapped cooked mesh. Only valid while the mapping is alive.
+  struct CookedMesh {
+    const MeshFileHeader* header = nullptr;
+    const void* vertices = nullptr;
+    const uint32_t* indices = nullptr;
+    // null when the file holds a single lod spanning every index
+    const MeshLod* lods = nullptr;
+  };
+
+  class MeshImporter {
+  public:
+    static constexpr std::string_view CookedExtension = ".mesh";
+
+    // Parses a source model and merges all of its shapes/primitives into a single indexed mesh.
+    static std::optional<MeshData> Import(const std::string_view path);
+    // Parses every model on its own worker thread.
+    static std::vector<std::optional<MeshData>> ImportAll(const std::vector<std::string>& paths);
+
+    static bool WriteCooked(const MeshData& mesh, const std::string_view path, MeshVertexFormat format = MeshVertexFormat::Standard);
+    static bool ReadCooked(const MappedFile& file, CookedMesh& out);
+
+    static bool IsCooked(const std::string_view path);
+    static std::string GetCookedPath(const std::string_view path);
+    // Returns the path of an up to date cooked file for the given source, cooking it if required.
+    // Cooked files are used as is, whatever their vertex format.
+    // Returns an empty string on failure.
+    static std::string Cook(const std::string_view path, MeshVertexFormat format = MeshVertexFormat::Standard);
+    // Cooks every stale source on its own worker thread.
+    static std::vector<std::string> CookAll(const std::vector<std::string>& paths, MeshVertexFormat format = MeshVertexFormat::Standard);
+
+    static std::vector<PackedMeshVertex> PackVertices(const MeshData& mesh);
+  private:
+    static std::optional<MeshData> ImportObj(const std::string_view path);
+    static std::optional<MeshData> ImportGltf(const std::string_view path);
+
+    // Collapses a flat triangle list into unique vertices + indices
+    static void BuildIndexed(const std::vector<MeshVertex>& corners, MeshData& out);
+  };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+  struct VertexCacheStatistics {
+    uint32_t misses = 0;
+    // average cache miss ratio, transformed vertices per triangle (0.5 is ideal, 3 is the worst)
+    float acmr = 0.f;
+    // average transform to vertex ratio, transformed vertices per referenced vertex (1 is ideal)
+    float atvr = 0.f;
+  };
+
+  // Index/vertex reordering passes run by the mesh cooker.
+  // None of them change the rendered result, only the order in which the GPU consumes the data.
+  class MeshOptimizer {
+  public:
+    // Size of the simulated post-transform cache used by the optimizer.
+    static constexpr uint32_t CacheSize = 32;
+    // FIFO size used to report statistics, close to what current hardware effectively reuses.
+    static constexpr uint32_t AnalyzeCacheSize = 16;
+    // Max ACMR degradation allowed by the overdraw pass when splitting clusters.
+    static constexpr float OverdrawThreshold = 1.05f;
+
+    // Runs every pass in order and logs the vertex cache statistics before and after.
+    static void Optimize(MeshData& mesh);
+
+    // Tom Forsyth's linear-speed vertex cache optimization.
+    static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+    // Reorders clusters of a cache optimized index buffer so outward facing clusters are drawn first.
+    static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices, float threshold = OverdrawThreshold);
+    // Reorders vertices in order of first use and drops unreferenced ones, remapping the indices.
+    static void OptimizeVertexFetch(MeshData& mesh);
+
+    static VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = AnalyzeCacheSize);
+  };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+  // Quadric error metric edge collapse simplification (Garland & Heckbert).
+  // Vertices are only ever collapsed onto one of their neighbours, so every lod keeps indexing the original vertex buffer.
+  // Open borders and attribute seams are locked to avoid cracks and texture swimming.
+  class MeshSimplifier {
+  public:
+    static constexpr uint32_t MaxLods = 4;
+    // A lod is only kept if it drops at least this ratio of the previous lod's triangles
+    static constexpr float MinLodReduction = .1f;
+    // Collapses are refused past this error, relative to the mesh bounding radius
+    static constexpr float MaxRelativeError = .1f;
+
+    // Returns a simplified copy of the index buffer with at most targetIndexCount indices if the error budget allows it.
+    // targetError bounds the root mean square distance of a collapsed vertex to the planes it merged.
+    // resultError is the max distance from the original vertices to the simplified surface, measured on the result.
+    // Both are object space distances.
+    static std::vector<uint32_t> Simplify(
+      const std::vector<MeshVertex>& vertices,
+      const uint32_t* indices, size_t indexCount,
+      size_t targetIndexCount, float targetError,
+      float* resultError = nullptr
+    );
+
+    // Appends up to MaxLods - 1 simplified levels, each halving the triangle count, after the full mesh.
+    static void GenerateLods(MeshData& mesh);
+  };
+}
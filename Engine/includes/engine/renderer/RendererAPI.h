@@ -5,10 +5,15 @@
 
 #include "FrameInfo.h"
 #include "Texture.h"
+#include "Mesh.h"
+#include "GpuTimings.h"
 
 #include <engine/platform/Platform.h>
 #include <engine/renderer/Camera.h>
 #include <engine/scene/components/Transform.h>
+#include <engine/scene/components/Lights.h>
+#include <engine/scene/components/Billboard.h>
+#include <engine/scene/components/ParticleEmitter.h>
 
 namespace Engine {
   struct ApplicationInfo;
@@ -54,6 +59,36 @@ namespace Engine {
     virtual Ref<Texture2D> createTexture2D(const TextureSpecification& spec) = 0;
     virtual Ref<Texture2D> createTexture2D(const std::string_view& path) = 0;
 
+    virtual Ref<Mesh> createMesh(const std::string_view& path, MeshVertexFormat format = MeshVertexFormat::Standard) = 0;
+    // Must be called between beginFrame and endFrame.
+    // Static meshes never move, their shadows are cached in the far cascades of the global light
+    virtual void drawMesh(const Mesh& mesh, const glm::mat4& model, uint32_t lod = 0, bool isStatic = false) = 0;
+    // Camera facing quad centered on position, size in world units. Must be called between beginFrame and endFrame.
+    // Billboards are blended over the opaque meshes, all of them in a single draw
+    virtual void drawBillboard(const glm::vec3& position, const Components::Billboard& billboard) = 0;
+    // Spawns count particles of emitter around position, they are simulated and drawn on the GPU until they expire.
+    // Must be called between beginFrame and endFrame
+    virtual void emitParticles(const glm::vec3& position, const Components::ParticleEmitter& emitter, uint32_t count) = 0;
+    // Lights of the frame, in world space. Must be called between beginFrame and endFrame.
+    // Without any light, meshes are drawn unlit with their vertex colors
+    virtual void addPointLight(const glm::vec3& position, const Components::PointLight& light) = 0;
+    // A single global light is used, the last one set during the frame. direction is the direction light travels in
+    virtual void setGlobalLight(const glm::vec3& direction, const Components::GlobalLight& light) = 0;
+    // Writes the frame being rendered to path (.png or .raw) in the background, a few frames later.
+    // Must be called between beginFrame and endFrame
+    virtual void captureFrame(const std::string_view& path) = 0;
+    // Latest resolved GPU scope timings, a few frames behind the current one
+    virtual const GpuFrameTimings& getGpuTimings() const = 0;
+    // Draws opaque meshes to depth first, the color pass then only shades the visible fragments.
+    // Pays off in scenes with a lot of overdraw, read when the frame ends
+    void setDepthPrepass(bool enabled) { this->depthPrepass = enabled; }
+    bool isDepthPrepassEnabled() const { return this->depthPrepass; }
+
+    // ImGui backend, the UI is drawn at the end of the main render pass. See ImGuiLayer
+    virtual bool initImGui() = 0;
+    virtual void shutdownImGui() = 0;
+    virtual void beginImGuiFrame() = 0;
+
     static Ref<spdlog::logger>& GetLogger() { return Logger; }
     static Scope<Renderer> Create(ApplicationInfo& appInfo, Platform& platform, API api = DEFAULT_API);
     static API GetAPI() { return instance->api; }
@@ -63,6 +98,7 @@ namespace Engine {
     ApplicationInfo& appInfo;
     Platform& platform;
     API api;
+    bool depthPrepass = false;
     static Renderer* instance;
   };
 }
\ No newline at end of file
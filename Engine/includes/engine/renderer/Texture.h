@@ -2,6 +2,7 @@
 
 #include <engine/utils/glm.h>
 #include <engine/utils/memory.h>
+#include <engine/utils/hash.h>
 
 #include <string>
 #include <string_view>
@@ -61,6 +62,8 @@ namespace Engine {
     MipmapMode mipmapMode = MipmapMode::Linear;
     BorderColor borderColor = BorderColor::IntOpaqueBlack;
     bool unnormalizedCoordinates = false;
+
+    bool operator==(const TextureSamplerSpecification& other) const = default;
   };
 
   struct TextureSpecification : Size2D<uint32_t> {
@@ -102,4 +105,22 @@ namespace Engine {
     static Ref<Texture2D> CreateFromFile(std::string_view path);
     static Ref<Texture2D> Create(const TextureSpecification& spec);
   };
-}
\ No newline at end of file
+}
+
+template <>
+struct std::hash<Engine::TextureSamplerSpecification> {
+  size_t operator()(const Engine::TextureSamplerSpecification& spec) const {
+    size_t seed = 0;
+    Engine::HashCombine(
+      seed,
+      spec.minFilter, spec.magFilter,
+      spec.wrap.s, spec.wrap.t, spec.wrap.r,
+      spec.anisotropy, spec.maxAnisotropy,
+      spec.compareEnable, spec.compareOp,
+      spec.minLod, spec.maxLod,
+      spec.mipmapMode, spec.borderColor,
+      spec.unnormalizedCoordinates
+    );
+    return seed;
+  }
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+#include "Descriptors.h"
+#include "shaders/Billboard.h"
+
+#include <engine/scene/components/Billboard.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+
+  // Batches every billboard of the frame into one instance stream drawn with a single call.
+  // Instances are sorted back to front on the CPU so blending is correct without depth writes, then streamed through
+  // the renderer's GpuFrameAllocator. Each frame in flight has its own instance set, rewritten once the frame's fence
+  // has been waited, so the descriptor range matches the frame's instance count.
+  class BillboardRenderer {
+  public:
+    using Instance = Shaders::Billboard::Instance;
+
+    BillboardRenderer(Renderer& ctx, VkRenderPass renderPass, VkDescriptorSetLayout globalDescriptorSetLayout);
+    ~BillboardRenderer();
+    BillboardRenderer(const BillboardRenderer&) = delete;
+    BillboardRenderer& operator=(const BillboardRenderer&) = delete;
+
+    void beginFrame();
+    void add(const glm::vec3& position, const Components::Billboard& billboard);
+    // Sorts and uploads the frame's instances, after the camera
+    void upload(uint32_t frameIndex, const glm::mat4& view);
+    // Records the draw inside the main pass
+    void record(VkFrameInfo& frameInfo);
+    // Draws instances written on the GPU, instanceSet uses getInstanceSetLayout and args holds a VkDrawIndirectCommand
+    void recordIndirect(VkFrameInfo& frameInfo, VkDescriptorSet instanceSet, VkBuffer args, VkDeviceSize argsOffset);
+
+    // Layout of the instance set, a single storage buffer of Instance
+    DescriptorSetLayout& getInstanceSetLayout() const { return *this->instanceSetLayout; }
+    uint32_t getInstanceCount() const { return static_cast<uint32_t>(this->instances.size()); }
+  private:
+    Renderer& ctx;
+    Scope<DescriptorPool> descriptorPool = nullptr;
+    Scope<DescriptorSetLayout> instanceSetLayout = nullptr;
+    std::vector<VkDescriptorSet> frameSets;
+    Scope<Shaders::Billboard> shader = nullptr;
+
+    std::vector<Instance> instances;
+    // scratch storage for sorting
+    std::vector<float> depths;
+    std::vector<uint32_t> order;
+    uint32_t frameIndex = 0;
+    bool uploaded = false;
+  };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "Image.h"
+#include "Descriptors.h"
+#include "RenderGraph.h"
+
+#include <engine/renderer/FrameInfo.h>
+#include <engine/renderer/Mesh.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+
+  // Cascaded shadow maps of the global light.
+  // The camera frustum, up to MaxShadowDistance, is split in CascadeCount slices with a blend of logarithmic and
+  // uniform splits. Each cascade is an orthographic light projection around the bounding sphere of its slice, so its
+  // size does not change when the camera rotates, and its center is snapped to whole texels so edges don't shimmer.
+  // Near cascades follow the camera and are rendered every frame with every caster. Cascades from FirstCachedCascade
+  // only hold the static casters and are kept across frames: their center is snapped to a coarse grid, covered by a
+  // margin around the slice, and they are only rendered again when the light, the static set or that placement changes.
+  class CascadedShadows {
+  public:
+    static constexpr uint32_t CascadeCount = 4;
+    static constexpr uint32_t FirstCachedCascade = 2;
+    static constexpr uint32_t Resolution = 2048;
+    static constexpr VkFormat Format = VK_FORMAT_D32_SFLOAT;
+    // shadows end there, or at the camera's far plane when it is closer
+    static constexpr float MaxShadowDistance = 150.f;
+    // 0 is uniform, 1 is logarithmic
+    static constexpr float SplitLambda = .8f;
+    // casters that far behind a cascade toward the light are still rendered
+    static constexpr float CasterDistance = 100.f;
+    // fraction of a cached cascade's radius the camera can move before it is placed again
+    static constexpr float CachedMargin = .25f;
+
+    // std140, see builtin.object.glsl.frag
+    struct ShadowUbo {
+      // view space to shadow map uv and depth
+      glm::mat4 cascadeMatrices[CascadeCount]{};
+      // far view depth of each cascade
+      glm::vec4 splitDepths{ 0.f };
+      // world size of a shadow map texel, for the normal offset
+      glm::vec4 texelSizes{ 0.f };
+      // 0 when the frame has no shadows
+      uint32_t cascadeCount = 0;
+      float inverseResolution = 1.f / Resolution;
+      float _pad0[2]{};
+    };
+    struct Cascade {
+      glm::mat4 viewProjection{ 1.f };
+      // world size of the box, for caster culling
+      float halfExtent = 0.f;
+      float depthRange = 0.f;
+      // only static casters are rendered in cached cascades
+      bool cached = false;
+      // rendered this frame
+      bool render = false;
+      // global uniforms of the cascade, the depth shaders read the light's matrices from them
+      uint32_t uniformOffset = 0;
+
+      // Sphere against the cascade's box, world space
+      bool intersects(const glm::vec3& center, float radius) const;
+    };
+    // Shadow maps sampled by the main pass, invalid when the frame has no shadows
+    struct GraphImages {
+      std::array<RenderGraph::ImageHandle, CascadeCount> cascades{};
+    };
+    using RecordCallback = std::function<void(RenderGraph::PassContext&, const Cascade&)>;
+
+    CascadedShadows(Renderer& ctx);
+    ~CascadedShadows();
+    CascadedShadows(const CascadedShadows&) = delete;
+    CascadedShadows& operator=(const CascadedShadows&) = delete;
+
+    void beginFrame();
+    // world space direction the light travels in
+    void setLight(const glm::vec3& direction);
+    // Static casters are resubmitted every frame, a change of the set invalidates the cached cascades
+    void addStaticCaster(const Engine::Mesh& mesh, const glm::mat4& model);
+    // Fits the cascades to the camera and uploads their uniforms, after the camera
+    void update(const GlobalUbo& globalUbo);
+    // Adds a depth pass per cascade rendered this frame, record draws its casters
+    GraphImages addPasses(RenderGraph& graph, RecordCallback record);
+
+    // Set of the object shaders, bound with getDynamicOffset
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return *this->descriptorSetLayout; }
+    VkDescriptorSet getDescriptorSet() const { return this->descriptorSet; }
+    uint32_t getDynamicOffset() const { return this->dynamicOffset; }
+  private:
+    void createImages();
+    void createDescriptors();
+    // false when the camera's range leaves nothing to shadow
+    bool fitCascades(const GlobalUbo& globalUbo, ShadowUbo& ubo);
+  private:
+    Renderer& ctx;
+    std::vector<Image> images;
+    VkSampler sampler = VK_NULL_HANDLE;
+    Scope<DescriptorPool> descriptorPool = nullptr;
+    Scope<DescriptorSetLayout> descriptorSetLayout = nullptr;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    uint32_t dynamicOffset = 0;
+
+    std::array<Cascade, CascadeCount> cascades{};
+    // cached cascades hold valid static casters for their current viewProjection
+    std::array<bool, CascadeCount> cacheValid{};
+    bool hasLight = false;
+    // the frame has shadows
+    bool active = false;
+    glm::vec3 lightDirection{ 0.f };
+    // order independent hash of the frame's static casters, and of the ones the caches were rendered with
+    size_t staticHash = 0;
+    uint32_t staticCount = 0;
+    size_t cachedStaticHash = 0;
+    uint32_t cachedStaticCount = 0;
+  };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+#include "MemBuffer.h"
+#include "Descriptors.h"
+#include "RenderGraph.h"
+
+#include <engine/renderer/FrameInfo.h>
+#include <engine/scene/components/Lights.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  class GpuFrameAllocator;
+  namespace Shaders {
+    class LightCulling;
+  }
+
+  // Clustered forward lighting.
+  // The view frustum is split in a grid of froxels, screen tiles by exponential depth slices. Every frame a compute
+  // pass bins the point lights into the froxels they touch, and the object fragment shader only iterates the lights
+  // of its froxel, so the shading cost depends on the local light density instead of the scene's light count.
+  // Lights are streamed through the renderer's GpuFrameAllocator in view space, the froxel lists live in device local
+  // buffers written by the culling pass and read by the main pass.
+  class ClusteredLighting {
+  public:
+    static constexpr uint32_t GridSizeX = 16;
+    static constexpr uint32_t GridSizeY = 9;
+    static constexpr uint32_t GridSizeZ = 24;
+    static constexpr uint32_t ClusterCount = GridSizeX * GridSizeY * GridSizeZ;
+    // lights past this count are dropped, each froxel keeps the first MaxLightsPerCluster lights touching it
+    static constexpr uint32_t MaxPointLights = 4096;
+    static constexpr uint32_t MaxLightsPerCluster = 128;
+    // light color of unlit scenes, and ambient term of lit ones
+    static constexpr float AmbientIntensity = .1f;
+
+    // std430, see builtin.lightculling.glsl.comp
+    struct GpuPointLight {
+      // view space position, range in w
+      glm::vec4 positionRange;
+      // rgb, intensity in w
+      glm::vec4 color;
+    };
+    // std140
+    struct ClusterUbo {
+      glm::mat4 inverseProjection{ 1.f };
+      // view space direction the light travels in, w is 1 when the frame has a global light
+      glm::vec4 globalLightDirection{ 0.f };
+      glm::vec4 globalLightColor{ 0.f };
+      // rgb
+      glm::vec4 ambient{ 1.f };
+      // x, y, z froxel counts, point light count in w
+      glm::uvec4 gridSize{ GridSizeX, GridSizeY, GridSizeZ, 0 };
+      // pixel size of a screen tile
+      glm::vec2 tileSize{ 1.f };
+      // slice = log(viewDepth) * sliceScale + sliceBias
+      float sliceScale = 0.f;
+      float sliceBias = 0.f;
+      glm::vec2 screenSize{ 1.f };
+      float nearClip = .01f;
+      float farClip = 1000.f;
+    };
+    // Froxel lists written by the culling pass
+    struct GraphBuffers {
+      RenderGraph::BufferHandle lightCounts;
+      RenderGraph::BufferHandle lightIndices;
+    };
+
+    ClusteredLighting(Renderer& ctx);
+    ~ClusteredLighting();
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    void beginFrame();
+    void addPointLight(const glm::vec3& position, const Components::PointLight& light);
+    void setGlobalLight(const glm::vec3& direction, const Components::GlobalLight& light);
+    // Uploads the frame's lights and cluster parameters, after the camera
+    void update(const GlobalUbo& globalUbo, VkExtent2D extent);
+    // Adds the culling pass, readers of the returned buffers must declare them as storage reads
+    GraphBuffers addCullingPass(RenderGraph& graph);
+
+    // Set shared by the culling pass and the object shaders, bound with getDynamicOffsets
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return *this->descriptorSetLayout; }
+    VkDescriptorSet getDescriptorSet() const { return this->descriptorSet; }
+    const uint32_t* getDynamicOffsets() const { return this->dynamicOffsets; }
+    static constexpr uint32_t DynamicOffsetCount = 2;
+    uint32_t getPointLightCount() const { return static_cast<uint32_t>(this->pointLights.size()); }
+  private:
+    void createBuffers();
+    void createDescriptors();
+    void recordCulling(CommandBuffer& cmdBuffer);
+  private:
+    Renderer& ctx;
+    Scope<MemBuffer> lightCountBuffer = nullptr;
+    Scope<MemBuffer> lightIndexBuffer = nullptr;
+    Scope<DescriptorPool> descriptorPool = nullptr;
+    Scope<DescriptorSetLayout> descriptorSetLayout = nullptr;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    // cluster uniforms then lights
+    uint32_t dynamicOffsets[DynamicOffsetCount]{};
+    Scope<Shaders::LightCulling> cullingShader = nullptr;
+
+    // world space until update
+    std::vector<GpuPointLight> pointLights;
+    bool hasGlobalLight = false;
+    glm::vec3 globalLightDirection{ 0.f };
+    Components::GlobalLight globalLight{};
+    bool overflowReported = false;
+  };
+}
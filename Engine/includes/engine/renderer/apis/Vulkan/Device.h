@@ -2,6 +2,7 @@
 
 #include "defines.h"
 #include "CommandBuffer.h"
+#include "HostAllocator.h"
 #include <platform/Window.h>
 #include <core/Application.h>
 
@@ -52,6 +53,7 @@ namespace Engine::Renderers::Vulkan {
   };
 
   class Fence;
+  class SamplerCache;
   class Device {
   public:
     Device(ApplicationInfo& appInfo, Window& window);
@@ -66,9 +68,13 @@ namespace Engine::Renderers::Vulkan {
     operator VkDevice() const { return this->logicalDevice; }
     VkDevice getHandle() const { return this->logicalDevice; }
     const VkAllocationCallbacks* getAllocator() const { return this->allocator; }
+    // null when VK_ENABLE_HOST_ALLOCATOR is off
+    HostAllocator* getHostAllocator() const { return this->hostAllocator.get(); }
     VkPhysicalDevice getPhysicalDevice() const { return this->physicalDevice; }
     VkDevice getLogicalDevice() const { return this->logicalDevice; }
     VkSurfaceKHR getSurface() const { return this->surface; }
+    // No surface nor swapchain, see WindowSpecs::headless
+    bool isHeadless() const { return this->window.isHeadless(); }
     const PhysicalDeviceInfo& getPhysicalDeviceInfo() const { return this->physicalDeviceInfo; }
     const Queues& getQueues() const { return this->queues; }
     const QueueFamilyIndices getQueueFamilies() const { return this->physicalDeviceInfo.queueFamilyIndices; }
@@ -79,6 +85,7 @@ namespace Engine::Renderers::Vulkan {
     VkQueue getTransferQueue() const { return this->queues.transfer; }
 
     VkCommandPool getGraphicsCommandPool() const { return this->graphicsCommandPool; }
+    SamplerCache& getSamplerCache() const { return *this->samplerCache; }
 
     VkResult waitIdle() const { return vkDeviceWaitIdle(this->logicalDevice); }
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
@@ -136,9 +143,11 @@ namespace Engine::Renderers::Vulkan {
     void pickPhysicalDevice();
     void createLogicalDevice();
     void createGraphicsCommandPool();
+    void createSamplerCache();
 
   private:
     std::vector<std::string_view> getRequiredExtensions() const;
+    std::vector<std::string_view> getDeviceExtensions() const;
     bool checkValidationLayerSupport() const;
     static void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
     void checkHasWindowRequiredInstanceExtensions() const;
@@ -149,6 +158,7 @@ namespace Engine::Renderers::Vulkan {
   private:
     ApplicationInfo& appInfo;
     Window& window;
+    Scope<HostAllocator> hostAllocator = nullptr;
     const VkAllocationCallbacks* allocator = nullptr;
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
     VkInstance instance = VK_NULL_HANDLE;
@@ -162,8 +172,9 @@ namespace Engine::Renderers::Vulkan {
     Queues queues;
 
     VkCommandPool graphicsCommandPool = VK_NULL_HANDLE;
+    Scope<SamplerCache> samplerCache = nullptr;
 
     const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
-    const std::vector<std::string_view> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    const std::vector<std::string_view> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME };
   };
 }
\ No newline at end of file
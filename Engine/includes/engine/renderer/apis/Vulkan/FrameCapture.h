@@ -0,0 +1,72 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "MemBuffer.h"
+#include "CommandBuffer.h"
+#include "Fence.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Engine::Renderers::Vulkan {
+  // Asynchronous readback of rendered frames to disk.
+  // The copy is recorded in the frame's own command buffer into a host visible ring slot, the slot is handed to a
+  // writer thread once the frame's fence has signaled, so captures never stall the render loop.
+  // A capture is dropped with a warning when every slot is still busy.
+  class FrameCapture {
+  public:
+    static constexpr uint32_t SlotCount = 3;
+
+    FrameCapture(Device& device);
+    // Waits for the pending captures to be written
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Captures the frame currently recorded to path, .png or .raw
+    void request(std::string path) { this->requestedPath = std::move(path); }
+    bool hasRequest() const { return !this->requestedPath.empty(); }
+
+    // Records the copy of image, which must be in layout and is left in it.
+    // fence is the one the command buffer is submitted with.
+    void record(CommandBuffer& cmdBuffer, VkImage image, VkImageLayout layout, VkExtent2D extent, VkFormat format, Fence& fence);
+    // Hands the captures whose fence has signaled to the writer thread.
+    // Must be called before the frame fences are reset for their next submission.
+    void poll();
+  private:
+    enum class SlotState : uint8_t {
+      Free,
+      // copy submitted, waiting for the fence
+      Recorded,
+      // owned by the writer thread
+      Writing
+    };
+    struct Slot {
+      Scope<MemBuffer> buffer = nullptr;
+      std::atomic<SlotState> state{ SlotState::Free };
+      Fence* fence = nullptr;
+      std::string path;
+      VkExtent2D extent{};
+      VkFormat format = VK_FORMAT_UNDEFINED;
+    };
+
+    void writerLoop();
+    void write(Slot& slot);
+
+    Device& device;
+    std::string requestedPath;
+    std::array<Slot, SlotCount> slots;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<uint32_t> jobs;
+    bool stopping = false;
+  };
+}
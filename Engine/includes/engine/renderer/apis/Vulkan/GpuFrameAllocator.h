@@ -0,0 +1,67 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "MemBuffer.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace Engine::Renderers::Vulkan {
+  // Persistently mapped linear allocator for transient uniform/storage data.
+  // The buffer is split into one region per frame in flight, beginFrame rewinds the region of a frame whose fence has
+  // been waited, so data written during a frame stays valid until the GPU is done with it.
+  // Allocations are aligned for both uniform and storage dynamic offsets, descriptors point at the start of the buffer
+  // (see getDescriptorInfo) and the allocation offset is passed as the dynamic offset when binding.
+  class GpuFrameAllocator {
+  public:
+    static constexpr VkDeviceSize DefaultFrameSize = 4 * 1024 * 1024;
+
+    struct Allocation {
+      void* data = nullptr;
+      // dynamic offset from the start of the buffer
+      uint32_t offset = 0;
+      VkDeviceSize size = 0;
+
+      explicit operator bool() const { return this->data != nullptr; }
+    };
+
+    GpuFrameAllocator(Device& device, uint32_t framesInFlight, VkDeviceSize frameSize = DefaultFrameSize);
+    ~GpuFrameAllocator() = default;
+    GpuFrameAllocator(const GpuFrameAllocator&) = delete;
+    GpuFrameAllocator& operator=(const GpuFrameAllocator&) = delete;
+
+    void beginFrame(uint32_t frameIndex);
+    // Makes the frame's writes visible to the device, must be called before the frame is submitted
+    void endFrame();
+
+    // Empty allocation when the frame region is exhausted
+    Allocation allocate(VkDeviceSize size);
+    template <typename T>
+    Allocation write(const T& data) {
+      auto allocation = this->allocate(sizeof(T));
+      if (allocation)
+        std::memcpy(allocation.data, &data, sizeof(T));
+      return allocation;
+    }
+
+    // Descriptor for a dynamic binding of range bytes, valid for every allocation of at most that size
+    VkDescriptorBufferInfo getDescriptorInfo(VkDeviceSize range) const { return { this->buffer->getHandle(), 0, range }; }
+    VkBuffer getHandle() const { return this->buffer->getHandle(); }
+    VkDeviceSize getAlignment() const { return this->alignment; }
+    VkDeviceSize getFrameSize() const { return this->frameSize; }
+    VkDeviceSize getUsedBytes() const { return this->head - this->frameBegin; }
+    VkDeviceSize getPeakBytes() const { return this->peakBytes; }
+  private:
+    Device& device;
+    Scope<MemBuffer> buffer;
+    std::byte* mapped = nullptr;
+    VkDeviceSize alignment = 0;
+    VkDeviceSize nonCoherentAtomSize = 1;
+    VkDeviceSize frameSize = 0;
+    VkDeviceSize frameBegin = 0;
+    VkDeviceSize head = 0;
+    VkDeviceSize peakBytes = 0;
+    bool overflowReported = false;
+  };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+
+#include <renderer/GpuTimings.h>
+
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  // Timestamp query based GPU profiler.
+  // Every frame in flight owns a query pool, its results are read back when the frame's fence has been waited on,
+  // so timings are available framesInFlight frames after they were recorded without ever stalling.
+  // Scopes nest and can be opened inside render passes, the pool is reset by beginFrame which must be recorded outside one.
+  class GpuProfiler {
+  public:
+    static constexpr uint32_t MaxScopesPerFrame = 128;
+
+    GpuProfiler(Device& device, uint32_t framesInFlight);
+    ~GpuProfiler();
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // false when the graphics queue has no timestamp support, every call is then a no-op
+    bool isSupported() const { return !this->pools.empty(); }
+
+    // Resolves the timings previously recorded for frameIndex, whose fence must have been waited, and resets its queries
+    void beginFrame(CommandBuffer& cmdBuffer, uint32_t frameIndex);
+    void beginScope(CommandBuffer& cmdBuffer, std::string_view name);
+    void endScope(CommandBuffer& cmdBuffer);
+    void endFrame();
+
+    // Latest resolved frame
+    const GpuFrameTimings& getTimings() const { return this->timings; }
+
+    // Opens a scope for its lifetime
+    class ScopeGuard {
+    public:
+      ScopeGuard(GpuProfiler& profiler, CommandBuffer& cmdBuffer, std::string_view name)
+        : profiler(profiler), cmdBuffer(cmdBuffer) {
+        this->profiler.beginScope(this->cmdBuffer, name);
+      }
+      ~ScopeGuard() { this->profiler.endScope(this->cmdBuffer); }
+      ScopeGuard(const ScopeGuard&) = delete;
+      ScopeGuard& operator=(const ScopeGuard&) = delete;
+    private:
+      GpuProfiler& profiler;
+      CommandBuffer& cmdBuffer;
+    };
+  private:
+    struct FrameQueries {
+      VkQueryPool pool = VK_NULL_HANDLE;
+      uint64_t frame = 0;
+      // scope i uses the queries 2i and 2i + 1
+      std::vector<GpuTiming> scopes;
+      bool recorded = false;
+    };
+
+    void resolve(FrameQueries& queries);
+
+    Device& device;
+    std::vector<FrameQueries> pools;
+    FrameQueries* current = nullptr;
+    // indices of the open scopes, UINT32_MAX for scopes dropped past MaxScopesPerFrame
+    std::vector<uint32_t> openScopes;
+    std::vector<uint64_t> results;
+    uint64_t timestampMask = ~uint64_t{ 0 };
+    float timestampPeriod = 0.f;
+    uint64_t frame = 0;
+    GpuFrameTimings timings;
+  };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "defines.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Engine::Renderers::Vulkan {
+  // VkAllocationCallbacks attributing the driver's host allocations to their VkSystemAllocationScope.
+  // Heap allocations are also reported to the MemoryTracker under the Renderer tag.
+  // Command scope allocations only live for the duration of the Vulkan call that made them, with the command arena
+  // enabled they are bumped from a per thread block, reset once all of them are freed, and never reach the heap.
+  class HostAllocator {
+  public:
+    static constexpr size_t ScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+    static constexpr size_t CommandArenaSize = 256 * 1024;
+
+    struct ScopeStats {
+      uint64_t liveBytes = 0;
+      uint64_t peakBytes = 0;
+      // since creation
+      uint64_t allocations = 0;
+      // since the last newFrame
+      uint64_t frameAllocations = 0;
+      // served by the command arena, included in allocations
+      uint64_t arenaAllocations = 0;
+      // driver allocations made without the callbacks, e.g. executable memory
+      uint64_t internalBytes = 0;
+    };
+
+    HostAllocator(bool useCommandArena = VK_ENABLE_HOST_COMMAND_ARENA);
+    ~HostAllocator();
+    HostAllocator(const HostAllocator&) = delete;
+    HostAllocator& operator=(const HostAllocator&) = delete;
+
+    const VkAllocationCallbacks* getCallbacks() const { return &this->callbacks; }
+    ScopeStats getStats(VkSystemAllocationScope scope) const;
+    // Resets the frame allocation counters
+    void newFrame();
+    void logStats() const;
+
+    static std::string_view GetScopeName(VkSystemAllocationScope scope);
+  private:
+    struct alignas(64) Counters {
+      std::atomic<uint64_t> liveBytes{ 0 };
+      std::atomic<uint64_t> peakBytes{ 0 };
+      std::atomic<uint64_t> allocations{ 0 };
+      std::atomic<uint64_t> frameAllocations{ 0 };
+      std::atomic<uint64_t> arenaAllocations{ 0 };
+      std::atomic<uint64_t> internalBytes{ 0 };
+    };
+
+    void* allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void* reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void free(void* memory);
+
+    static VKAPI_ATTR void* VKAPI_CALL Allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void* VKAPI_CALL Reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL Free(void* userData, void* memory);
+    static VKAPI_ATTR void VKAPI_CALL InternalAllocate(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL InternalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+  private:
+    VkAllocationCallbacks callbacks{};
+    std::array<Counters, ScopeCount> counters{};
+    bool useCommandArena;
+  };
+}
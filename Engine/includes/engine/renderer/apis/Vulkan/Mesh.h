@@ -0,0 +1,46 @@
+#pragma once
+
+#include "defines.h"
+
+#include <engine/renderer/Mesh.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  // Range of the renderer's shared object vertex/index buffers owned by a mesh.
+  struct MeshAllocation {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // vertices are bound at this offset, formats with different strides share the same buffer
+    uint64_t vertexByteOffset = 0;
+    // position only stream of standard meshes for the depth prepass, packed meshes use their vertices
+    uint64_t positionByteOffset = 0;
+    uint32_t vertexCount = 0;
+    MeshVertexFormat vertexFormat = MeshVertexFormat::Standard;
+  };
+
+  class Mesh : public Engine::Mesh {
+  public:
+    Mesh(const std::string_view path, const MeshAllocation& allocation, const MeshBounds& bounds, std::vector<MeshLod> lods)
+      : path(path), allocation(allocation), bounds(bounds), lods(std::move(lods)) {}
+    ~Mesh() override = default;
+
+    std::string_view getPath() const override { return this->path; }
+    uint32_t getVertexCount() const override { return this->allocation.vertexCount; }
+    uint32_t getIndexCount() const override { return this->allocation.indexCount; }
+    const MeshBounds& getBounds() const override { return this->bounds; }
+    MeshVertexFormat getVertexFormat() const override { return this->allocation.vertexFormat; }
+    uint32_t getLodCount() const override { return static_cast<uint32_t>(this->lods.size()); }
+    const MeshLod& getLod(uint32_t lod) const override { return this->lods[std::min<size_t>(lod, this->lods.size() - 1)]; }
+
+    const MeshAllocation& getAllocation() const { return this->allocation; }
+  private:
+    std::string path;
+    MeshAllocation allocation;
+    MeshBounds bounds;
+    // index ranges relative to allocation.firstIndex, lod 0 first
+    std::vector<MeshLod> lods;
+  };
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+#include "MemBuffer.h"
+#include "Descriptors.h"
+#include "RenderGraph.h"
+
+#include <engine/scene/components/ParticleEmitter.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  class BillboardRenderer;
+  namespace Shaders {
+    class Particles;
+  }
+
+  // GPU particle system, the CPU only uploads the frame's emitters and never touches a particle.
+  // Particles live in a fixed pool with a dead list of free slots and two alive lists swapped every frame:
+  // - kickoff clamps the emission to the dead particles and writes the simulation's indirect dispatch
+  // - emit pops dead slots and appends the new particles to the current alive list
+  // - simulate ages the current list, expired particles go back to the dead list, the others are compacted into the
+  //   next alive list and written as billboard instances, counted by the indirect draw of the billboard path
+  class ParticleSystem {
+  public:
+    static constexpr uint32_t MaxParticles = 1u << 20;
+    // emitters past this count are dropped, the emitter block must fit the minimum maxUniformBufferRange
+    static constexpr uint32_t MaxEmitters = 128;
+
+    // std430, see builtin.particles.*.glsl.comp
+    struct GpuParticle {
+      glm::vec4 positionAge;
+      glm::vec4 velocityLifetime;
+      // rounded in w
+      glm::vec4 accelerationRounded;
+      // start and end colors as unorm4x8, start and end sizes as half2x16
+      glm::uvec4 colorsSizes;
+    };
+    // std140
+    struct GpuEmitter {
+      glm::vec4 positionRadius;
+      glm::vec4 velocitySpread;
+      glm::vec4 accelerationRounded;
+      glm::vec4 startColor;
+      glm::vec4 endColor;
+      // min lifetime, max lifetime, start size, end size
+      glm::vec4 lifetimeSizes;
+      // first emitted index of the frame, count
+      glm::uvec4 range;
+    };
+    struct Counters {
+      uint32_t aliveCount[2];
+      uint32_t deadCount;
+      // emitted this frame, after clamping
+      uint32_t emitCount;
+    };
+    struct IndirectArgs {
+      VkDispatchIndirectCommand simulate;
+      uint32_t _pad0;
+      VkDrawIndirectCommand draw;
+    };
+    struct PushConstants {
+      float deltaTime = 0.f;
+      // requested this frame
+      uint32_t emitCount = 0;
+      uint32_t emitterCount = 0;
+      uint32_t seed = 0;
+      // alive list simulated this frame
+      uint32_t aliveList = 0;
+    };
+    // Billboard instances written by the simulation, and their indirect draw
+    struct GraphBuffers {
+      RenderGraph::BufferHandle instances;
+      RenderGraph::BufferHandle indirectArgs;
+    };
+
+    ParticleSystem(Renderer& ctx, BillboardRenderer& billboards);
+    ~ParticleSystem();
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    void beginFrame();
+    void emit(const glm::vec3& position, const Components::ParticleEmitter& emitter, uint32_t count);
+    // Adds the reset, kickoff, emit and simulate passes, none when no particle can be alive
+    GraphBuffers addPasses(RenderGraph& graph, float deltaTime);
+    // Draws the particles through the billboard path, inside the main pass
+    void record(VkFrameInfo& frameInfo);
+  private:
+    void createBuffers();
+    void createDescriptors(DescriptorSetLayout& instanceSetLayout);
+    void bindKernel(CommandBuffer& cmdBuffer, const Shaders::Particles& kernel, const PushConstants& pushConstants);
+  private:
+    Renderer& ctx;
+    BillboardRenderer& billboards;
+    Scope<MemBuffer> particleBuffer = nullptr;
+    Scope<MemBuffer> deadListBuffer = nullptr;
+    Scope<MemBuffer> aliveListBuffer = nullptr;
+    Scope<MemBuffer> counterBuffer = nullptr;
+    Scope<MemBuffer> indirectBuffer = nullptr;
+    Scope<MemBuffer> instanceBuffer = nullptr;
+    Scope<DescriptorPool> descriptorPool = nullptr;
+    Scope<DescriptorSetLayout> descriptorSetLayout = nullptr;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    // instances for the billboard shader
+    VkDescriptorSet instanceSet = VK_NULL_HANDLE;
+    Scope<Shaders::Particles> resetKernel = nullptr;
+    Scope<Shaders::Particles> kickoffKernel = nullptr;
+    Scope<Shaders::Particles> emitKernel = nullptr;
+    Scope<Shaders::Particles> simulateKernel = nullptr;
+
+    std::vector<GpuEmitter> emitters;
+    uint32_t requestedCount = 0;
+    // dynamic offset of the emitter block, any fully allocated block is valid when nothing is emitted
+    uint32_t emitterOffset = 0;
+    uint32_t aliveList = 0;
+    uint32_t frame = 0;
+    // upper bound of the time the oldest particle has left, the passes are skipped once it runs out
+    float activeTime = 0.f;
+    bool needsReset = true;
+    bool drawThisFrame = false;
+    bool overflowReported = false;
+  };
+}
@@ -56,6 +56,8 @@ namespace Engine::Renderers::Vulkan::Shaders {
 
     operator VkPipeline() const { return this->handle; }
     VkPipelineLayout getLayout() const { return this->layout; }
+    // a single compute stage makes a compute pipeline
+    bool isCompute() const { return this->compute; }
   private:
     void init(ConfigInfo& configInfo);
     void createLayout(
@@ -64,9 +66,14 @@ namespace Engine::Renderers::Vulkan::Shaders {
     void createGraphicsPipeline(
       const ConfigInfo& configInfo
     );
+    // only the stage and layout data of configInfo is used
+    void createComputePipeline(
+      const ConfigInfo& configInfo
+    );
 
     Device& device;
     VkPipeline handle = VK_NULL_HANDLE;
     VkPipelineLayout layout = VK_NULL_HANDLE;
+    bool compute = false;
   };
 };
\ No newline at end of file
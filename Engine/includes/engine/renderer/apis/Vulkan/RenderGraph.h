@@ -0,0 +1,272 @@
+#pragma once
+
+#include "defines.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::Renderers::Vulkan {
+  class GpuProfiler;
+
+  // Frame graph rebuilt every frame.
+  // - passes declare the images and buffers they use, and run in declaration order
+  // - compile culls the passes whose results are never used and computes the barriers between the others (synchronization2)
+  // - transient images are created by the graph, images whose lifetimes don't overlap share the same memory
+  // - graphics passes get a render pass and framebuffer built from their attachments, with load/store ops derived from
+  //   the other passes (nothing is loaded before the first write, nothing is stored after the last read)
+  // Physical images, render passes and framebuffers are cached across frames.
+  class RenderGraph {
+  public:
+    struct ImageHandle {
+      uint32_t index = UINT32_MAX;
+      bool isValid() const { return this->index != UINT32_MAX; }
+    };
+    struct BufferHandle {
+      uint32_t index = UINT32_MAX;
+      bool isValid() const { return this->index != UINT32_MAX; }
+    };
+    // Images created by the graph, their content does not survive the frame
+    struct ImageDesc {
+      VkFormat format = VK_FORMAT_UNDEFINED;
+      VkExtent2D extent{};
+    };
+    // Images owned outside the graph, e.g. swapchain images or persistent shadow maps
+    struct ImportedImage {
+      VkImage image = VK_NULL_HANDLE;
+      VkImageView view = VK_NULL_HANDLE;
+      VkFormat format = VK_FORMAT_UNDEFINED;
+      VkExtent2D extent{};
+      // state before the graph, a freshly acquired swapchain image is UNDEFINED and waited at COLOR_ATTACHMENT_OUTPUT
+      VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+      VkPipelineStageFlags2KHR initialStage = VK_PIPELINE_STAGE_2_NONE_KHR;
+      VkAccessFlags2KHR initialAccess = VK_ACCESS_2_NONE_KHR;
+      // layout the image is left in, UNDEFINED keeps the layout of its last use
+      VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+    enum class BufferUsage {
+      Vertex,
+      Index,
+      Indirect,
+      Uniform,
+      StorageRead,
+      StorageWrite,
+      TransferSrc,
+      TransferDst
+    };
+    enum class PassType {
+      Graphics,
+      Compute,
+      Transfer
+    };
+
+    struct PassContext {
+      CommandBuffer& cmdBuffer;
+      // null outside graphics passes
+      VkRenderPass renderPass;
+      VkExtent2D extent;
+      const RenderGraph& graph;
+    };
+    using ExecuteCallback = std::function<void(PassContext&)>;
+
+    class PassBuilder {
+    public:
+      PassBuilder& colorAttachment(ImageHandle image, bool clear = false, const glm::vec4& clearColor = {});
+      // read only when write is false, e.g. for a color pass testing against a depth prepass
+      PassBuilder& depthAttachment(ImageHandle image, bool write = true, bool clear = false, float clearDepth = 1.f);
+      PassBuilder& sample(ImageHandle image);
+      PassBuilder& read(BufferHandle buffer, BufferUsage usage);
+      PassBuilder& write(BufferHandle buffer, BufferUsage usage = BufferUsage::StorageWrite);
+      // never culled, for passes whose results leave the graph some other way
+      PassBuilder& setSideEffects();
+    private:
+      friend class RenderGraph;
+      PassBuilder(RenderGraph& graph, uint32_t pass) : graph(graph), pass(pass) {}
+
+      RenderGraph& graph;
+      uint32_t pass;
+    };
+
+    struct Stats {
+      uint32_t passes = 0;
+      uint32_t culledPasses = 0;
+      uint32_t barriers = 0;
+      uint32_t transientImages = 0;
+      // memory backing the transient images, and what they would take without aliasing
+      VkDeviceSize transientBytes = 0;
+      VkDeviceSize unaliasedBytes = 0;
+    };
+
+    RenderGraph(Device& device, uint32_t framesInFlight);
+    ~RenderGraph();
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Starts a new graph, the handles of the previous one become invalid
+    void reset();
+    ImageHandle importImage(std::string_view name, const ImportedImage& image);
+    ImageHandle createImage(std::string_view name, const ImageDesc& desc);
+    BufferHandle importBuffer(std::string_view name, VkBuffer buffer);
+    // names must be string literals, they are used as GPU profiler scopes
+    PassBuilder addPass(std::string_view name, PassType type, ExecuteCallback execute);
+
+    void compile();
+    void execute(CommandBuffer& cmdBuffer, GpuProfiler* profiler = nullptr);
+
+    VkImage getImage(ImageHandle image) const;
+    VkImageView getImageView(ImageHandle image) const;
+    VkBuffer getBuffer(BufferHandle buffer) const { return this->buffers[buffer.index].buffer; }
+    const Stats& getStats() const { return this->stats; }
+
+    // Render pass compatible with the ones of graphics passes using these formats, for pipeline creation
+    VkRenderPass getCompatibleRenderPass(const std::vector<VkFormat>& colorFormats, VkFormat depthFormat = VK_FORMAT_UNDEFINED);
+    // Destroys the cached framebuffers and transient images, the device must be idle
+    void releaseResources();
+  private:
+    // last accesses of a resource, reads are accumulated until the next write
+    struct ResourceState {
+      VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+      VkPipelineStageFlags2KHR writeStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+      VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+      VkPipelineStageFlags2KHR readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+      VkAccessFlags2KHR readAccess = VK_ACCESS_2_NONE_KHR;
+    };
+    struct Access {
+      VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+      VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+      VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+      bool write = false;
+      // previous content is not needed, e.g. cleared attachments
+      bool discard = false;
+    };
+    struct ImageResource {
+      std::string_view name;
+      bool imported = false;
+      ImportedImage import{};
+      VkImageUsageFlags usage = 0;
+      VkImageAspectFlags aspect = 0;
+      uint32_t physical = UINT32_MAX;
+      // alive passes using the image, for aliasing and load/store ops
+      uint32_t firstPass = UINT32_MAX;
+      uint32_t lastPass = 0;
+      bool written = false;
+      ResourceState state{};
+    };
+    struct BufferResource {
+      std::string_view name;
+      VkBuffer buffer = VK_NULL_HANDLE;
+      ResourceState state{};
+    };
+    struct Attachment {
+      uint32_t image = UINT32_MAX;
+      bool clear = false;
+      bool write = true;
+      VkClearValue clearValue{};
+    };
+    struct ImageUse {
+      uint32_t image;
+      Access access;
+    };
+    struct BufferUse {
+      uint32_t buffer;
+      Access access;
+    };
+    struct Pass {
+      std::string_view name;
+      PassType type = PassType::Graphics;
+      ExecuteCallback execute;
+      std::vector<Attachment> colors;
+      Attachment depth{};
+      std::vector<ImageUse> images;
+      std::vector<BufferUse> buffers;
+      bool sideEffects = false;
+      bool culled = false;
+      // set by compile
+      std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+      std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+      VkRenderPass renderPass = VK_NULL_HANDLE;
+      VkFramebuffer framebuffer = VK_NULL_HANDLE;
+      VkExtent2D extent{};
+      std::vector<VkClearValue> clearValues;
+    };
+    // Transient image storage, shared by the images whose lifetimes don't overlap
+    struct MemoryBlock {
+      VkDeviceMemory memory = VK_NULL_HANDLE;
+      VkDeviceSize size = 0;
+      VkDeviceSize alignment = 1;
+      uint32_t memoryTypeBits = ~0u;
+      std::vector<std::pair<uint32_t, uint32_t>> lifetimes;
+      // accesses of the last image using the block, the next one waits on them before discarding the content
+      VkPipelineStageFlags2KHR lastStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+      VkAccessFlags2KHR lastWriteAccess = VK_ACCESS_2_NONE_KHR;
+    };
+    struct PhysicalImage {
+      VkImage image = VK_NULL_HANDLE;
+      VkImageView view = VK_NULL_HANDLE;
+      uint32_t block = UINT32_MAX;
+    };
+    struct RetiredResources {
+      uint64_t frame = 0;
+      std::vector<PhysicalImage> images;
+      std::vector<MemoryBlock> blocks;
+    };
+    struct CachedFramebuffer {
+      VkFramebuffer handle = VK_NULL_HANDLE;
+      uint64_t lastUsedFrame = 0;
+    };
+    struct AttachmentKey {
+      VkFormat format;
+      VkAttachmentLoadOp loadOp;
+      VkAttachmentStoreOp storeOp;
+      VkImageLayout layout;
+    };
+
+    Pass& getPass(uint32_t pass) { return this->passes[pass]; }
+    void useImage(uint32_t pass, uint32_t image, const Access& access, VkImageUsageFlags usage);
+    Access getBufferAccess(PassType type, BufferUsage usage) const;
+
+    void cull();
+    void allocateTransientImages();
+    void destroyRetired(bool all);
+    void computeBarriers(Pass& pass, uint32_t passIndex);
+    bool transition(ResourceState& state, const Access& access, bool isImage, VkPipelineStageFlags2KHR& srcStages, VkAccessFlags2KHR& srcAccess);
+    void createRenderPass(Pass& pass, uint32_t passIndex);
+    VkRenderPass getRenderPass(const std::vector<AttachmentKey>& colors, const AttachmentKey* depth);
+    VkFramebuffer getFramebuffer(VkRenderPass renderPass, const std::vector<VkImageView>& views, VkExtent2D extent);
+  private:
+    Device& device;
+    uint32_t framesInFlight;
+    uint64_t frame = 0;
+    bool compiled = false;
+
+    // reused across frames, only the first count entries are part of the current graph
+    std::vector<Pass> passes;
+    uint32_t passCount = 0;
+    std::vector<ImageResource> images;
+    uint32_t imageCount = 0;
+    std::vector<BufferResource> buffers;
+    uint32_t bufferCount = 0;
+    std::vector<VkImageMemoryBarrier2KHR> finalBarriers;
+    // scratch storage for compile
+    std::vector<uint8_t> imageNeeded;
+    std::vector<AttachmentKey> colorKeys;
+    std::vector<VkImageView> attachmentViews;
+    // state of imported buffers at the end of their last graph
+    std::unordered_map<VkBuffer, ResourceState> bufferStates;
+
+    std::vector<PhysicalImage> physicalImages;
+    std::vector<MemoryBlock> memoryBlocks;
+    // transient images and lifetimes the physical images were created for
+    size_t transientLayout = 0;
+    std::vector<RetiredResources> retired;
+
+    std::unordered_map<size_t, VkRenderPass> renderPasses;
+    std::unordered_map<size_t, CachedFramebuffer> framebuffers;
+    Stats stats{};
+  };
+}
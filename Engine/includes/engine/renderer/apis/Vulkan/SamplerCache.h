@@ -0,0 +1,39 @@
+#pragma once
+
+#include "defines.h"
+
+#include <engine/renderer/Texture.h>
+
+#include <unordered_map>
+#include <mutex>
+
+namespace Engine::Renderers::Vulkan {
+  class Device;
+  // Deduplicates VkSampler objects by their specification.
+  // Drivers cap the amount of live samplers (often 4000), while most textures share the same sampler state.
+  class SamplerCache {
+  public:
+    SamplerCache(Device& device);
+    ~SamplerCache();
+
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+
+    // every acquire must be paired with a release of the returned handle
+    VkSampler acquire(const TextureSamplerSpecification& spec);
+    void release(VkSampler sampler);
+
+    uint32_t getSize() const;
+  private:
+    struct Entry {
+      VkSampler handle = VK_NULL_HANDLE;
+      uint32_t refCount = 0;
+    };
+    VkSampler create(const TextureSamplerSpecification& spec) const;
+  private:
+    Device& device;
+    std::unordered_map<TextureSamplerSpecification, Entry> samplers;
+    std::unordered_map<VkSampler, TextureSamplerSpecification> owners;
+    mutable std::mutex mutex;
+  };
+}
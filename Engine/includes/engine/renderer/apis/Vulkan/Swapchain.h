@@ -3,7 +3,6 @@
 #include "defines.h"
 #include "Device.h"
 #include "Image.h"
-#include "Framebuffer.h"
 #include "RenderPass.h"
 #include "Semaphore.h"
 #include "Fence.h"
@@ -21,10 +20,15 @@ namespace Engine::Renderers::Vulkan {
     VkExtent2D windowExtent{};
     std::shared_ptr<Swapchain> oldSwapchain = nullptr;
     bool vSync = false;
+    // Render to images owned by the swapchain object instead of a VkSwapchainKHR, for headless devices
+    bool offscreen = false;
     RenderPassCreateInfo mainRenderPassCreateInfo;
   };
   class Swapchain {
   public:
+    static constexpr uint32_t OffscreenImageCount = 3;
+    static constexpr VkFormat OffscreenImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
     Swapchain(Device& device, const SwapchainCreateInfo& createInfo);
     ~Swapchain();
 
@@ -37,15 +41,18 @@ namespace Engine::Renderers::Vulkan {
     uint32_t width() const { return this->swapChainExtent.width; }
     uint32_t height() const { return this->swapChainExtent.height; }
     uint32_t getMaxFramesInFlight() const { return this->maxFramesInFlight; }
+    bool isOffscreen() const { return this->offscreen; }
+    bool canReadback() const { return this->imageUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT; }
+    // layout the images are left in at the end of the frame
+    VkImageLayout getFinalLayout() const { return this->offscreen ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; }
+    // compatible with the render graph's main pass, used to create pipelines and holding the clear values
     RenderPass& getMainRenderPass() const { return *this->mainRenderPass; }
-    Framebuffer& getFramebuffer(uint32_t index) { return this->framebuffers[index]; }
     uint32_t getImageCount() const { return static_cast<uint32_t>(this->images.size()); }
     VkFormat getImageFormat() const { return this->imageFormat.format; }
+    VkImage getImage(uint32_t index) const { return this->images[index]; }
     VkImageView getImageView(uint32_t index) const { return this->imageViews[index]; }
     const std::vector<VkImageView>& getImageViews() const { return this->imageViews; }
     VkFormat getDepthFormat() const { return this->depthFormat; }
-    VkImageView getDepthImageView(uint32_t index) const { return this->depthImages[index].getView(); }
-    const std::vector<Image>& getDepthImages() const { return this->depthImages; }
     float getAspectRatio() const { return static_cast<float>(this->swapChainExtent.width) / static_cast<float>(this->windowExtent.height); }
     bool compareFormats(const Swapchain& other) const {
       return this->imageFormat.format == other.imageFormat.format &&
@@ -62,10 +69,9 @@ namespace Engine::Renderers::Vulkan {
   private:
     void init(const SwapchainCreateInfo& createInfo);
     void createSwapChain();
+    void createOffscreenImages();
     void createImageViews();
-    void createDepthResources();
     void createMainRenderPass(const RenderPassCreateInfo& createInfo);
-    void createFramebuffers();
 
     // Helper functions
     VkSurfaceFormatKHR chooseSurfaceFormat(
@@ -80,11 +86,12 @@ namespace Engine::Renderers::Vulkan {
     VkSwapchainKHR handle = VK_NULL_HANDLE;
     VkExtent2D windowExtent;
     bool vSync = false;
+    bool offscreen = false;
+    VkImageUsageFlags imageUsage = 0;
     uint32_t maxFramesInFlight = 0;
     std::shared_ptr<Swapchain> oldSwapchain = nullptr;
 
     Scope<RenderPass> mainRenderPass = nullptr;
-    std::vector<Framebuffer> framebuffers;
 
     VkSurfaceFormatKHR imageFormat;
     VkFormat depthFormat;
@@ -92,8 +99,10 @@ namespace Engine::Renderers::Vulkan {
 
     std::vector<VkImage> images;
     std::vector<VkImageView> imageViews;
-    std::vector<Image> depthImages;
+    // backing storage of images when offscreen
+    std::vector<Image> colorImages;
 
     size_t currentFrame = 0;
+    uint32_t nextOffscreenImage = 0;
   };
 }
\ No newline at end of file
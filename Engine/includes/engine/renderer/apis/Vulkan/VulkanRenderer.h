@@ -10,10 +10,24 @@
 #include "Fence.h"
 #include "Semaphore.h"
 #include "MemBuffer.h"
+#include "FrameCapture.h"
+#include "GpuProfiler.h"
+#include "GpuFrameAllocator.h"
+#include "RenderGraph.h"
+#include "ClusteredLighting.h"
+#include "CascadedShadows.h"
+#include "BillboardRenderer.h"
+#include "ParticleSystem.h"
+#include "Descriptors.h"
 
 // #include "shaders/Object.h"
 namespace Engine::Renderers::Vulkan::Shaders {
+  class Base;
   class Object;
+  class Depth;
+}
+namespace Engine::Renderers::Vulkan {
+  class Mesh;
 }
 
 #include <core/Application.h>
@@ -46,11 +60,40 @@ namespace Engine::Renderers::Vulkan {
     Ref<Engine::Texture2D> createTexture2D(const TextureSpecification& spec) override;
     Ref<Engine::Texture2D> createTexture2D(const std::string_view& path) override;
 
+    Ref<Engine::Mesh> createMesh(const std::string_view& path, MeshVertexFormat format = MeshVertexFormat::Standard) override;
+    void drawMesh(const Engine::Mesh& mesh, const glm::mat4& model, uint32_t lod = 0, bool isStatic = false) override;
+    void drawBillboard(const glm::vec3& position, const Components::Billboard& billboard) override;
+    void emitParticles(const glm::vec3& position, const Components::ParticleEmitter& emitter, uint32_t count) override;
+    void addPointLight(const glm::vec3& position, const Components::PointLight& light) override;
+    void setGlobalLight(const glm::vec3& direction, const Components::GlobalLight& light) override;
+    void captureFrame(const std::string_view& path) override;
+    const GpuFrameTimings& getGpuTimings() const override { return this->gpuProfiler->getTimings(); }
+
+    bool initImGui() override;
+    void shutdownImGui() override;
+    void beginImGuiFrame() override;
+
     Device& getDevice() { return this->device; }
     Swapchain& getSwapchain() const { return *this->swapchain; }
     RenderPass& getMainRenderPass() const { return this->swapchain->getMainRenderPass(); }
     CommandBuffer& getCurrentGraphicsCommandBuffer() { return this->graphicsCommandBuffers[this->currentImageIndex]; }
+    GpuProfiler& getGpuProfiler() { return *this->gpuProfiler; }
+    // transient uniform/storage data of the current frame
+    GpuFrameAllocator& getFrameAllocator() { return *this->frameAllocator; }
+    RenderGraph& getRenderGraph() { return *this->renderGraph; }
+    ClusteredLighting& getLighting() { return *this->lighting; }
+    CascadedShadows& getShadows() { return *this->shadows; }
   private:
+    // recorded by the main pass, the mesh must stay alive until endFrame
+    struct MeshDraw {
+      const Mesh* mesh;
+      glm::mat4 model;
+      uint32_t lod;
+      bool isStatic;
+      // distance along the view direction, for front to back ordering
+      float viewDepth = 0.f;
+    };
+
     VkExtent2D getWindowExtent() const {
       return { platform.window->getWidth(), platform.window->getHeight() };
     }
@@ -60,6 +103,20 @@ namespace Engine::Renderers::Vulkan {
     void createSyncObjects();
     void createObjectBuffers();
     void uploadTestObjectData();
+    // copies the positions of standard vertices to the position stream, returns their byte offset
+    uint64_t uploadVertexPositions(const void* vertices, uint32_t vertexCount);
+    void buildRenderGraph(FrameInfo& frameInfo);
+    void sortMeshDraws(const glm::mat4& view);
+    void recordDepthPrepass(RenderGraph::PassContext& context, FrameInfo& frameInfo);
+    void recordMainPass(RenderGraph::PassContext& context, FrameInfo& frameInfo);
+    void recordShadowCascade(RenderGraph::PassContext& context, FrameInfo& frameInfo, const CascadedShadows::Cascade& cascade);
+    void recordTestObjects(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout);
+    // lit: the pipeline uses the clustered lighting and shadow sets, i.e. it is an object shader
+    void bindObjectShader(CommandBuffer& cmdBuffer, const Shaders::Base& shader, bool lit);
+    void bindLightingSet(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout);
+    void pushMeshConstants(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout, const MeshDraw& draw);
+    void recordMeshDraw(CommandBuffer& cmdBuffer, const MeshDraw& draw);
+    void recordMeshDepth(CommandBuffer& cmdBuffer, const MeshDraw& draw, bool shadowCaster = false);
 
     // temp
     void uploadDataToBuffer(
@@ -79,13 +136,42 @@ namespace Engine::Renderers::Vulkan {
     std::vector<Semaphore> renderFinishedSemaphores;
     std::vector<Fence> inFlightFences;
     std::vector<Fence*> imagesInFlightFences;
+    Scope<FrameCapture> frameCapture = nullptr;
+    Scope<GpuProfiler> gpuProfiler = nullptr;
+    Scope<GpuFrameAllocator> frameAllocator = nullptr;
+    Scope<RenderGraph> renderGraph = nullptr;
+    Scope<ClusteredLighting> lighting = nullptr;
+    Scope<CascadedShadows> shadows = nullptr;
+    Scope<BillboardRenderer> billboards = nullptr;
+    // drawn through billboards
+    Scope<ParticleSystem> particles = nullptr;
+    Scope<DescriptorPool> imguiDescriptorPool = nullptr;
+    bool imguiEnabled = false;
 
     Scope<Shaders::Object> objectShader = nullptr;
+    Scope<Shaders::Object> packedObjectShader = nullptr;
+    // color pipelines testing EQUAL against the depth prepass
+    Scope<Shaders::Object> prepassObjectShader = nullptr;
+    Scope<Shaders::Object> prepassPackedObjectShader = nullptr;
+    Scope<Shaders::Depth> depthShader = nullptr;
+    Scope<Shaders::Depth> packedDepthShader = nullptr;
+    Scope<Shaders::Depth> shadowDepthShader = nullptr;
+    Scope<Shaders::Depth> packedShadowDepthShader = nullptr;
+    const Shaders::Base* boundObjectShader = nullptr;
+    // global uniforms of the pass being recorded, the camera's or a shadow cascade's
+    uint32_t passGlobalUniformOffset = 0;
     Scope<MemBuffer> objectVertexBuffer = nullptr;
     Scope<MemBuffer> objectIndexBuffer = nullptr;
+    // positions of the standard vertices, read by the depth prepass
+    Scope<MemBuffer> objectPositionBuffer = nullptr;
     uint64_t objectVertexOffset = 0;
     uint64_t objectIndexOffset = 0;
-
+    uint64_t objectPositionOffset = 0;
+    std::vector<MeshDraw> meshDraws;
+    // meshDraws indices, front to back
+    std::vector<uint32_t> depthOrder;
+    // depth prepass state of the frame being recorded
+    bool frameDepthPrepass = false;
 
     uint32_t currentImageIndex = 0;
     uint32_t currentFrameIndex = 0;
@@ -18,6 +18,14 @@
 #ifndef VK_ENABLE_DEBUG_MESSENGER
 # define VK_ENABLE_DEBUG_MESSENGER VK_ENABLE_VALIDATION_LAYERS
 #endif
+// Driver host allocations go through HostAllocator instead of the driver's own allocator
+#ifndef VK_ENABLE_HOST_ALLOCATOR
+# define VK_ENABLE_HOST_ALLOCATOR 1
+#endif
+// Command scope allocations are served from a per thread arena instead of the heap
+#ifndef VK_ENABLE_HOST_COMMAND_ARENA
+# define VK_ENABLE_HOST_COMMAND_ARENA 1
+#endif
 
 namespace Engine::Renderers::Vulkan {
   class CommandBuffer;
@@ -28,6 +36,7 @@ namespace Engine::Renderers::Vulkan {
     uint32_t frameIndex;
     CommandBuffer& cmdBuffer;
     VkDescriptorSet globalDescriptorSet;
+    uint32_t globalUniformOffset = 0;
   };
   void DestroyDebugUtilsMessengerEXT(
     VkInstance instance,
@@ -40,4 +49,10 @@ namespace Engine::Renderers::Vulkan {
     const VkAllocationCallbacks* pAllocator,
     VkDebugUtilsMessengerEXT* pDebugMessenger
   );
+  // VK_KHR_synchronization2, enabled on every device
+  void CmdPipelineBarrier2(
+    VkDevice device,
+    VkCommandBuffer commandBuffer,
+    const VkDependencyInfoKHR* pDependencyInfo
+  );
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.h"
+
+#include <glm/glm.hpp>
+#include <string_view>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  namespace Shaders {
+    // Camera facing quads without vertex input, 6 vertices per instance read from a storage buffer (set 1).
+    // Depth is tested but not written, instances are blended in submission order
+    class Billboard : public Base {
+    public:
+      static constexpr std::string_view StagesName = "builtin.billboard";
+      static constexpr uint32_t VerticesPerInstance = 6;
+      // std430, see builtin.billboard.glsl.vert
+      struct Instance {
+        // world space, w unused
+        glm::vec4 position;
+        glm::vec4 color;
+        glm::vec2 size;
+        // 1 for a rounded box signed distance, 0 for a plain quad
+        float rounded;
+        float _pad0;
+      };
+
+      Billboard(
+        Renderer& ctx,
+        VkRenderPass renderPass,
+        VkDescriptorSetLayout globalDescriptorSetLayout,
+        VkDescriptorSetLayout instanceDescriptorSetLayout
+      );
+      ~Billboard() = default;
+
+      Billboard(const Billboard&) = delete;
+      Billboard& operator=(const Billboard&) = delete;
+
+      // binds frameInfo.globalDescriptorSet with frameInfo.globalUniformOffset
+      void use(VkFrameInfo& frameInfo) override;
+    private:
+      void init(VkDescriptorSetLayout globalDescriptorSetLayout, VkDescriptorSetLayout instanceDescriptorSetLayout);
+    private:
+      VkRenderPass renderPass;
+    };
+  }
+};
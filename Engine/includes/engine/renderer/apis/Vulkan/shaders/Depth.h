@@ -0,0 +1,43 @@
+#pragma once
+
+#include "defines.h"
+#include <engine/renderer/Mesh.h>
+
+#include <string_view>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  namespace Shaders {
+    // Depth only pipeline of the depth prepass, no fragment stage and no color attachment.
+    // Standard meshes read the renderer's position stream, packed ones read the position of the packed vertices.
+    // Push constants and the global set layout match Object so draws are recorded the same way.
+    // Shadow caster pipelines render the cascades of CascadedShadows: no culling and a slope scaled depth bias
+    class Depth : public Base {
+    public:
+      static constexpr std::string_view StagesName = "builtin.depth";
+      static constexpr std::string_view PackedStagesName = "builtin.depth.packed";
+      Depth(
+        Renderer& ctx,
+        VkRenderPass renderPass,
+        VkDescriptorSetLayout globalDescriptorSetLayout,
+        MeshVertexFormat vertexFormat = MeshVertexFormat::Standard,
+        bool shadowCaster = false
+      );
+      ~Depth() = default;
+
+      Depth(const Depth&) = delete;
+      Depth& operator=(const Depth&) = delete;
+
+      // binds frameInfo.globalDescriptorSet with frameInfo.globalUniformOffset
+      void use(VkFrameInfo& frameInfo) override;
+
+      MeshVertexFormat getVertexFormat() const { return this->vertexFormat; }
+    private:
+      void init(VkDescriptorSetLayout globalDescriptorSetLayout);
+    private:
+      VkRenderPass renderPass;
+      MeshVertexFormat vertexFormat;
+      bool shadowCaster;
+    };
+  }
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "defines.h"
+
+#include <string_view>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  namespace Shaders {
+    // Compute pipeline binning point lights into froxels, see ClusteredLighting
+    class LightCulling : public Base {
+    public:
+      static constexpr std::string_view StagesName = "builtin.lightculling";
+      // must match local_size_x
+      static constexpr uint32_t GroupSize = 64;
+      LightCulling(Renderer& ctx, VkDescriptorSetLayout clusterDescriptorSetLayout);
+      ~LightCulling() = default;
+
+      LightCulling(const LightCulling&) = delete;
+      LightCulling& operator=(const LightCulling&) = delete;
+
+      // binds the pipeline only, the cluster set is bound by ClusteredLighting
+      void use(VkFrameInfo& frameInfo) override;
+    private:
+      void init(VkDescriptorSetLayout clusterDescriptorSetLayout);
+    };
+  }
+};
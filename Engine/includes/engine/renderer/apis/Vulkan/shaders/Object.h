@@ -2,7 +2,8 @@
 
 #include "defines.h"
 #include "renderer/apis/Vulkan/RenderPass.h"
-#include "renderer/apis/Vulkan/UniformBuffer.h"
+#include "renderer/apis/Vulkan/Descriptors.h"
+#include <engine/renderer/Mesh.h>
 
 #include <glm/glm.hpp>
 #include <string_view>
@@ -16,32 +17,61 @@ namespace Engine::Renderers::Vulkan {
       struct Vertex {
         glm::vec3 position;
         glm::vec3 color;
+        glm::vec3 normal;
+        glm::vec2 uv;
 
         static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
         static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
       };
+      // See Engine::PackedMeshVertex
+      struct PackedVertex {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t uv[2];
+        uint8_t color[4];
+
+        static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
+      };
+      // Packed positions are dequantized in the vertex shader as positionOffset + position * positionScale
+      struct PackedPushConstants {
+        glm::mat4 model;
+        glm::vec4 positionOffset;
+        glm::vec4 positionScale;
+      };
       static constexpr std::string_view StagesName = "builtin.object";
-      Object(Renderer& ctx, RenderPass& renderPass);
+      static constexpr std::string_view PackedStagesName = "builtin.object.packed";
+      // afterDepthPrepass: depth is tested EQUAL against the prepass and never written
+      Object(Renderer& ctx, RenderPass& renderPass, MeshVertexFormat vertexFormat = MeshVertexFormat::Standard, bool afterDepthPrepass = false);
       ~Object();
 
       Object(const Object&) = delete;
       Object& operator=(const Object&) = delete;
 
+      // binds the pipeline and frameInfo.globalDescriptorSet with frameInfo.globalUniformOffset
+      // the lighting set (set 1) is bound separately, see ClusteredLighting
       void use(VkFrameInfo& frameInfo) override;
 
-      VkDescriptorSet getGlobalDescriptorSet(uint32_t frameIndex) const {
-        return this->globalDescriptorSets[frameIndex];
-      }
+      // the set binds the global uniforms as a dynamic uniform buffer, bound with getGlobalUniformOffset
+      // only the instance updating the global uniforms holds the frame's offset
+      VkDescriptorSet getGlobalDescriptorSet() const { return this->globalDescriptorSet; }
+      VkDescriptorSetLayout getGlobalDescriptorSetLayout() const { return *this->globalDescriptorSetLayout; }
+      uint32_t getGlobalUniformOffset() const { return this->globalUniformOffset; }
 
+      // Streams this frame's global uniforms through the renderer's GpuFrameAllocator
       void updateGlobalUniforms(VkFrameInfo& frameInfo);
+
+      MeshVertexFormat getVertexFormat() const { return this->vertexFormat; }
     private:
       void init();
     private:
       RenderPass& renderPass;
+      MeshVertexFormat vertexFormat;
+      bool afterDepthPrepass;
       Ref<DescriptorPool> globalDescriptorPool;
       Ref<DescriptorSetLayout> globalDescriptorSetLayout;
-      std::vector<VkDescriptorSet> globalDescriptorSets;
-      UniformBuffer<GlobalUbo> ubo;
+      VkDescriptorSet globalDescriptorSet = VK_NULL_HANDLE;
+      uint32_t globalUniformOffset = 0;
     };
   }
 };
\ No newline at end of file
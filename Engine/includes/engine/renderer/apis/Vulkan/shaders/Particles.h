@@ -0,0 +1,46 @@
+#pragma once
+
+#include "defines.h"
+
+#include <string_view>
+
+namespace Engine::Renderers::Vulkan {
+  class Renderer;
+  namespace Shaders {
+    // Compute pipelines of the particle system, one per kernel. See ParticleSystem
+    class Particles : public Base {
+    public:
+      enum class Kernel : uint8_t {
+        // fills the dead list with every particle
+        Reset,
+        // clamps the emission to the dead particles and prepares the indirect arguments
+        Kickoff,
+        Emit,
+        // integrates, compacts the alive list and writes the billboard instances
+        Simulate
+      };
+      static constexpr std::string_view GetStagesName(Kernel kernel) {
+        switch (kernel) {
+          case Kernel::Reset: return "builtin.particles.reset";
+          case Kernel::Kickoff: return "builtin.particles.kickoff";
+          case Kernel::Emit: return "builtin.particles.emit";
+          case Kernel::Simulate: return "builtin.particles.simulate";
+        }
+        return "";
+      }
+      // must match local_size_x
+      static constexpr uint32_t GroupSize = 64;
+
+      Particles(Renderer& ctx, Kernel kernel, VkDescriptorSetLayout descriptorSetLayout, uint32_t pushConstantsSize);
+      ~Particles() = default;
+
+      Particles(const Particles&) = delete;
+      Particles& operator=(const Particles&) = delete;
+
+      // binds the pipeline only, the particle set is bound by ParticleSystem
+      void use(VkFrameInfo& frameInfo) override;
+    private:
+      void init(VkDescriptorSetLayout descriptorSetLayout, uint32_t pushConstantsSize);
+    };
+  }
+};
@@ -10,7 +10,8 @@ namespace Engine::Renderers::Vulkan::Shaders {
   class Base;
   enum class StageType {
     Vertex,
-    Fragment
+    Fragment,
+    Compute
   };
 
   class Stage {
@@ -9,6 +9,8 @@
 #include <vector>
 
 namespace Engine {
+  class Camera;
+  struct FrameInfo;
   class Entity;
   class Scene {
   public:
@@ -24,6 +26,9 @@ namespace Engine {
     bool entityExists(entt::entity id) const;
     bool entityExists(uint64_t uuid) const;
 
+    // Draws every mesh component at the lod matching its projected size, must be called between beginFrame and endFrame
+    void render(const Camera& camera, FrameInfo& frameInfo);
+
     entt::registry& getRegistry() { return this->registry; }
     const entt::registry& getRegistry() const { return this->registry; }
 
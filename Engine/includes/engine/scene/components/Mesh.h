@@ -1,18 +1,22 @@
 #pragma once
 
-#include <glm/glm.hpp>
-#include <memory>
+#include <engine/renderer/Mesh.h>
+#include <engine/utils/memory.h>
 
 namespace Engine::Components {
-  // struct Mesh {  
-  //   Mesh() = default;
-  //   Mesh(const Mesh&) = default;
-  //   Mesh& operator=(const Mesh&) = default;
-  //   Mesh(std::shared_ptr<Renderer::Model> model) : model(model) {}
-  //   Mesh(std::unique_ptr<Renderer::Model>& model) : model(std::move(model)) {}
-  //   Mesh(std::shared_ptr<Renderer::Model> model, const glm::vec3& color) : model(model), color(color) {}
+  struct Mesh {
+    Mesh() = default;
+    Mesh(const Mesh&) = default;
+    Mesh& operator=(const Mesh&) = default;
+    ~Mesh() = default;
 
-  //   std::shared_ptr<Renderer::Model> model;
-  //   glm::vec3 color{ 1.0f, 1.0f, 1.0f };
-  // };
+    Mesh(Ref<Engine::Mesh> mesh) : mesh(mesh) {}
+    Mesh(Ref<Engine::Mesh> mesh, float lodPixelError) : mesh(mesh), lodPixelError(lodPixelError) {}
+
+    Ref<Engine::Mesh> mesh;
+    // screen space error tolerated when picking the lod, higher values switch to coarser lods sooner
+    float lodPixelError = Engine::Mesh::DefaultLodPixelError;
+    // never moves, its shadow is cached in the far shadow cascades and only there
+    bool isStatic = false;
+  };
 }
\ No newline at end of file
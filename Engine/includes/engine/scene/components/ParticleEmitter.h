@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Engine::Components {
+  // Spawns particles simulated and drawn on the GPU, at the entity's position
+  struct ParticleEmitter {
+    ParticleEmitter() = default;
+    ParticleEmitter(const ParticleEmitter&) = default;
+    ParticleEmitter& operator=(const ParticleEmitter&) = default;
+    ~ParticleEmitter() = default;
+
+    ParticleEmitter(float rate, glm::vec3 velocity, glm::vec4 color) : rate(rate), velocity(velocity), startColor(color), endColor(glm::vec4{ glm::vec3{ color }, 0.f }) {}
+
+    // particles per second
+    float rate = 100.f;
+    bool emitting = true;
+    // radius of the sphere particles spawn in
+    float radius = 0.f;
+    // seconds, picked uniformly in [x, y] for each particle
+    glm::vec2 lifetime{ 1.f, 2.f };
+    glm::vec3 velocity{ 0.f, 1.f, 0.f };
+    // half angle in radians of the cone around velocity the initial directions are picked in
+    float spread = .25f;
+    glm::vec3 acceleration{ 0.f, -9.81f, 0.f };
+    // interpolated over the particle's lifetime
+    glm::vec4 startColor{ 1.f };
+    glm::vec4 endColor{ 1.f, 1.f, 1.f, 0.f };
+    float startSize = .1f;
+    float endSize = .05f;
+    bool rounded = true;
+
+    // fraction of a particle carried over to the next frame
+    float emitAccumulator = 0.f;
+  };
+}
@@ -7,14 +7,16 @@
 #include "RigidBody2D.h"
 #include "Billboard.h"
 #include "Lights.h"
+#include "ParticleEmitter.h"
 
 namespace Engine {
   using IDComponent = Components::ID;
   using TransformComponent = Components::Transform;
-  // using MeshComponent = Components::Mesh;
+  using MeshComponent = Components::Mesh;
   using CameraComponent = Components::Camera;
   using RigidBody2DComponent = Components::RigidBody2D;
   using BillboardComponent = Components::Billboard;
   using PointLightComponent = Components::PointLight;
   using GlobalLightComponent = Components::GlobalLight;
+  using ParticleEmitterComponent = Components::ParticleEmitter;
 }
\ No newline at end of file
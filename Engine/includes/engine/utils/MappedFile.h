@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace Engine {
+  // Read-only memory mapping of a whole file.
+  // Lets cooked assets be consumed straight from the page cache without an intermediate copy.
+  class MappedFile {
+  public:
+    MappedFile() = default;
+    MappedFile(const std::string_view path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string_view path);
+    void close();
+
+    bool isOpen() const { return this->ptr != nullptr; }
+    const uint8_t* getData() const { return this->ptr; }
+    size_t getSize() const { return this->length; }
+
+    template <typename T>
+    const T* as(size_t offset = 0) const {
+      if (offset + sizeof(T) > this->length)
+        return nullptr;
+      return reinterpret_cast<const T*>(this->ptr + offset);
+    }
+  private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+    const uint8_t* ptr = nullptr;
+    size_t length = 0;
+  };
+}
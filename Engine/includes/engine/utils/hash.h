@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string_view>
+#include <functional>
 
 namespace Engine {
   constexpr size_t Hash(const std::string_view str) {
@@ -10,7 +10,9 @@ project "Engine"
   files {
     "includes/**.h",
     "src/**.cpp",
-    "%{Vendors.ImGuizmo:getPath()}/ImGuizmo.cpp"
+    "%{Vendors.ImGuizmo:getPath()}/ImGuizmo.cpp",
+    "%{Vendors.ImGui:getPath()}/backends/imgui_impl_glfw.cpp",
+    "%{Vendors.ImGui:getPath()}/backends/imgui_impl_vulkan.cpp"
   }
 
   defines {
@@ -29,7 +31,8 @@ project "Engine"
     "%{Vendors.entt.shared.include}",
     "%{Vendors.yaml_cpp.shared.include}",
     "%{Vendors.Vulkan.shared.include}",
-    "%{Vendors.stb_image.shared.include}"
+    "%{Vendors.stb_image.shared.include}",
+    "%{Vendors.tinyobjloader.shared.include}"
   }
 
   links {
@@ -70,7 +73,7 @@ project "Engine"
     symbols "on"
 
 
-  filter "configurations:Release"
+  filter "configurations:Release or Profile"
     defines "_RELEASE"
     runtime "Release"
     optimize "on"
@@ -1,8 +1,13 @@
 #include "engine/core/Application.h"
 #include <engine/utils/logger.h>
 #include <engine/input/InputManager.h>
+#include <engine/core/Profiler.h>
+#include <engine/core/MemoryTracker.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
+#include <format>
 
 #define BIND_EVENT_FN(fn, EventType) ([fn](Event&ev) {\
   auto& e = dynamic_cast<##EventType&>(ev);\
@@ -13,7 +18,7 @@ namespace Engine {
   Application* Application::s_instance = nullptr;
 
   Application::Application(const ApplicationInfo& info)
-    : spec(info), platform(info.windowInfo) {
+    : spec(ParseEarlyArgs(info)), platform(this->spec.windowInfo) {
     APP_ASSERT(!s_instance, "Application already exists!");
     s_instance = this;
 
@@ -43,6 +48,16 @@ namespace Engine {
     s_instance = nullptr;
   }
 
+  ApplicationInfo Application::ParseEarlyArgs(const ApplicationInfo& info) {
+    ApplicationInfo result = info;
+    // --headless: no window, frames are rendered to offscreen targets
+    for (uint32_t i = 1; i < info.args.count; i++) {
+      if (info.args[i] == "--headless")
+        result.windowInfo.headless = true;
+    }
+    return result;
+  }
+
   bool Application::init() {
     if (!this->platform.init()) {
       LOG_CRITICAL("Failed to initialize platform!");
@@ -54,9 +69,69 @@ namespace Engine {
       LOG_CRITICAL("Failed to create renderer!");
       return false;
     }
+    // --record <log> / --replay <log> / --frames <count> / --capture <directory> / --gpu-csv <file> / --trace <file>
+    // --depth-prepass <on|off>
+    for (uint32_t i = 1; i + 1 < this->spec.args.count; i++) {
+      if (this->spec.args[i] == "--record")
+        this->getInputManager().startRecording(this->spec.args[++i]);
+      else if (this->spec.args[i] == "--replay")
+        this->getInputManager().startReplay(this->spec.args[++i]);
+      else if (this->spec.args[i] == "--frames")
+        this->frameLimit = std::strtoull(this->spec.args[++i].data(), nullptr, 10);
+      else if (this->spec.args[i] == "--capture") {
+        this->captureDirectory = this->spec.args[++i];
+        std::filesystem::create_directories(this->captureDirectory);
+      }
+      else if (this->spec.args[i] == "--gpu-csv") {
+        this->gpuTimingsCsv.open(std::string(this->spec.args[++i]));
+        this->gpuTimingsCsv << "frame,scope,parent,depth,ms\n";
+      }
+      else if (this->spec.args[i] == "--trace")
+        this->tracePath = this->spec.args[++i];
+      else if (this->spec.args[i] == "--depth-prepass")
+        this->renderer->setDepthPrepass(this->spec.args[++i] == "on");
+    }
+    if (this->spec.windowInfo.headless)
+      LOG_APP_INFO("Running headless");
+    else if (this->spec.imgui) {
+      this->imguiLayer = this->layersManager.pushOverlay<ImGuiLayer>();
+      if (!this->imguiLayer->isEnabled()) {
+        this->layersManager.popOverlay(this->imguiLayer);
+        this->imguiLayer = nullptr;
+      }
+    }
     return true;
   }
 
+  void Application::onReplayFinished() {
+    this->getInputManager().stopReplay();
+    this->running = false;
+    if (this->replayFrameTimes.empty())
+      return;
+    auto& times = this->replayFrameTimes;
+    std::sort(times.begin(), times.end());
+    float total = 0.f;
+    for (float time : times)
+      total += time;
+    auto percentile = [&times](float p) { return times[static_cast<size_t>(p * (times.size() - 1))]; };
+    LOG_APP_INFO(
+      "Replay finished: {} frames, avg {:.3f}ms, p50 {:.3f}ms, p95 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms",
+      times.size(), total / times.size(), percentile(.5f), percentile(.95f), percentile(.99f), times.back()
+    );
+    times.clear();
+  }
+
+  void Application::writeGpuTimings() {
+    auto& timings = this->renderer->getGpuTimings();
+    if (timings.frame == this->lastGpuTimingsFrame || timings.scopes.empty())
+      return;
+    this->lastGpuTimingsFrame = timings.frame;
+    for (auto& scope : timings.scopes) {
+      std::string_view parent = scope.parent < 0 ? "" : timings.scopes[scope.parent].name;
+      this->gpuTimingsCsv << std::format("{},{},{},{},{:.4f}\n", timings.frame, scope.name, parent, scope.depth, scope.milliseconds);
+    }
+  }
+
   void Application::onUpdate(DeltaTime dt) {
     this->layersManager.onUpdate(dt);
   }
@@ -71,10 +146,14 @@ namespace Engine {
   }
 
   void Application::run() {
+    PROFILE_THREAD("Main");
     this->running = true;
     auto lastTime = std::chrono::high_resolution_clock::now();
 
     while (this->running) {
+      PROFILE_SCOPE("Frame");
+      MemoryTracker::NewFrame();
+      this->frameAllocator.newFrame();
       this->platform.update();
       this->eventSystem.dispatchQueue();
       if (this->suspended) {
@@ -84,6 +163,16 @@ namespace Engine {
       auto now = std::chrono::high_resolution_clock::now();
       DeltaTime dt = std::chrono::duration<float, std::chrono::seconds::period>(now - lastTime).count();
       lastTime = now;
+      auto& input = this->getInputManager();
+      if (input.isReplaying()) {
+        if (input.isReplayFinished()) {
+          this->onReplayFinished();
+          continue;
+        }
+        // measured time, the simulation itself advances by the recorded delta
+        this->replayFrameTimes.push_back(dt.asMilliseconds());
+      }
+      input.onFrame(dt);
       // script updates
       this->onUpdate(dt);
       FrameInfo frameInfo{
@@ -93,11 +182,26 @@ namespace Engine {
       this->onBeginFrame(frameInfo);
       if (!this->renderer->beginFrame(frameInfo))
         continue;
+      if (!this->captureDirectory.empty())
+        this->renderer->captureFrame(std::format("{}/frame_{:05}.png", this->captureDirectory, this->frameCount));
+      if (this->imguiLayer)
+        this->imguiLayer->begin();
       // frame render
       this->onRender(frameInfo);
+      if (this->imguiLayer) {
+        this->layersManager.onImGuiRender();
+        this->imguiLayer->end();
+      }
       // end frame
       this->renderer->endFrame(frameInfo);
       this->onEndFrame(frameInfo);
+      if (this->gpuTimingsCsv.is_open())
+        this->writeGpuTimings();
+      this->frameCount++;
+      if (this->frameLimit && this->frameCount >= this->frameLimit)
+        this->running = false;
     }
+    if (!this->tracePath.empty())
+      Profiler::ExportChromeTrace(this->tracePath);
   }
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "engine/core/FrameAllocator.h"
+#include <engine/utils/logger.h>
+
+#include <algorithm>
+
+using Engine::FrameAllocator;
+
+FrameAllocator* FrameAllocator::instance = nullptr;
+
+FrameAllocator::FrameAllocator(size_t blockSize) : blockSize(blockSize) {
+  if (instance) {
+    LOG_ERROR("FrameAllocator already exists");
+    return;
+  }
+  instance = this;
+}
+
+FrameAllocator::~FrameAllocator() {
+  if (instance == this)
+    instance = nullptr;
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment) {
+  auto& buffer = this->buffers[this->current];
+  while (buffer.block < buffer.blocks.size()) {
+    auto& block = buffer.blocks[buffer.block];
+    auto base = reinterpret_cast<uintptr_t>(block.data.get());
+    size_t offset = ((base + buffer.offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+    if (offset + size <= block.size) {
+      buffer.used += offset + size - buffer.offset;
+      buffer.offset = offset + size;
+      return block.data.get() + offset;
+    }
+    buffer.block++;
+    buffer.offset = 0;
+  }
+  Block block{};
+  block.size = std::max(this->blockSize, size + alignment);
+  block.data = MakeScope<std::byte[]>(block.size);
+  buffer.blocks.push_back(std::move(block));
+  buffer.block = buffer.blocks.size() - 1;
+  buffer.offset = 0;
+  return this->allocate(size, alignment);
+}
+
+void FrameAllocator::reset(Buffer& buffer) {
+  // overflowed last time, a single block of the total size serves the next frames
+  if (buffer.blocks.size() > 1) {
+    size_t size = 0;
+    for (auto& block : buffer.blocks)
+      size += block.size;
+    buffer.blocks.clear();
+    Block block{};
+    block.size = size;
+    block.data = MakeScope<std::byte[]>(size);
+    buffer.blocks.push_back(std::move(block));
+  }
+  buffer.block = 0;
+  buffer.offset = 0;
+  buffer.used = 0;
+}
+
+void FrameAllocator::newFrame() {
+  this->peakBytes = std::max(this->peakBytes, this->buffers[this->current].used);
+  this->current = (this->current + 1) % FrameCount;
+  this->reset(this->buffers[this->current]);
+  this->frame++;
+}
@@ -1,6 +1,7 @@
 #include "engine/core/LayersManager.h"
 #include "renderer/FrameInfo.h"
 #include <engine/utils/logger.h>
+#include <engine/core/Profiler.h>
 
 using Engine::LayersManager;
 
@@ -51,17 +52,26 @@ bool LayersManager::popOverlay(Ref<AppLayer> overlay) {
 }
 
 void LayersManager::onUpdate(DeltaTime dt) {
+  PROFILE_SCOPE("LayersManager::onUpdate");
   this->onUpdateCallback(dt);
 }
 
 void LayersManager::onRender(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("LayersManager::onRender");
   this->onRenderCallback(frameInfo);
 }
 
 void LayersManager::onBeginFrame(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("LayersManager::onBeginFrame");
   this->onBeginFrameCallback(frameInfo);
 }
 
 void LayersManager::onEndFrame(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("LayersManager::onEndFrame");
   this->onEndFrameCallback(frameInfo);
+}
+
+void LayersManager::onImGuiRender() {
+  PROFILE_SCOPE("LayersManager::onImGuiRender");
+  this->onImGuiRenderCallback();
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "engine/core/MemoryTracker.h"
+#include <engine/utils/logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+using Engine::MemoryTracker;
+using Engine::MemoryTag;
+
+namespace {
+  // one cache line per tag, allocating threads only touch their tag's counters
+  struct alignas(64) TagCounters {
+    std::atomic<uint64_t> liveBytes{ 0 };
+    std::atomic<uint64_t> peakBytes{ 0 };
+    std::atomic<uint64_t> frameAllocations{ 0 };
+    std::atomic<uint64_t> frameBytes{ 0 };
+    uint64_t budget = 0;
+    bool overBudget = false;
+  };
+  // constant initialized, usable by allocations made before main
+  TagCounters Counters[MemoryTracker::TagCount];
+  thread_local MemoryTag CurrentTag = MemoryTag::Untagged;
+
+  struct FrameClock {
+    MemoryTracker::FrameStats last{};
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  };
+  FrameClock& GetFrameClock() {
+    static FrameClock clock;
+    return clock;
+  }
+}
+
+std::string_view MemoryTracker::GetTagName(MemoryTag tag) {
+  switch (tag) {
+    case MemoryTag::Untagged: return "Untagged";
+    case MemoryTag::Renderer: return "Renderer";
+    case MemoryTag::Scene: return "Scene";
+    case MemoryTag::Events: return "Events";
+    case MemoryTag::Assets: return "Assets";
+    default: return "Unknown";
+  }
+}
+
+MemoryTag MemoryTracker::GetThreadTag() {
+  return CurrentTag;
+}
+
+MemoryTag MemoryTracker::SetThreadTag(MemoryTag tag) {
+  MemoryTag previous = CurrentTag;
+  CurrentTag = tag;
+  return previous;
+}
+
+void MemoryTracker::OnAllocate(MemoryTag tag, size_t size) {
+  auto& counters = Counters[static_cast<size_t>(tag)];
+  uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+  counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+  counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnFree(MemoryTag tag, size_t size) {
+  Counters[static_cast<size_t>(tag)].liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void MemoryTracker::NewFrame() {
+  auto& clock = GetFrameClock();
+  auto now = std::chrono::steady_clock::now();
+  FrameStats stats{};
+  stats.frame = clock.last.frame + 1;
+  stats.milliseconds = std::chrono::duration<float, std::milli>(now - clock.begin).count();
+  clock.begin = now;
+  for (size_t i = 0; i < TagCount; i++) {
+    auto& counters = Counters[i];
+    auto& tag = stats.tags[i];
+    tag.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    tag.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    tag.allocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+    tag.allocatedBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+    tag.bytesPerSecond = stats.milliseconds > 0.f ? tag.allocatedBytes * 1000.0 / stats.milliseconds : 0.0;
+    tag.budget = counters.budget;
+    stats.allocations += tag.allocations;
+    stats.allocatedBytes += tag.allocatedBytes;
+
+    // warns once per crossing instead of every frame
+    bool overBudget = counters.budget && tag.liveBytes > counters.budget;
+    if (overBudget && !counters.overBudget) {
+      LOG_WARN(
+        "MemoryTracker: {} uses {} bytes, over its {} bytes budget",
+        GetTagName(static_cast<MemoryTag>(i)), tag.liveBytes, counters.budget
+      );
+    }
+    counters.overBudget = overBudget;
+  }
+  clock.last = stats;
+}
+
+const MemoryTracker::FrameStats& MemoryTracker::GetLastFrame() {
+  return GetFrameClock().last;
+}
+
+uint64_t MemoryTracker::GetFrameAllocationCount() {
+  uint64_t count = 0;
+  for (auto& counters : Counters)
+    count += counters.frameAllocations.load(std::memory_order_relaxed);
+  return count;
+}
+
+uint64_t MemoryTracker::GetLiveBytes(MemoryTag tag) {
+  return Counters[static_cast<size_t>(tag)].liveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryTracker::GetPeakBytes(MemoryTag tag) {
+  return Counters[static_cast<size_t>(tag)].peakBytes.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, uint64_t bytes) {
+  auto& counters = Counters[static_cast<size_t>(tag)];
+  counters.budget = bytes;
+  counters.overBudget = false;
+}
+
+#ifdef ENABLE_MEMORY_TRACKING
+namespace {
+  // Sits right before every pointer returned by operator new
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AllocationHeader {
+    uint64_t size;
+    // distance from the malloc'ed block to the returned pointer, more than the header for over aligned allocations
+    uint32_t offset;
+    MemoryTag tag;
+  };
+
+  void* TrackedAllocate(size_t size, size_t alignment) {
+    alignment = std::max(alignment, alignof(AllocationHeader));
+    size_t padding = sizeof(AllocationHeader) + alignment - alignof(AllocationHeader);
+    auto* block = static_cast<std::byte*>(std::malloc(size + padding));
+    if (!block)
+      return nullptr;
+    auto address = reinterpret_cast<uintptr_t>(block + sizeof(AllocationHeader));
+    auto* result = reinterpret_cast<std::byte*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    auto* header = reinterpret_cast<AllocationHeader*>(result) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(result - block);
+    header->tag = CurrentTag;
+    MemoryTracker::OnAllocate(header->tag, size);
+    return result;
+  }
+
+  void* TrackedAllocateOrThrow(size_t size, size_t alignment) {
+    for (;;) {
+      if (void* result = TrackedAllocate(size, alignment))
+        return result;
+      auto handler = std::get_new_handler();
+      if (!handler)
+        throw std::bad_alloc();
+      handler();
+    }
+  }
+
+  void TrackedFree(void* pointer) {
+    if (!pointer)
+      return;
+    auto* header = static_cast<AllocationHeader*>(pointer) - 1;
+    MemoryTracker::OnFree(header->tag, header->size);
+    std::free(static_cast<std::byte*>(pointer) - header->offset);
+  }
+}
+
+void* operator new(size_t size) { return TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+#endif
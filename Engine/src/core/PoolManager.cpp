@@ -1,51 +1,182 @@
 #include "core/PoolManager.h"
 #include <utils/asserts.h>
+#include <utils/logger.h>
 #include <yaml-cpp/yaml.h>
 
+#include <algorithm>
+
 using namespace Engine;
 
-#ifdef _DEBUG
-PoolManager::Pool::Pool(std::string_view name, uint64_t size) : name(name), size(size) {
-  this->id = Hash(name);
+namespace Engine {
+  // Per thread free blocks of the pools with a thread cache, given back to their pool when the thread exits
+  struct PoolThreadCaches {
+    struct Cache {
+      std::array<void*, PoolManager::Pool::ThreadCacheSize> blocks{};
+      uint32_t count = 0;
+    };
+    std::array<Cache, PoolManager::PoolCount> caches{};
+
+    ~PoolThreadCaches() {
+      for (size_t i = 0; i < PoolManager::PoolCount; i++) {
+        auto& cache = this->caches[i];
+        if (!cache.count)
+          continue;
+        auto* pool = PoolManager::Get(static_cast<Pools>(i));
+        std::lock_guard lock(pool->mutex);
+        while (cache.count)
+          pool->pushFree(cache.blocks[--cache.count]);
+      }
+    }
+  };
+}
+
+namespace {
+  thread_local PoolThreadCaches ThreadCaches;
+}
+
+void PoolManager::Pool::configure(Pools id, uint64_t size, bool threadCache) {
+  this->id = id;
+  this->size = size;
+  this->threadCache = threadCache;
+}
+
+void PoolManager::Pool::addUsed(uint64_t amount) {
+  uint64_t used = this->used.fetch_add(amount, std::memory_order_relaxed) + amount;
+  uint64_t highWaterMark = this->highWaterMark.load(std::memory_order_relaxed);
+  while (used > highWaterMark && !this->highWaterMark.compare_exchange_weak(highWaterMark, used, std::memory_order_relaxed)) {}
 }
-#endif
-PoolManager::Pool::Pool(uint16_t id, uint64_t size) : id(id), size(size) {}
 
 bool PoolManager::Pool::fill(uint64_t amount) {
-  if (this->used + amount > this->size) {
-    ASSERT_MSG(false, "Pool {} is full", this->name);
+  if (this->getSize() + amount > this->size) {
+    ASSERT_MSG(false, "Pool {} is full", this->getName());
     return false;
   }
-  this->used += amount;
+  this->addUsed(amount);
   return true;
 }
 
 bool PoolManager::Pool::empty(uint64_t amount) {
-  if (this->used < amount) {
-    ASSERT_MSG(false, "Pool {} is empty", this->name);
+  if (this->getSize() < amount) {
+    ASSERT_MSG(false, "Pool {} is empty", this->getName());
     return false;
   }
-  this->used -= amount;
+  this->used.fetch_sub(amount, std::memory_order_relaxed);
+  return true;
+}
+
+bool PoolManager::Pool::createSlab(size_t blockSize, size_t alignment) {
+  // free blocks store the next free block in place
+  blockSize = std::max(blockSize, sizeof(void*));
+  blockSize = (blockSize + alignment - 1) / alignment * alignment;
+  this->slab = MakeScope<std::byte[]>(blockSize * this->size + alignment);
+  auto address = reinterpret_cast<uintptr_t>(this->slab.get());
+  this->blocks = this->slab.get() + (((address + alignment - 1) & ~(uintptr_t(alignment) - 1)) - address);
+  this->blockSize = blockSize;
+  // threaded back to front so blocks are handed out in address order
+  for (uint64_t i = this->size; i-- > 0;)
+    this->pushFree(this->blocks + i * blockSize);
+  LOG_INFO("Pool {} allocated {} blocks of {} bytes", this->getName(), this->size, blockSize);
   return true;
 }
 
+void* PoolManager::Pool::popFree() {
+  void* block = this->freeList;
+  if (block)
+    this->freeList = *static_cast<void**>(block);
+  return block;
+}
+
+void PoolManager::Pool::pushFree(void* block) {
+  *static_cast<void**>(block) = this->freeList;
+  this->freeList = block;
+}
+
+void* PoolManager::Pool::allocate(size_t blockSize, size_t alignment) {
+  if (this->size == 0)
+    return nullptr;
+  void* block = nullptr;
+  if (this->threadCache && this->blocks) {
+    auto& cache = ThreadCaches.caches[static_cast<size_t>(this->id)];
+    if (cache.count == 0) {
+      std::lock_guard lock(this->mutex);
+      while (cache.count < ThreadCacheSize / 2) {
+        void* free = this->popFree();
+        if (!free)
+          break;
+        cache.blocks[cache.count++] = free;
+      }
+    }
+    if (cache.count)
+      block = cache.blocks[--cache.count];
+  }
+  else {
+    std::lock_guard lock(this->mutex);
+    if (!this->blocks)
+      this->createSlab(blockSize, alignment);
+    block = this->popFree();
+  }
+  if (!block)
+    return nullptr;
+  this->addUsed(1);
+  if (blockSize > this->blockSize || reinterpret_cast<uintptr_t>(block) % alignment) {
+    LOG_ERROR("Pool {}: {} bytes blocks cannot hold a {} bytes object", this->getName(), this->blockSize, blockSize);
+    this->free(block);
+    return nullptr;
+  }
+  return block;
+}
+
+void PoolManager::Pool::free(void* block) {
+  if (!block)
+    return;
+  ASSERT_MSG(this->owns(block), "Pool {}: freeing a block it does not own", this->getName());
+  this->used.fetch_sub(1, std::memory_order_relaxed);
+  if (this->threadCache) {
+    auto& cache = ThreadCaches.caches[static_cast<size_t>(this->id)];
+    if (cache.count == ThreadCacheSize) {
+      std::lock_guard lock(this->mutex);
+      while (cache.count > ThreadCacheSize / 2)
+        this->pushFree(cache.blocks[--cache.count]);
+    }
+    cache.blocks[cache.count++] = block;
+    return;
+  }
+  std::lock_guard lock(this->mutex);
+  this->pushFree(block);
+}
+
+bool PoolManager::Pool::owns(const void* block) const {
+  auto* pointer = static_cast<const std::byte*>(block);
+  return this->blocks && pointer >= this->blocks && pointer < this->blocks + this->blockSize * this->size;
+}
+
 PoolManager PoolManager::instance;
 
+PoolManager::Pool* PoolManager::Get(std::string_view name) {
+  auto it = std::find(PoolNames.begin(), PoolNames.end(), name);
+  if (it == PoolNames.end())
+    return nullptr;
+  return &instance.pools[it - PoolNames.begin()];
+}
+
 bool PoolManager::Init() {
   if (instance.initialized)
     return false;
+  for (size_t i = 0; i < PoolCount; i++)
+    instance.pools[i].id = static_cast<Pools>(i);
   try {
     auto config = YAML::LoadFile(std::string{ PoolConfigFilePath });
-    for (const auto& pool : config["pools"]) {
-      auto name = pool["name"].as<std::string>();
-      auto id = Hash(name);
-      auto size = pool["size"].as<uint64_t>();
-#ifdef _DEBUG
-      instance.pools.emplace(id, Pool{ name, size });
+    for (const auto& entry : config["pools"]) {
+      auto name = entry["name"].as<std::string>();
+      auto* pool = Get(name);
+      if (!pool) {
+        LOG_WARN("Unknown pool {} in {}", name, PoolConfigFilePath);
+        continue;
+      }
+      auto size = entry["size"].as<uint64_t>();
+      bool threadCache = entry["threadCache"] && entry["threadCache"].as<bool>();
+      pool->configure(pool->id, size, threadCache);
       LOG_INFO("Pool {} initialized with size {}", name, size);
-#else
-      instance.pools.emplace(id, Pool{ id, size });
-#endif
     }
   }
   catch (const std::exception& e) {
@@ -54,4 +185,4 @@ bool PoolManager::Init() {
   }
   instance.initialized = true;
   return true;
-}
\ No newline at end of file
+}
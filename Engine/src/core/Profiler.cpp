@@ -0,0 +1,149 @@
+#include "engine/core/Profiler.h"
+#include <engine/utils/memory.h>
+#include <engine/utils/logger.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using Engine::Profiler;
+
+namespace {
+  struct ThreadRing {
+    Engine::Scope<Profiler::Zone[]> zones = Engine::MakeScope<Profiler::Zone[]>(Profiler::RingCapacity);
+    // total zones recorded, the ring holds the last RingCapacity ones
+    std::atomic<uint64_t> head{ 0 };
+    const char* name = nullptr;
+    uint32_t id = 0;
+  };
+
+  // rings outlive their threads so zones of finished threads can still be exported
+  struct Registry {
+    std::mutex mutex;
+    std::vector<Engine::Scope<ThreadRing>> rings;
+    // calibration point of the tick counter
+    uint64_t startTicks = Profiler::Now();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  };
+  Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+  }
+
+  // constant initialized, no guard on the recording path
+  thread_local ThreadRing* CurrentRing = nullptr;
+
+  ThreadRing& CreateThreadRing() {
+    auto& registry = GetRegistry();
+    std::lock_guard lock(registry.mutex);
+    auto& created = registry.rings.emplace_back(Engine::MakeScope<ThreadRing>());
+    created->id = static_cast<uint32_t>(registry.rings.size());
+    CurrentRing = created.get();
+    return *CurrentRing;
+  }
+
+  ThreadRing& GetThreadRing() {
+    return CurrentRing ? *CurrentRing : CreateThreadRing();
+  }
+
+  void WriteJsonString(std::ofstream& file, const char* text) {
+    file << '"';
+    for (const char* c = text; *c; c++) {
+      if (*c == '"' || *c == '\\')
+        file << '\\';
+      file << *c;
+    }
+    file << '"';
+  }
+}
+
+void Profiler::Record(const char* name, uint64_t begin, uint64_t end) {
+  auto& ring = GetThreadRing();
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  ring.zones[head & (RingCapacity - 1)] = { name, begin, end };
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name) {
+  GetThreadRing().name = name;
+}
+
+double Profiler::GetTickPeriod() {
+#ifdef PROFILER_RDTSC
+  auto& registry = GetRegistry();
+  uint64_t ticks = Now() - registry.startTicks;
+  double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - registry.startTime).count();
+  return ticks ? nanoseconds / ticks : 1.0;
+#else
+  return 1.0;
+#endif
+}
+
+void Profiler::CopyThreadZones(std::vector<Zone>& zones, size_t maxCount) {
+  auto& ring = GetThreadRing();
+  // only this thread writes the ring, no overwrite can happen while copying
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  uint64_t count = std::min<uint64_t>({ head, RingCapacity, maxCount });
+  zones.clear();
+  zones.reserve(count);
+  for (uint64_t i = head - count; i < head; i++)
+    zones.push_back(ring.zones[i & (RingCapacity - 1)]);
+}
+
+bool Profiler::ExportChromeTrace(std::string_view path) {
+  std::ofstream file{ std::string(path) };
+  if (!file) {
+    LOG_ERROR("Profiler: failed to open {}", path);
+    return false;
+  }
+  auto& registry = GetRegistry();
+  const double tickPeriod = GetTickPeriod();
+  std::lock_guard lock(registry.mutex);
+  uint64_t origin = UINT64_MAX;
+  std::vector<std::vector<Zone>> snapshots(registry.rings.size());
+  for (size_t r = 0; r < registry.rings.size(); r++) {
+    auto& ring = *registry.rings[r];
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t first = head > RingCapacity ? head - RingCapacity : 0;
+    auto& zones = snapshots[r];
+    zones.reserve(head - first);
+    for (uint64_t i = first; i < head; i++)
+      zones.push_back(ring.zones[i & (RingCapacity - 1)]);
+    // the owning thread may have lapped the oldest entries while they were copied
+    uint64_t overwritten = ring.head.load(std::memory_order_acquire);
+    overwritten = overwritten > RingCapacity ? overwritten - RingCapacity : 0;
+    if (overwritten > first)
+      zones.erase(zones.begin(), zones.begin() + std::min<uint64_t>(overwritten - first, zones.size()));
+    for (auto& zone : zones)
+      origin = std::min(origin, zone.begin);
+  }
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (size_t r = 0; r < registry.rings.size(); r++) {
+    auto& ring = *registry.rings[r];
+    if (ring.name) {
+      file << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring.id << ",\"args\":{\"name\":";
+      WriteJsonString(file, ring.name);
+      file << "}}";
+      first = false;
+    }
+    for (auto& zone : snapshots[r]) {
+      file << (first ? "" : ",") << "\n{\"ph\":\"X\",\"name\":";
+      WriteJsonString(file, zone.name);
+      // microseconds
+      file << ",\"pid\":1,\"tid\":" << ring.id
+        << ",\"ts\":" << (zone.begin - origin) * tickPeriod / 1000.0
+        << ",\"dur\":" << (zone.end - zone.begin) * tickPeriod / 1000.0
+        << "}";
+      first = false;
+    }
+  }
+  file << "\n]}\n";
+  LOG_INFO("Profiler: trace written to {}", path);
+  return file.good();
+}
@@ -1,27 +1,144 @@
 #include "events/EventSystem.h"
+#include <core/Profiler.h>
 
 using Engine::EventSystem;
+using Engine::EventType;
 
 EventSystem* EventSystem::instance = nullptr;
 
+EventType::ID EventType::Next() {
+  static std::atomic<ID> next{ 0 };
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
 EventSystem::EventSystem() {
+  MEMORY_TAG(Events);
   if (instance) {
     LOG_ERROR("EventSystem already exists");
     return;
   }
   instance = this;
+  this->postedEvents = MakeScope<PostedSlot[]>(PostedEventCapacity);
+  for (size_t i = 0; i < PostedEventCapacity; i++)
+    this->postedEvents[i].sequence.store(i, std::memory_order_relaxed);
 }
 
 EventSystem::~EventSystem() {
-  instance = nullptr;
+  for (auto& queued : this->eventQueue) {
+    if (queued.event)
+      queued.destroy(queued.event);
+  }
+  if (instance == this)
+    instance = nullptr;
 }
 
-uint32_t EventSystem::dispatchQueue() {
+void EventSystem::Channel::insert(EventListener&& listener) {
+  auto it = std::upper_bound(
+    this->listeners.begin(), this->listeners.end(), listener.priority,
+    [](uint8_t priority, const EventListener& other) { return priority > other.priority; }
+  );
+  this->listeners.insert(it, std::move(listener));
+}
+
+bool EventSystem::Channel::remove(uint32_t handle) {
+  auto matches = [handle](const EventListener& listener) { return listener.handle == handle && !listener.removed; };
+  auto pending = std::find_if(this->pendingListeners.begin(), this->pendingListeners.end(), matches);
+  if (pending != this->pendingListeners.end()) {
+    this->pendingListeners.erase(pending);
+    return true;
+  }
+  auto it = std::find_if(this->listeners.begin(), this->listeners.end(), matches);
+  if (it == this->listeners.end())
+    return false;
+  // the listener may be the one running, it is only destroyed once the channel is idle
+  if (this->dispatchDepth) {
+    it->removed = true;
+    this->hasRemovedListeners = true;
+  }
+  else {
+    this->listeners.erase(it);
+  }
+  return true;
+}
+
+bool EventSystem::Channel::dispatch(Event& event) {
+  bool handled = false;
+  this->dispatchDepth++;
+  // listeners added meanwhile are deferred, so the vector never reallocates under the loop
+  for (auto& listener : this->listeners) {
+    if (listener.removed)
+      continue;
+    handled |= (*listener.callback)(event);
+    if (event.handled)
+      break;
+  }
+  if (--this->dispatchDepth == 0) {
+    if (this->hasRemovedListeners) {
+      std::erase_if(this->listeners, [](const EventListener& listener) { return listener.removed; });
+      this->hasRemovedListeners = false;
+    }
+    for (auto& listener : this->pendingListeners)
+      this->insert(std::move(listener));
+    this->pendingListeners.clear();
+  }
+  return handled;
+}
+
+void* EventSystem::Arena::allocate(size_t size, size_t alignment) {
+  while (this->block < this->blocks.size()) {
+    auto& current = this->blocks[this->block];
+    size_t offset = (this->offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= current.size) {
+      this->offset = offset + size;
+      return current.data.get() + offset;
+    }
+    this->block++;
+    this->offset = 0;
+  }
+  // new blocks are only needed until the queue reaches its steady state size
+  Block block{};
+  block.size = std::max(ArenaBlockSize, size + alignment);
+  block.data = MakeScope<std::byte[]>(block.size);
+  this->blocks.push_back(std::move(block));
+  this->block = this->blocks.size() - 1;
+  this->offset = 0;
+  return this->allocate(size, alignment);
+}
+
+void EventSystem::Arena::reset() {
+  this->block = 0;
+  this->offset = 0;
+}
+
+uint32_t EventSystem::dispatchPosted() {
   uint32_t count = 0;
-  while (this->eventQueue.size()) {
-    auto event = std::move(this->eventQueue.front());
-    this->eventQueue.pop();
-    count += this->emit(*event);
+  // bounded so producers posting continuously cannot starve the frame
+  for (size_t i = 0; i < PostedEventCapacity; i++) {
+    auto& slot = this->postedEvents[this->postReadPosition & (PostedEventCapacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != this->postReadPosition + 1)
+      break;
+    count += slot.dispatch(*this, slot.storage);
+    slot.sequence.store(this->postReadPosition + PostedEventCapacity, std::memory_order_release);
+    this->postReadPosition++;
   }
   return count;
-}
\ No newline at end of file
+}
+
+uint32_t EventSystem::dispatchQueue() {
+  PROFILE_SCOPE("EventSystem::dispatchQueue");
+  uint32_t count = this->dispatchPosted();
+  // listeners may queue more events, indices stay valid while the vector grows
+  for (size_t i = 0; i < this->eventQueue.size(); i++) {
+    auto queued = this->eventQueue[i];
+    if (!queued.event)
+      continue;
+    this->eventQueue[i].event = nullptr;
+    count += queued.channel->dispatch(*queued.event);
+    queued.destroy(queued.event);
+  }
+  for (auto& [id, channel] : this->channels)
+    channel->queued.clear();
+  this->eventQueue.clear();
+  this->arena.reset();
+  return count;
+}
@@ -0,0 +1,55 @@
+#include "engine/imgui/ImGuiLayer.h"
+#include <engine/core/Application.h>
+#include <engine/core/Profiler.h>
+#include <engine/utils/logger.h>
+
+#include <imgui.h>
+#include <backends/imgui_impl_glfw.h>
+
+using Engine::ImGuiLayer;
+
+void ImGuiLayer::onAttach() {
+  auto& window = this->app.getWindow();
+  if (window.isHeadless())
+    return;
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  auto& io = ImGui::GetIO();
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+  io.IniFilename = nullptr;
+  ImGui::StyleColorsDark();
+  // chains to the callbacks already installed by the input manager
+  ImGui_ImplGlfw_InitForVulkan(static_cast<GLFWwindow*>(window.getHandle()), true);
+  if (!Renderer::Get()->initImGui()) {
+    LOG_ERROR("ImGuiLayer: renderer backend initialization failed");
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    return;
+  }
+  this->enabled = true;
+}
+
+void ImGuiLayer::onDetach() {
+  if (!this->enabled)
+    return;
+  Renderer::Get()->shutdownImGui();
+  ImGui_ImplGlfw_Shutdown();
+  ImGui::DestroyContext();
+  this->enabled = false;
+}
+
+void ImGuiLayer::begin() {
+  if (!this->enabled)
+    return;
+  PROFILE_SCOPE("ImGuiLayer::begin");
+  Renderer::Get()->beginImGuiFrame();
+  ImGui_ImplGlfw_NewFrame();
+  ImGui::NewFrame();
+}
+
+void ImGuiLayer::end() {
+  if (!this->enabled)
+    return;
+  PROFILE_SCOPE("ImGuiLayer::end");
+  ImGui::Render();
+}
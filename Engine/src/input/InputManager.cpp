@@ -3,6 +3,8 @@
 #include <GLFW/glfw3.h>
 #include <events/EventSystem.h>
 
+#include <chrono>
+
 using namespace Engine::Input;
 
 static inline InputManager* GetManager(GLFWwindow* window) {
@@ -13,39 +15,37 @@ static inline InputManager* GetManager(GLFWwindow* window) {
 void InputManager::GlfwKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
   (void)scancode;
   (void)mods;
-  auto manager = GetManager(window);
-
-  if (manager->keyboard.onEvent(key, action != GLFW_RELEASE))
-    EventSystem::Get()->emit<KeyEvent>(key, action != GLFW_RELEASE);
+  if (key < 0 || key > GLFW_KEY_LAST) return;
+  GetManager(window)->pushRawEvent(RawInputEvent::Type::Key, static_cast<uint16_t>(key), action != GLFW_RELEASE, {});
 }
 
 void InputManager::GlfwMouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
   (void)mods;
-  auto manager = GetManager(window);
-
-  if (manager->mouseButtons.onEvent(button, action != GLFW_RELEASE))
-    EventSystem::Get()->emit<MouseButtonEvent>(button, action != GLFW_RELEASE);
+  if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST) return;
+  GetManager(window)->pushRawEvent(RawInputEvent::Type::MouseButton, static_cast<uint16_t>(button), action != GLFW_RELEASE, {});
 }
 
 void InputManager::GlfwCursorPosCallback(GLFWwindow* window, double x, double y) {
-  auto manager = GetManager(window);
-  glm::vec2 position = { x, y };
-  if (position == manager->mouse.position) return;
-  manager->mouse.lastPosition = manager->mouse.position;
-  manager->mouse.position = { x, y };
-  manager->mouse.delta = manager->mouse.position - manager->mouse.lastPosition;
-  EventSystem::Get()->emit<MouseMoveEvent>(manager->mouse.position, manager->mouse.delta);
+  GetManager(window)->pushRawEvent(RawInputEvent::Type::MouseMove, 0, false, { x, y });
 }
 
 void InputManager::GlfwScrollCallback(GLFWwindow* window, double x, double y) {
-  auto manager = GetManager(window);
-
   // some mouse wheels report random offsets, so we clamp them to -1, 0, 1
   x = x < 0 ? -1 : x > 0 ? 1 : 0;
   y = y < 0 ? -1 : y > 0 ? 1 : 0;
   if (x == 0 && y == 0) return;
-  manager->mouse.scrollOffset = { x, y };
-  EventSystem::Get()->emit<MouseScrollEvent>(manager->mouse.scrollOffset);
+  GetManager(window)->pushRawEvent(RawInputEvent::Type::MouseScroll, 0, false, { x, y });
+}
+
+void InputManager::pushRawEvent(RawInputEvent::Type type, uint16_t code, bool pressed, glm::vec2 value) {
+  this->rawEvents.push_back({ type, pressed, code, value, GetTime() });
+}
+
+double InputManager::GetTime() {
+  // not glfwGetTime, headless applications never initialize GLFW but still record and replay
+  using Clock = std::chrono::steady_clock;
+  static const auto start = Clock::now();
+  return std::chrono::duration<double>(Clock::now() - start).count();
 }
 
 InputManager::InputManager(Platform& platform) : platform(platform) {
@@ -76,14 +76,111 @@ GLFWwindow* InputManager::getWindowHandle() {
 }
 
 void InputManager::init() {
+  if (this->platform.window->isHeadless())
+    return;
   this->bindCallbacks(this->getWindowHandle());
 }
 
 void InputManager::update() {
   this->keyboard.update();
   this->mouseButtons.update();
+  this->mouse.lastPosition = this->mouse.position;
   this->mouse.delta = { 0.0f, 0.0f };
   this->mouse.scrollOffset = { 0.0f, 0.0f };
+  // events received outside of a poll (e.g. while waiting on a minimized window) are kept for the next flush
+  // capacity is kept, the buffer stops allocating once it fits a busy frame
+  this->rawEvents.erase(this->rawEvents.begin(), this->rawEvents.begin() + this->flushedRawEvents);
+  this->flushedRawEvents = 0;
+}
+
+void InputManager::flush() {
+  auto* events = EventSystem::Get();
+  if (this->replay) {
+    // platform events are ignored so the session plays out exactly as recorded
+    this->rawEvents.clear();
+    this->replayFrameConsumed = this->replay->readFrame(this->replayDeltaTime, this->rawEvents);
+  }
+  bool moved = false;
+  for (const auto& raw : this->rawEvents) {
+    switch (raw.type) {
+    case RawInputEvent::Type::Key:
+      // press/release order matters, those are never coalesced
+      if (this->keyboard.onEvent(raw.code, raw.pressed))
+        events->emit<KeyEvent>(raw.code, raw.pressed);
+      break;
+    case RawInputEvent::Type::MouseButton:
+      if (this->mouseButtons.onEvent(raw.code, raw.pressed))
+        events->emit<MouseButtonEvent>(raw.code, raw.pressed);
+      break;
+    case RawInputEvent::Type::MouseMove:
+      moved |= raw.value != this->mouse.position;
+      this->mouse.position = raw.value;
+      break;
+    case RawInputEvent::Type::MouseScroll:
+      this->mouse.scrollOffset += raw.value;
+      break;
+    }
+  }
+  if (moved) {
+    this->mouse.delta = this->mouse.position - this->mouse.lastPosition;
+    events->emit<MouseMoveEvent>(this->mouse.position, this->mouse.delta);
+  }
+  if (this->mouse.scrollOffset != glm::vec2{ 0.0f })
+    events->emit<MouseScrollEvent>(this->mouse.scrollOffset);
+  if (this->rawInputEnabled && !this->rawEvents.empty())
+    events->emit<RawInputBatchEvent>(std::span<const RawInputEvent>{ this->rawEvents });
+  if (this->recorder)
+    this->recordedEvents.insert(this->recordedEvents.end(), this->rawEvents.begin(), this->rawEvents.end());
+  this->flushedRawEvents = this->rawEvents.size();
+}
+
+void InputManager::onFrame(DeltaTime& deltaTime) {
+  if (this->replay && this->replayFrameConsumed)
+    deltaTime = this->replayDeltaTime;
+  if (this->recorder) {
+    this->recorder->writeFrame(deltaTime, this->recordedEvents);
+    this->recordedEvents.clear();
+  }
+}
+
+bool InputManager::startRecording(const std::string_view path) {
+  if (this->replay) {
+    LOG_ERROR("Cannot record input while replaying");
+    return false;
+  }
+  auto recorder = MakeScope<InputRecorder>();
+  if (!recorder->open(path, GetTime()))
+    return false;
+  this->recorder = std::move(recorder);
+  this->recordedEvents.clear();
+  LOG_INFO("Recording input to {}", path);
+  return true;
+}
+
+void InputManager::stopRecording() {
+  if (!this->recorder)
+    return;
+  LOG_INFO("Recorded {} frames of input", this->recorder->getFrameCount());
+  this->recorder.reset();
+  this->recordedEvents.clear();
+}
+
+bool InputManager::startReplay(const std::string_view path) {
+  if (this->recorder) {
+    LOG_ERROR("Cannot replay input while recording");
+    return false;
+  }
+  auto replay = MakeScope<InputReplay>();
+  if (!replay->open(path, GetTime()))
+    return false;
+  this->replay = std::move(replay);
+  this->replayFrameConsumed = false;
+  return true;
+}
+
+void InputManager::stopReplay() {
+  this->replay.reset();
+  this->replayFrameConsumed = false;
 }
 
 void InputManager::bindCallbacks(GLFWwindow* window) {
@@ -100,10 +197,14 @@ static std::unordered_map<MouseMode, uint32_t> MouseModeMap = {
 };
 
 void InputManager::setMouseMode(MouseMode mode) {
-  glfwSetInputMode(this->getWindowHandle(), GLFW_CURSOR, static_cast<int>(MouseModeMap[mode]));
+  if (!this->platform.window->isHeadless())
+    glfwSetInputMode(this->getWindowHandle(), GLFW_CURSOR, static_cast<int>(MouseModeMap[mode]));
   this->mouse.mode = mode;
 }
 void InputManager::setMousePosition(glm::vec2 position) {
-  glfwSetCursorPos(this->getWindowHandle(), position.x, position.y);
+  if (!this->platform.window->isHeadless())
+    glfwSetCursorPos(this->getWindowHandle(), position.x, position.y);
+  // a warp is not a movement, the next frame's delta starts from here
   this->mouse.position = position;
+  this->mouse.lastPosition = position;
 }
\ No newline at end of file
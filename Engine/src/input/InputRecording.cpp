@@ -0,0 +1,121 @@
+#include "engine/input/InputRecording.h"
+#include <engine/utils/logger.h>
+
+#include <string>
+
+using Engine::Input::InputRecorder;
+using Engine::Input::InputReplay;
+using Engine::Input::InputLogHeader;
+using Engine::Input::InputLogFrame;
+using Engine::Input::InputLogEvent;
+
+InputRecorder::~InputRecorder() {
+  this->close();
+}
+
+bool InputRecorder::open(const std::string_view path, double startTime) {
+  this->close();
+  this->file.open(std::string{ path }, std::ios::binary | std::ios::trunc);
+  if (!this->file) {
+    LOG_ERROR("Failed to open input log {} for writing", path);
+    return false;
+  }
+  InputLogHeader header{};
+  this->file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  this->startTime = startTime;
+  this->frameCount = 0;
+  return true;
+}
+
+void InputRecorder::close() {
+  if (!this->file.is_open())
+    return;
+  // an interrupted recording keeps a zero frame count, replays recount the frames in that case
+  InputLogHeader header{};
+  header.frameCount = this->frameCount;
+  this->file.seekp(0);
+  this->file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  this->file.close();
+}
+
+void InputRecorder::writeFrame(float deltaTime, std::span<const RawInputEvent> events) {
+  this->buffer.clear();
+  for (const auto& event : events) {
+    InputLogEvent logged{};
+    logged.type = static_cast<uint8_t>(event.type);
+    logged.pressed = event.pressed;
+    logged.code = event.code;
+    logged.value[0] = event.value.x;
+    logged.value[1] = event.value.y;
+    logged.timestamp = static_cast<float>(event.timestamp - this->startTime);
+    this->buffer.push_back(logged);
+  }
+  InputLogFrame frame{ deltaTime, static_cast<uint32_t>(this->buffer.size()) };
+  this->file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+  this->file.write(reinterpret_cast<const char*>(this->buffer.data()), this->buffer.size() * sizeof(InputLogEvent));
+  this->frameCount++;
+}
+
+bool InputReplay::open(const std::string_view path, double startTime) {
+  this->close();
+  if (!this->file.open(path)) {
+    LOG_ERROR("Failed to open input log {}", path);
+    return false;
+  }
+  auto header = this->file.as<InputLogHeader>();
+  if (!header || header->magic != InputLogHeader::Magic || header->version != InputLogHeader::Version) {
+    LOG_ERROR("Invalid input log {}", path);
+    this->file.close();
+    return false;
+  }
+  this->offset = sizeof(InputLogHeader);
+  this->startTime = startTime;
+  this->frame = 0;
+  this->frameCount = header->frameCount;
+  if (this->frameCount == 0) {
+    // walk the frames, a truncated last frame is dropped
+    size_t offset = this->offset;
+    while (auto frame = this->file.as<InputLogFrame>(offset)) {
+      size_t next = offset + sizeof(InputLogFrame) + size_t(frame->eventCount) * sizeof(InputLogEvent);
+      if (next > this->file.getSize())
+        break;
+      offset = next;
+      this->frameCount++;
+    }
+  }
+  LOG_INFO("Replaying {} ({} frames)", path, this->frameCount);
+  return true;
+}
+
+void InputReplay::close() {
+  this->file.close();
+  this->offset = 0;
+  this->frame = 0;
+  this->frameCount = 0;
+}
+
+bool InputReplay::readFrame(float& deltaTime, std::vector<RawInputEvent>& out) {
+  if (this->isFinished())
+    return false;
+  auto frame = this->file.as<InputLogFrame>(this->offset);
+  if (!frame || this->offset + sizeof(InputLogFrame) + size_t(frame->eventCount) * sizeof(InputLogEvent) > this->file.getSize()) {
+    LOG_ERROR("Input log truncated at frame {}", this->frame);
+    this->frameCount = this->frame;
+    return false;
+  }
+  deltaTime = frame->deltaTime;
+  auto events = reinterpret_cast<const InputLogEvent*>(this->file.getData() + this->offset + sizeof(InputLogFrame));
+  for (uint32_t i = 0; i < frame->eventCount; i++) {
+    const auto& logged = events[i];
+    out.push_back({
+      static_cast<RawInputEvent::Type>(logged.type),
+      logged.pressed != 0,
+      logged.code,
+      { logged.value[0], logged.value[1] },
+      this->startTime + logged.timestamp
+    });
+  }
+  this->offset += sizeof(InputLogFrame) + size_t(frame->eventCount) * sizeof(InputLogEvent);
+  this->frame++;
+  return true;
+}
\ No newline at end of file
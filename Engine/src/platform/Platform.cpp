@@ -1,6 +1,7 @@
 #include "engine/platform/Platform.h"
 #include <engine/utils/logger.h>
 #include <engine/input/InputManager.h>
+#include <engine/core/Profiler.h>
 
 using Engine::Platform;
 
@@ -38,6 +39,8 @@ bool Platform::init() {
 }
 
 void Platform::update() {
+  PROFILE_SCOPE("Platform::update");
   this->input->update();
   this->window->pollEvents();
+  this->input->flush();
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ Window::Window(
 ) : platform(platform), spec(specs), size(specs.size), title(specs.title) {}
 
 Window::~Window() {
+  if (this->spec.headless)
+    return;
   if (!this->handle)
     return;
   glfwDestroyWindow(GLFW_WINDOW(this->handle));
@@ -22,22 +24,33 @@ Window::~Window() {
 }
 
 bool Window::shouldClose() const {
+  if (this->spec.headless)
+    return this->closeRequested;
   return glfwWindowShouldClose(GLFW_WINDOW(this->handle));
 }
 
 void Window::close() {
+  if (this->spec.headless) {
+    this->closeRequested = true;
+    return;
+  }
   glfwSetWindowShouldClose(GLFW_WINDOW(this->handle), GLFW_TRUE);
 }
 
 void Window::pollEvents() {
-  glfwPollEvents();
+  if (!this->spec.headless)
+    glfwPollEvents();
 }
 
 void Window::waitEvents() {
-  glfwWaitEvents();
+  if (!this->spec.headless)
+    glfwWaitEvents();
 }
 
 void Window::init() {
+  // GLFW is never initialized so no display server is required
+  if (this->spec.headless)
+    return;
   if (!glfwInit())
     throw std::runtime_error("Failed to initialize GLFW");
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
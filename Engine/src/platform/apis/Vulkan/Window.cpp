@@ -15,6 +15,8 @@ int Window::createVulkanSurface(void* ptr) {
 }
 
 std::vector<std::string_view> Window::getVulkanRequiredExtensions() {
+  if (this->isHeadless())
+    return {};
   uint32_t glfwExtensionCount = 0;
   const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
   ASSERT(glfwExtensions, "Failed to get GLFW required extensions!");
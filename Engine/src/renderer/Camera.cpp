@@ -29,6 +29,14 @@ void Camera::setViewportSize(uint32_t width, uint32_t height) {
   this->aspectRatio = static_cast<float>(width) / height;
   this->computeProjection();
 }
+float Camera::getPixelsPerUnit(float distance) const {
+  // projection[1][1] is 1 / tan(fov / 2) for perspective and 2 / size for orthographic projections
+  float pixelsPerUnit = glm::abs(this->projection[1][1]) * this->viewportSize.y * .5f;
+  if (this->projectionType == Projection::Perspective)
+    pixelsPerUnit /= glm::max(distance, this->perspectiveNearClip);
+  return pixelsPerUnit;
+}
+
 void Camera::computeProjection() {
   switch (this->projectionType) {
     case Projection::Perspective:
@@ -0,0 +1,132 @@
+#include "renderer/ImageWriter.h"
+#include <utils/logger.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using Engine::ImageWriter;
+using Engine::ImageFileFormat;
+
+namespace {
+  constexpr size_t MaxStoredBlockSize = 65535;
+
+  const std::array<uint32_t, 256>& CrcTable() {
+    static const auto table = [] {
+      std::array<uint32_t, 256> result{};
+      for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+          c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        result[n] = c;
+      }
+      return result;
+    }();
+    return table;
+  }
+
+  uint32_t Crc(uint32_t crc, const uint8_t* data, size_t size) {
+    auto& table = CrcTable();
+    for (size_t i = 0; i < size; i++)
+      crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+  }
+
+  void PushBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(uint8_t(value >> 24));
+    out.push_back(uint8_t(value >> 16));
+    out.push_back(uint8_t(value >> 8));
+    out.push_back(uint8_t(value));
+  }
+
+  void WriteChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> header;
+    PushBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+    uint32_t crc = Crc(0xFFFFFFFFu, header.data() + 4, 4);
+    crc = Crc(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+    std::vector<uint8_t> footer;
+    PushBigEndian(footer, crc);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+  }
+}
+
+ImageFileFormat ImageWriter::GetFormat(std::string_view path) {
+  return path.ends_with(".raw") ? ImageFileFormat::Raw : ImageFileFormat::Png;
+}
+
+bool ImageWriter::Write(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride) {
+  switch (GetFormat(path)) {
+    case ImageFileFormat::Raw: return WriteRaw(path, width, height, pixels, stride);
+    default: return WritePng(path, width, height, pixels, stride);
+  }
+}
+
+bool ImageWriter::WritePng(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride) {
+  std::ofstream file(std::string(path), std::ios::binary);
+  if (!file) {
+    LOG_ERROR("ImageWriter: failed to open {}", path);
+    return false;
+  }
+  static constexpr uint8_t Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  file.write(reinterpret_cast<const char*>(Signature), sizeof(Signature));
+
+  std::vector<uint8_t> header;
+  PushBigEndian(header, width);
+  PushBigEndian(header, height);
+  // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlace
+  header.insert(header.end(), { 8, 6, 0, 0, 0 });
+  WriteChunk(file, "IHDR", header);
+
+  // every scanline is prefixed by its filter type, 0 = none
+  const size_t rowSize = size_t(width) * 4;
+  std::vector<uint8_t> scanlines;
+  scanlines.reserve((rowSize + 1) * height);
+  for (uint32_t y = 0; y < height; y++) {
+    scanlines.push_back(0);
+    scanlines.insert(scanlines.end(), pixels + y * stride, pixels + y * stride + rowSize);
+  }
+
+  // zlib stream made of stored deflate blocks
+  std::vector<uint8_t> data;
+  data.reserve(scanlines.size() + scanlines.size() / MaxStoredBlockSize * 5 + 16);
+  data.push_back(0x78);
+  data.push_back(0x01);
+  size_t offset = 0;
+  do {
+    size_t size = std::min(MaxStoredBlockSize, scanlines.size() - offset);
+    bool last = offset + size == scanlines.size();
+    data.push_back(last ? 1 : 0);
+    data.push_back(uint8_t(size));
+    data.push_back(uint8_t(size >> 8));
+    data.push_back(uint8_t(~size));
+    data.push_back(uint8_t(~size >> 8));
+    data.insert(data.end(), scanlines.begin() + offset, scanlines.begin() + offset + size);
+    offset += size;
+  } while (offset < scanlines.size());
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : scanlines) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  PushBigEndian(data, (b << 16) | a);
+  WriteChunk(file, "IDAT", data);
+  WriteChunk(file, "IEND", {});
+  return file.good();
+}
+
+bool ImageWriter::WriteRaw(std::string_view path, uint32_t width, uint32_t height, const uint8_t* pixels, size_t stride) {
+  std::ofstream file(std::string(path), std::ios::binary);
+  if (!file) {
+    LOG_ERROR("ImageWriter: failed to open {}", path);
+    return false;
+  }
+  const size_t rowSize = size_t(width) * 4;
+  for (uint32_t y = 0; y < height; y++)
+    file.write(reinterpret_cast<const char*>(pixels + y * stride), rowSize);
+  return file.good();
+}
@@ -0,0 +1,46 @@
+#include "renderer/Mesh.h"
+#include <engine/renderer/apis/Vulkan/VulkanRenderer.h>
+#include <engine/renderer/Camera.h>
+
+using Engine::Mesh;
+using Engine::MeshData;
+
+void MeshData::computeBounds() {
+  if (this->vertices.empty()) {
+    this->bounds = {};
+    return;
+  }
+  this->bounds.min = this->bounds.max = this->vertices[0].position;
+  for (const auto& vertex : this->vertices) {
+    this->bounds.min = glm::min(this->bounds.min, vertex.position);
+    this->bounds.max = glm::max(this->bounds.max, vertex.position);
+  }
+}
+
+uint32_t Mesh::selectLod(const glm::mat4& model, const glm::vec3& cameraPosition, const Camera& camera, float maxPixelError) const {
+  uint32_t lodCount = this->getLodCount();
+  if (lodCount <= 1 || maxPixelError <= 0.f)
+    return 0;
+  const auto& bounds = this->getBounds();
+  // errors are measured in object space, scale them by the largest axis scale
+  float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+  glm::vec3 center = glm::vec3(model * glm::vec4(bounds.getCenter(), 1.f));
+  // distance to the bounding sphere so large meshes don't drop detail on their closest side
+  float distance = glm::length(center - cameraPosition) - bounds.getRadius() * scale;
+  float pixelsPerUnit = camera.getPixelsPerUnit(distance) * scale;
+  for (uint32_t lod = lodCount - 1; lod > 0; lod--) {
+    if (this->getLod(lod).error * pixelsPerUnit <= maxPixelError)
+      return lod;
+  }
+  return 0;
+}
+
+Engine::Ref<Mesh> Mesh::CreateFromFile(std::string_view path, MeshVertexFormat format) {
+  switch (Renderer::GetAPI()) {
+    case Renderer::API::Vulkan:
+      return Renderers::Vulkan::Renderer::Get()->createMesh(path, format);
+    default:
+      LOG_ERROR("Renderer API {} not supported", Renderer::GetApiName(Renderer::GetAPI()));
+      return nullptr;
+  }
+}
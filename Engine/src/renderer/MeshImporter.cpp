@@ -0,0 +1,321 @@
+#include "renderer/MeshImporter.h"
+#include "renderer/MeshOptimizer.h"
+#include "renderer/MeshSimplifier.h"
+#include <utils/logger.h>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <unordered_map>
+
+using Engine::MeshImporter;
+using Engine::MeshData;
+
+static std::string GetExtension(const std::string_view path) {
+  std::string extension = std::filesystem::path(path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+  return extension;
+}
+
+static constexpr uint64_t AlignSection(uint64_t offset) {
+  return (offset + 15) & ~uint64_t(15);
+}
+
+std::optional<MeshData> MeshImporter::Import(const std::string_view path) {
+  auto extension = GetExtension(path);
+  std::optional<MeshData> mesh;
+  if (extension == ".obj")
+    mesh = ImportObj(path);
+  else if (extension == ".gltf" || extension == ".glb")
+    mesh = ImportGltf(path);
+  else {
+    LOG_ERROR("Unsupported mesh format {} ({})", extension, path);
+    return std::nullopt;
+  }
+  if (!mesh)
+    return std::nullopt;
+  if (mesh->name.empty())
+    mesh->name = std::filesystem::path(path).stem().string();
+  mesh->computeBounds();
+  LOG_TRACE("Imported mesh {} ({} vertices, {} indices)", path, mesh->vertices.size(), mesh->indices.size());
+  return mesh;
+}
+
+std::vector<std::optional<MeshData>> MeshImporter::ImportAll(const std::vector<std::string>& paths) {
+  std::vector<std::future<std::optional<MeshData>>> jobs;
+  jobs.reserve(paths.size());
+  for (const auto& path : paths)
+    jobs.push_back(std::async(std::launch::async, [&path]() { return Import(path); }));
+
+  std::vector<std::optional<MeshData>> meshes;
+  meshes.reserve(paths.size());
+  for (auto& job : jobs)
+    meshes.push_back(job.get());
+  return meshes;
+}
+
+void MeshImporter::BuildIndexed(const std::vector<MeshVertex>& corners, MeshData& out) {
+  std::unordered_map<MeshVertex, uint32_t> uniqueVertices;
+  uniqueVertices.reserve(corners.size());
+  out.vertices.clear();
+  out.indices.clear();
+  out.vertices.reserve(corners.size() / 2);
+  out.indices.reserve(corners.size());
+  for (const auto& corner : corners) {
+    auto [it, inserted] = uniqueVertices.try_emplace(corner, static_cast<uint32_t>(out.vertices.size()));
+    if (inserted)
+      out.vertices.push_back(corner);
+    out.indices.push_back(it->second);
+  }
+  out.vertices.shrink_to_fit();
+}
+
+std::optional<MeshData> MeshImporter::ImportObj(const std::string_view path) {
+  tinyobj::ObjReaderConfig config;
+  config.triangulate = true;
+  config.vertex_color = true;
+  config.mtl_search_path = std::filesystem::path(path).parent_path().string();
+
+  tinyobj::ObjReader reader;
+  if (!reader.ParseFromFile(std::string{ path }, config)) {
+    LOG_ERROR("Failed to parse {}: {}", path, reader.Error());
+    return std::nullopt;
+  }
+  if (!reader.Warning().empty())
+    LOG_WARN("{}: {}", path, reader.Warning());
+
+  const auto& attrib = reader.GetAttrib();
+  const auto& shapes = reader.GetShapes();
+
+  size_t cornerCount = 0;
+  for (const auto& shape : shapes)
+    cornerCount += shape.mesh.indices.size();
+
+  std::vector<MeshVertex> corners;
+  corners.reserve(cornerCount);
+  for (const auto& shape : shapes) {
+    for (const auto& index : shape.mesh.indices) {
+      MeshVertex vertex{};
+      if (index.vertex_index >= 0) {
+        size_t i = static_cast<size_t>(index.vertex_index) * 3;
+        vertex.position = { attrib.vertices[i + 0], attrib.vertices[i + 1], attrib.vertices[i + 2] };
+        if (i + 2 < attrib.colors.size())
+          vertex.color = { attrib.colors[i + 0], attrib.colors[i + 1], attrib.colors[i + 2] };
+      }
+      if (index.normal_index >= 0) {
+        size_t i = static_cast<size_t>(index.normal_index) * 3;
+        vertex.normal = { attrib.normals[i + 0], attrib.normals[i + 1], attrib.normals[i + 2] };
+      }
+      if (index.texcoord_index >= 0) {
+        size_t i = static_cast<size_t>(index.texcoord_index) * 2;
+        // OBJ has the origin at the bottom left, vulkan samples from the top left
+        vertex.uv = { attrib.texcoords[i + 0], 1.f - attrib.texcoords[i + 1] };
+      }
+      corners.push_back(vertex);
+    }
+  }
+
+  MeshData mesh;
+  if (shapes.size() == 1)
+    mesh.name = shapes[0].name;
+  BuildIndexed(corners, mesh);
+  return mesh;
+}
+
+static glm::vec2 OctahedronEncode(glm::vec3 n) {
+  n /= glm::abs(n.x) + glm::abs(n.y) + glm::abs(n.z);
+  glm::vec2 encoded{ n.x, n.y };
+  if (n.z < 0.f) {
+    glm::vec2 sign{ n.x >= 0.f ? 1.f : -1.f, n.y >= 0.f ? 1.f : -1.f };
+    encoded = (1.f - glm::abs(glm::vec2{ n.y, n.x })) * sign;
+  }
+  return encoded;
+}
+
+std::vector<Engine::PackedMeshVertex> MeshImporter::PackVertices(const MeshData& mesh) {
+  glm::vec3 extent = mesh.bounds.max - mesh.bounds.min;
+  // flat meshes have a zero extent on one axis, every vertex quantizes to 0 there
+  glm::vec3 invExtent{
+    extent.x > 0.f ? 1.f / extent.x : 0.f,
+    extent.y > 0.f ? 1.f / extent.y : 0.f,
+    extent.z > 0.f ? 1.f / extent.z : 0.f
+  };
+  std::vector<PackedMeshVertex> packed(mesh.vertices.size());
+  for (size_t i = 0; i < mesh.vertices.size(); i++) {
+    const auto& vertex = mesh.vertices[i];
+    auto& out = packed[i];
+
+    glm::vec3 position = glm::clamp((vertex.position - mesh.bounds.min) * invExtent, 0.f, 1.f);
+    for (int c = 0; c < 3; c++)
+      out.position[c] = static_cast<uint16_t>(std::lround(position[c] * 65535.f));
+    out.position[3] = 0;
+
+    glm::vec2 normal{ 0.f };
+    if (glm::length(vertex.normal) > 0.f)
+      normal = OctahedronEncode(glm::normalize(vertex.normal));
+    for (int c = 0; c < 2; c++)
+      out.normal[c] = static_cast<int16_t>(std::lround(glm::clamp(normal[c], -1.f, 1.f) * 32767.f));
+
+    out.uv[0] = glm::packHalf1x16(vertex.uv.x);
+    out.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+    for (int c = 0; c < 3; c++)
+      out.color[c] = static_cast<uint8_t>(std::lround(glm::clamp(vertex.color[c], 0.f, 1.f) * 255.f));
+    out.color[3] = 255;
+  }
+  return packed;
+}
+
+bool MeshImporter::WriteCooked(const MeshData& mesh, const std::string_view path, MeshVertexFormat format) {
+  std::vector<PackedMeshVertex> packedVertices;
+  const void* vertexData = mesh.vertices.data();
+  MeshFileHeader header{};
+  header.vertexFormat = format;
+  header.vertexStride = sizeof(MeshVertex);
+  if (format == MeshVertexFormat::Packed) {
+    packedVertices = PackVertices(mesh);
+    vertexData = packedVertices.data();
+    header.vertexStride = sizeof(PackedMeshVertex);
+  }
+  header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+  header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  header.bounds = mesh.bounds;
+  header.vertexDataOffset = AlignSection(sizeof(MeshFileHeader));
+  header.indexDataOffset = AlignSection(header.vertexDataOffset + uint64_t(header.vertexStride) * header.vertexCount);
+  header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+  header.lodDataOffset = AlignSection(header.indexDataOffset + uint64_t(header.indexCount) * sizeof(uint32_t));
+
+  // write to a temporary file first so a crash never leaves a truncated cooked file behind
+  std::string tmpPath = std::string{ path } + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      LOG_ERROR("Failed to open {} for writing", tmpPath);
+      return false;
+    }
+    static constexpr char padding[16] = {};
+    auto pad = [&file](uint64_t target) {
+      auto current = static_cast<uint64_t>(file.tellp());
+      file.write(padding, static_cast<std::streamsize>(target - current));
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(header.vertexDataOffset);
+    file.write(reinterpret_cast<const char*>(vertexData), uint64_t(header.vertexStride) * header.vertexCount);
+    pad(header.indexDataOffset);
+    file.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t));
+    if (!mesh.lods.empty()) {
+      pad(header.lodDataOffset);
+      file.write(reinterpret_cast<const char*>(mesh.lods.data()), mesh.lods.size() * sizeof(MeshLod));
+    }
+    if (!file) {
+      LOG_ERROR("Failed to write cooked mesh {}", tmpPath);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    LOG_ERROR("Failed to move cooked mesh to {}: {}", path, ec.message());
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  return true;
+}
+
+bool MeshImporter::ReadCooked(const MappedFile& file, CookedMesh& out) {
+  auto header = file.as<MeshFileHeader>();
+  if (!header || header->magic != MeshFileHeader::Magic) {
+    LOG_ERROR("Invalid cooked mesh: bad magic");
+    return false;
+  }
+  if (header->version != MeshFileHeader::Version) {
+    LOG_ERROR("Invalid cooked mesh: version {} (expected {})", header->version, MeshFileHeader::Version);
+    return false;
+  }
+  uint64_t vertexBytes = uint64_t(header->vertexStride) * header->vertexCount;
+  uint64_t indexBytes = uint64_t(header->indexCount) * sizeof(uint32_t);
+  uint64_t lodBytes = uint64_t(header->lodCount) * sizeof(MeshLod);
+  if (
+    header->vertexDataOffset + vertexBytes > file.getSize() ||
+    header->indexDataOffset + indexBytes > file.getSize() ||
+    header->lodDataOffset + lodBytes > file.getSize()
+  ) {
+    LOG_ERROR("Invalid cooked mesh: truncated file");
+    return false;
+  }
+  out.header = header;
+  out.vertices = file.getData() + header->vertexDataOffset;
+  out.indices = reinterpret_cast<const uint32_t*>(file.getData() + header->indexDataOffset);
+  out.lods = header->lodCount ? reinterpret_cast<const MeshLod*>(file.getData() + header->lodDataOffset) : nullptr;
+  for (uint32_t i = 0; i < header->lodCount; i++) {
+    if (uint64_t(out.lods[i].firstIndex) + out.lods[i].indexCount > header->indexCount) {
+      LOG_ERROR("Invalid cooked mesh: lod {} out of the index buffer", i);
+      return false;
+    }
+  }
+  // the indices are uploaded as is, a corrupt one would read past the vertex buffer
+  for (uint32_t i = 0; i < header->indexCount; i++) {
+    if (out.indices[i] >= header->vertexCount) {
+      LOG_ERROR("Invalid cooked mesh: index {} out of the vertex buffer", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MeshImporter::IsCooked(const std::string_view path) {
+  return GetExtension(path) == CookedExtension;
+}
+
+std::string MeshImporter::GetCookedPath(const std::string_view path) {
+  return std::string{ path } + std::string{ CookedExtension };
+}
+
+std::string MeshImporter::Cook(const std::string_view path, MeshVertexFormat format) {
+  if (IsCooked(path))
+    return std::string{ path };
+
+  std::string cookedPath = GetCookedPath(path);
+  std::error_code ec;
+  bool hasSource = std::filesystem::exists(path, ec);
+  bool hasCooked = std::filesystem::exists(cookedPath, ec);
+  // shipped builds may only contain the cooked file
+  if (hasCooked && (!hasSource || std::filesystem::last_write_time(cookedPath, ec) >= std::filesystem::last_write_time(path, ec))) {
+    // only reuse cooked files produced by this version of the cooker
+    MappedFile file(cookedPath);
+    CookedMesh cooked;
+    if (file.isOpen() && ReadCooked(file, cooked) && cooked.header->vertexFormat == format)
+      return cookedPath;
+  }
+
+  auto mesh = Import(path);
+  if (!mesh)
+    return {};
+  MeshOptimizer::Optimize(*mesh);
+  MeshSimplifier::GenerateLods(*mesh);
+  if (!WriteCooked(*mesh, cookedPath, format))
+    return {};
+  LOG_INFO("Cooked {} -> {}", path, cookedPath);
+  return cookedPath;
+}
+
+std::vector<std::string> MeshImporter::CookAll(const std::vector<std::string>& paths, MeshVertexFormat format) {
+  std::vector<std::future<std::string>> jobs;
+  jobs.reserve(paths.size());
+  for (const auto& path : paths)
+    jobs.push_back(std::async(std::launch::async, [&path, format]() { return Cook(path, format); }));
+
+  std::vector<std::string> cookedPaths;
+  cookedPaths.reserve(paths.size());
+  for (auto& job : jobs)
+    cookedPaths.push_back(job.get());
+  return cookedPaths;
+}
@@ -0,0 +1,394 @@
+#include "renderer/MeshImporter.h"
+#include <utils/logger.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// glTF 2.0 importer (.gltf with external/base64 buffers and binary .glb).
+// JSON is a subset of YAML 1.2, so the document is parsed with yaml-cpp instead of pulling in another parser.
+// Only triangle primitives are imported, node transforms are baked into the vertices.
+
+using Engine::MeshImporter;
+using Engine::MeshData;
+using Engine::MeshVertex;
+
+namespace {
+  enum ComponentType : uint32_t {
+    Byte = 5120,
+    UnsignedByte = 5121,
+    Short = 5122,
+    UnsignedShort = 5123,
+    UnsignedInt = 5125,
+    Float = 5126
+  };
+  enum PrimitiveMode : uint32_t {
+    Triangles = 4
+  };
+  constexpr uint32_t GlbMagic = 0x46546C67; // "glTF"
+  constexpr uint32_t GlbChunkJson = 0x4E4F534A; // "JSON"
+  constexpr uint32_t GlbChunkBin = 0x004E4942; // "BIN\0"
+
+  using Buffer = std::vector<uint8_t>;
+
+  bool ReadFile(const std::filesystem::path& path, Buffer& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+      return false;
+    out.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(out.data()), out.size());
+    return static_cast<bool>(file);
+  }
+
+  bool DecodeBase64(const std::string_view input, Buffer& out) {
+    auto decode = [](char c) -> int {
+      if (c >= 'A' && c <= 'Z') return c - 'A';
+      if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+      if (c >= '0' && c <= '9') return c - '0' + 52;
+      if (c == '+') return 62;
+      if (c == '/') return 63;
+      return -1;
+    };
+    out.clear();
+    out.reserve(input.size() * 3 / 4);
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (char c : input) {
+      if (c == '=')
+        break;
+      int value = decode(c);
+      if (value < 0)
+        return false;
+      accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        out.push_back(static_cast<uint8_t>((accumulator >> bits) & 0xFF));
+      }
+    }
+    return true;
+  }
+
+  uint32_t GetComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+  }
+
+  uint32_t GetComponentSize(uint32_t componentType) {
+    switch (componentType) {
+      case Byte:
+      case UnsignedByte: return 1;
+      case Short:
+      case UnsignedShort: return 2;
+      case UnsignedInt:
+      case Float: return 4;
+      default: return 0;
+    }
+  }
+
+  float ReadComponent(const uint8_t* data, uint32_t componentType, bool normalized) {
+    switch (componentType) {
+      case Float: {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+      }
+      case UnsignedByte: return normalized ? data[0] / 255.f : data[0];
+      case Byte: {
+        auto value = static_cast<int8_t>(data[0]);
+        return normalized ? glm::max(value / 127.f, -1.f) : value;
+      }
+      case UnsignedShort: {
+        uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? value / 65535.f : value;
+      }
+      case Short: {
+        int16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? glm::max(value / 32767.f, -1.f) : value;
+      }
+      case UnsignedInt: {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return static_cast<float>(value);
+      }
+      default: return 0.f;
+    }
+  }
+
+  // Bounds checked location of an accessor's elements
+  struct AccessorView {
+    const uint8_t* data = nullptr;
+    uint32_t count = 0;
+    uint32_t stride = 0;
+    uint32_t componentType = 0;
+    uint32_t componentSize = 0;
+    uint32_t components = 0;
+    bool normalized = false;
+  };
+
+  class Document {
+  public:
+    YAML::Node root;
+    std::vector<Buffer> buffers;
+
+    bool getAccessor(uint32_t index, AccessorView& out) const {
+      const auto accessor = this->root["accessors"][index];
+      if (!accessor || !accessor["bufferView"])
+        return false;
+      out.count = accessor["count"].as<uint32_t>();
+      out.componentType = accessor["componentType"].as<uint32_t>();
+      out.components = GetComponentCount(accessor["type"].as<std::string>());
+      out.normalized = accessor["normalized"] ? accessor["normalized"].as<bool>() : false;
+      uint64_t accessorOffset = accessor["byteOffset"] ? accessor["byteOffset"].as<uint64_t>() : 0;
+
+      const auto view = this->root["bufferViews"][accessor["bufferView"].as<uint32_t>()];
+      uint32_t bufferIndex = view["buffer"].as<uint32_t>();
+      if (bufferIndex >= this->buffers.size())
+        return false;
+      const auto& buffer = this->buffers[bufferIndex];
+      uint64_t viewOffset = view["byteOffset"] ? view["byteOffset"].as<uint64_t>() : 0;
+      out.componentSize = GetComponentSize(out.componentType);
+      uint32_t elementSize = out.componentSize * out.components;
+      out.stride = view["byteStride"] ? view["byteStride"].as<uint32_t>() : elementSize;
+      if (elementSize == 0 || (out.count > 0 && viewOffset + accessorOffset + uint64_t(out.count - 1) * out.stride + elementSize > buffer.size()))
+        return false;
+      out.data = buffer.data() + viewOffset + accessorOffset;
+      return true;
+    }
+
+    // Reads an accessor into a tightly packed float array with `components` values per element
+    // Missing components are zero filled, extra ones are dropped.
+    bool readAccessor(uint32_t index, uint32_t components, std::vector<float>& out) const {
+      AccessorView accessor;
+      if (!this->getAccessor(index, accessor))
+        return false;
+      out.assign(size_t(accessor.count) * components, 0.f);
+      uint32_t copied = glm::min(components, accessor.components);
+      for (uint32_t i = 0; i < accessor.count; i++) {
+        const uint8_t* element = accessor.data + size_t(i) * accessor.stride;
+        for (uint32_t c = 0; c < copied; c++)
+          out[size_t(i) * components + c] = ReadComponent(element + c * accessor.componentSize, accessor.componentType, accessor.normalized);
+      }
+      return true;
+    }
+
+    // Indices are read as integers, floats can't hold every 32 bit index
+    bool readIndices(uint32_t index, std::vector<uint32_t>& out) const {
+      AccessorView accessor;
+      if (!this->getAccessor(index, accessor) || accessor.components != 1)
+        return false;
+      out.resize(accessor.count);
+      for (uint32_t i = 0; i < accessor.count; i++) {
+        const uint8_t* element = accessor.data + size_t(i) * accessor.stride;
+        switch (accessor.componentType) {
+          case UnsignedByte: out[i] = element[0]; break;
+          case UnsignedShort: {
+            uint16_t value;
+            std::memcpy(&value, element, sizeof(value));
+            out[i] = value;
+            break;
+          }
+          case UnsignedInt: std::memcpy(&out[i], element, sizeof(uint32_t)); break;
+          // the only index types glTF allows
+          default: return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  glm::mat4 GetNodeTransform(const YAML::Node& node) {
+    if (node["matrix"]) {
+      glm::mat4 matrix{ 1.f };
+      auto values = node["matrix"].as<std::vector<float>>();
+      if (values.size() == 16)
+        std::memcpy(glm::value_ptr(matrix), values.data(), sizeof(matrix));
+      return matrix;
+    }
+    glm::vec3 translation{ 0.f };
+    glm::quat rotation{ 1.f, 0.f, 0.f, 0.f };
+    glm::vec3 scale{ 1.f };
+    if (node["translation"]) {
+      auto t = node["translation"].as<std::vector<float>>();
+      translation = { t[0], t[1], t[2] };
+    }
+    if (node["rotation"]) {
+      // glTF stores quaternions as xyzw
+      auto r = node["rotation"].as<std::vector<float>>();
+      rotation = glm::quat{ r[3], r[0], r[1], r[2] };
+    }
+    if (node["scale"]) {
+      auto s = node["scale"].as<std::vector<float>>();
+      scale = { s[0], s[1], s[2] };
+    }
+    return glm::translate(glm::mat4{ 1.f }, translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.f }, scale);
+  }
+
+  bool AppendMesh(const Document& doc, uint32_t meshIndex, const glm::mat4& transform, std::vector<MeshVertex>& corners) {
+    const auto mesh = doc.root["meshes"][meshIndex];
+    if (!mesh)
+      return false;
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+    for (const auto& primitive : mesh["primitives"]) {
+      uint32_t mode = primitive["mode"] ? primitive["mode"].as<uint32_t>() : Triangles;
+      if (mode != Triangles) {
+        LOG_WARN("Skipping non triangle primitive (mode {})", mode);
+        continue;
+      }
+      const auto attributes = primitive["attributes"];
+      if (!attributes["POSITION"])
+        continue;
+      std::vector<float> positions, normals, uvs, colors;
+      if (!doc.readAccessor(attributes["POSITION"].as<uint32_t>(), 3, positions))
+        return false;
+      if (attributes["NORMAL"])
+        doc.readAccessor(attributes["NORMAL"].as<uint32_t>(), 3, normals);
+      if (attributes["TEXCOORD_0"])
+        doc.readAccessor(attributes["TEXCOORD_0"].as<uint32_t>(), 2, uvs);
+      if (attributes["COLOR_0"])
+        doc.readAccessor(attributes["COLOR_0"].as<uint32_t>(), 3, colors);
+
+      size_t vertexCount = positions.size() / 3;
+      std::vector<uint32_t> indices;
+      if (primitive["indices"]) {
+        if (!doc.readIndices(primitive["indices"].as<uint32_t>(), indices))
+          return false;
+      }
+      else {
+        indices.resize(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++)
+          indices[i] = i;
+      }
+
+      corners.reserve(corners.size() + indices.size());
+      for (uint32_t index : indices) {
+        if (index >= vertexCount)
+          return false;
+        MeshVertex vertex{};
+        vertex.position = glm::vec3(transform * glm::vec4(positions[index * 3 + 0], positions[index * 3 + 1], positions[index * 3 + 2], 1.f));
+        if (!normals.empty())
+          vertex.normal = glm::normalize(normalMatrix * glm::vec3(normals[index * 3 + 0], normals[index * 3 + 1], normals[index * 3 + 2]));
+        if (!uvs.empty())
+          vertex.uv = { uvs[index * 2 + 0], uvs[index * 2 + 1] };
+        if (!colors.empty())
+          vertex.color = { colors[index * 3 + 0], colors[index * 3 + 1], colors[index * 3 + 2] };
+        corners.push_back(vertex);
+      }
+    }
+    return true;
+  }
+
+  bool AppendNode(const Document& doc, uint32_t nodeIndex, const glm::mat4& parent, std::vector<MeshVertex>& corners, uint32_t depth = 0) {
+    // guards against cyclic node graphs in malformed files
+    if (depth > 256)
+      return false;
+    const auto node = doc.root["nodes"][nodeIndex];
+    if (!node)
+      return false;
+    glm::mat4 transform = parent * GetNodeTransform(node);
+    if (node["mesh"] && !AppendMesh(doc, node["mesh"].as<uint32_t>(), transform, corners))
+      return false;
+    for (const auto& child : node["children"]) {
+      if (!AppendNode(doc, child.as<uint32_t>(), transform, corners, depth + 1))
+        return false;
+    }
+    return true;
+  }
+}
+
+std::optional<MeshData> MeshImporter::ImportGltf(const std::string_view path) {
+  std::filesystem::path filePath{ path };
+  Buffer file;
+  if (!ReadFile(filePath, file)) {
+    LOG_ERROR("Failed to read {}", path);
+    return std::nullopt;
+  }
+
+  Document doc;
+  try {
+    std::string json;
+    Buffer embedded;
+    uint32_t magic = 0;
+    if (file.size() >= 12)
+      std::memcpy(&magic, file.data(), sizeof(magic));
+    if (magic == GlbMagic) {
+      // 12 byte header followed by [length, type, data] chunks
+      size_t offset = 12;
+      while (offset + 8 <= file.size()) {
+        uint32_t chunkLength, chunkType;
+        std::memcpy(&chunkLength, file.data() + offset, sizeof(uint32_t));
+        std::memcpy(&chunkType, file.data() + offset + 4, sizeof(uint32_t));
+        offset += 8;
+        if (offset + chunkLength > file.size())
+          break;
+        if (chunkType == GlbChunkJson)
+          json.assign(reinterpret_cast<const char*>(file.data() + offset), chunkLength);
+        else if (chunkType == GlbChunkBin)
+          embedded.assign(file.data() + offset, file.data() + offset + chunkLength);
+        offset += (chunkLength + 3) & ~3u;
+      }
+    }
+    else
+      json.assign(reinterpret_cast<const char*>(file.data()), file.size());
+
+    doc.root = YAML::Load(json);
+    for (const auto& buffer : doc.root["buffers"]) {
+      auto& data = doc.buffers.emplace_back();
+      if (!buffer["uri"]) {
+        data = std::move(embedded);
+        continue;
+      }
+      auto uri = buffer["uri"].as<std::string>();
+      if (uri.rfind("data:", 0) == 0) {
+        auto comma = uri.find(',');
+        if (comma == std::string::npos || !DecodeBase64(std::string_view{ uri }.substr(comma + 1), data)) {
+          LOG_ERROR("Failed to decode embedded buffer in {}", path);
+          return std::nullopt;
+        }
+      }
+      else if (!ReadFile(filePath.parent_path() / uri, data)) {
+        LOG_ERROR("Failed to read buffer {} referenced by {}", uri, path);
+        return std::nullopt;
+      }
+    }
+
+    std::vector<MeshVertex> corners;
+    bool ok = true;
+    const auto scenes = doc.root["scenes"];
+    if (scenes && scenes.size() > 0) {
+      uint32_t sceneIndex = doc.root["scene"] ? doc.root["scene"].as<uint32_t>() : 0;
+      for (const auto& node : scenes[sceneIndex]["nodes"])
+        ok = ok && AppendNode(doc, node.as<uint32_t>(), glm::mat4{ 1.f }, corners);
+    }
+    else {
+      for (uint32_t i = 0; i < doc.root["meshes"].size(); i++)
+        ok = ok && AppendMesh(doc, i, glm::mat4{ 1.f }, corners);
+    }
+    if (!ok) {
+      LOG_ERROR("Malformed glTF file {}", path);
+      return std::nullopt;
+    }
+
+    MeshData mesh;
+    const auto meshes = doc.root["meshes"];
+    if (meshes.size() == 1 && meshes[0]["name"])
+      mesh.name = meshes[0]["name"].as<std::string>();
+    BuildIndexed(corners, mesh);
+    return mesh;
+  }
+  catch (const std::exception& e) {
+    LOG_ERROR("Failed to parse {}: {}", path, e.what());
+    return std::nullopt;
+  }
+}
@@ -0,0 +1,324 @@
+#include "renderer/MeshOptimizer.h"
+#include <utils/logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using Engine::MeshOptimizer;
+using Engine::VertexCacheStatistics;
+
+namespace {
+  // Tuned values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+  constexpr float CacheDecayPower = 1.5f;
+  constexpr float LastTriangleScore = 0.75f;
+  constexpr float ValenceBoostScale = 2.0f;
+  constexpr float ValenceBoostPower = 0.5f;
+
+  constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  float ScoreVertex(int32_t cachePosition, uint32_t activeTriangles) {
+    // no triangle left to draw with this vertex
+    if (activeTriangles == 0)
+      return -1.f;
+    float score = 0.f;
+    if (cachePosition >= 0) {
+      // the vertices of the last triangle are scored equally on purpose,
+      // otherwise the optimizer favours strip like orders which are worse for the cache
+      if (cachePosition < 3)
+        score = LastTriangleScore;
+      else {
+        constexpr float scaler = 1.f / (MeshOptimizer::CacheSize - 3);
+        score = std::pow(1.f - (cachePosition - 3) * scaler, CacheDecayPower);
+      }
+    }
+    // favour vertices with few triangles left so they don't get stranded
+    score += ValenceBoostScale * std::pow(static_cast<float>(activeTriangles), -ValenceBoostPower);
+    return score;
+  }
+
+  // FIFO post-transform cache, timestamps avoid shifting a queue around
+  class CacheSimulator {
+  public:
+    CacheSimulator(uint32_t vertexCount, uint32_t cacheSize)
+      : timestamps(vertexCount, 0), cacheSize(cacheSize), time(cacheSize + 1) {}
+
+    uint32_t process(const uint32_t* triangle) {
+      uint32_t misses = 0;
+      for (uint32_t k = 0; k < 3; k++) {
+        uint32_t vertex = triangle[k];
+        if (this->time - this->timestamps[vertex] > this->cacheSize) {
+          this->timestamps[vertex] = this->time++;
+          misses++;
+        }
+      }
+      return misses;
+    }
+    void reset() { this->time += this->cacheSize + 1; }
+  private:
+    std::vector<uint32_t> timestamps;
+    uint32_t cacheSize;
+    uint32_t time;
+  };
+}
+
+void MeshOptimizer::Optimize(MeshData& mesh) {
+  if (mesh.indices.size() < 3)
+    return;
+  auto before = AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+  OptimizeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+  OptimizeOverdraw(mesh.indices, mesh.vertices);
+  OptimizeVertexFetch(mesh);
+  auto after = AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+  LOG_INFO(
+    "Optimized mesh {} ({} triangles): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+    mesh.name, mesh.indices.size() / 3,
+    before.acmr, after.acmr,
+    before.atvr, after.atvr
+  );
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+    return;
+
+  // vertex -> triangles adjacency, the first activeTriangles[v] entries of each range are the ones not emitted yet
+  std::vector<uint32_t> activeTriangles(vertexCount, 0);
+  for (uint32_t index : indices)
+    activeTriangles[index]++;
+  std::vector<uint32_t> adjacencyOffsets(size_t(vertexCount) + 1, 0);
+  for (uint32_t v = 0; v < vertexCount; v++)
+    adjacencyOffsets[v + 1] = adjacencyOffsets[v] + activeTriangles[v];
+  std::vector<uint32_t> adjacency(indices.size());
+  {
+    std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+      adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+
+  std::vector<int32_t> cachePositions(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for (uint32_t v = 0; v < vertexCount; v++)
+    vertexScores[v] = ScoreVertex(-1, activeTriangles[v]);
+
+  std::vector<float> triangleScores(triangleCount);
+  std::vector<bool> emitted(triangleCount, false);
+  for (size_t t = 0; t < triangleCount; t++)
+    triangleScores[t] = vertexScores[indices[t * 3 + 0]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+  auto updateVertexScore = [&](uint32_t vertex) {
+    float score = ScoreVertex(cachePositions[vertex], activeTriangles[vertex]);
+    float delta = score - vertexScores[vertex];
+    vertexScores[vertex] = score;
+    const uint32_t* triangles = adjacency.data() + adjacencyOffsets[vertex];
+    for (uint32_t i = 0; i < activeTriangles[vertex]; i++)
+      triangleScores[triangles[i]] += delta;
+  };
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+  std::vector<uint32_t> cache, nextCache;
+  cache.reserve(CacheSize + 3);
+  nextCache.reserve(CacheSize + 3);
+
+  uint32_t bestTriangle = static_cast<uint32_t>(std::distance(
+    triangleScores.begin(),
+    std::max_element(triangleScores.begin(), triangleScores.end())
+  ));
+  size_t scanCursor = 0;
+  while (bestTriangle != InvalidIndex) {
+    emitted[bestTriangle] = true;
+    const uint32_t* triangle = indices.data() + size_t(bestTriangle) * 3;
+
+    nextCache.clear();
+    for (uint32_t k = 0; k < 3; k++) {
+      uint32_t vertex = triangle[k];
+      output.push_back(vertex);
+      if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+        nextCache.push_back(vertex);
+
+      // move the triangle past the active range of the vertex
+      auto begin = adjacency.begin() + adjacencyOffsets[vertex];
+      auto end = begin + activeTriangles[vertex];
+      std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+      activeTriangles[vertex]--;
+    }
+    for (uint32_t vertex : cache) {
+      if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+        nextCache.push_back(vertex);
+    }
+    // evicted vertices
+    for (size_t i = CacheSize; i < nextCache.size(); i++) {
+      cachePositions[nextCache[i]] = -1;
+      updateVertexScore(nextCache[i]);
+    }
+    if (nextCache.size() > CacheSize)
+      nextCache.resize(CacheSize);
+    std::swap(cache, nextCache);
+
+    for (size_t i = 0; i < cache.size(); i++) {
+      cachePositions[cache[i]] = static_cast<int32_t>(i);
+      updateVertexScore(cache[i]);
+    }
+
+    // only triangles touching the cache had their score changed
+    bestTriangle = InvalidIndex;
+    float bestScore = -std::numeric_limits<float>::max();
+    for (uint32_t vertex : cache) {
+      const uint32_t* triangles = adjacency.data() + adjacencyOffsets[vertex];
+      for (uint32_t i = 0; i < activeTriangles[vertex]; i++) {
+        if (triangleScores[triangles[i]] > bestScore) {
+          bestScore = triangleScores[triangles[i]];
+          bestTriangle = triangles[i];
+        }
+      }
+    }
+    // dead end, restart from the next triangle that hasn't been emitted
+    if (bestTriangle == InvalidIndex) {
+      while (scanCursor < triangleCount && emitted[scanCursor])
+        scanCursor++;
+      if (scanCursor < triangleCount)
+        bestTriangle = static_cast<uint32_t>(scanCursor);
+    }
+  }
+  indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices, float threshold) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2)
+    return;
+  const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+  // hard boundaries: a triangle missing all of its vertices starts a new cluster,
+  // so reordering clusters doesn't change the vertex cache efficiency
+  std::vector<uint32_t> hardClusters;
+  {
+    CacheSimulator cache(vertexCount, CacheSize);
+    for (size_t t = 0; t < triangleCount; t++) {
+      uint32_t misses = cache.process(indices.data() + t * 3);
+      if (t == 0 || misses == 3)
+        hardClusters.push_back(static_cast<uint32_t>(t));
+    }
+  }
+  hardClusters.push_back(static_cast<uint32_t>(triangleCount));
+
+  // soft boundaries: split hard clusters further as long as the local ACMR stays within the threshold
+  std::vector<uint32_t> clusters;
+  {
+    CacheSimulator cache(vertexCount, CacheSize);
+    for (size_t c = 0; c + 1 < hardClusters.size(); c++) {
+      uint32_t start = hardClusters[c];
+      uint32_t end = hardClusters[c + 1];
+
+      cache.reset();
+      uint32_t clusterMisses = 0;
+      for (uint32_t t = start; t < end; t++)
+        clusterMisses += cache.process(indices.data() + size_t(t) * 3);
+      float clusterThreshold = threshold * static_cast<float>(clusterMisses) / (end - start);
+
+      cache.reset();
+      clusters.push_back(start);
+      uint32_t softStart = start;
+      uint32_t misses = 0;
+      for (uint32_t t = start; t < end; t++) {
+        misses += cache.process(indices.data() + size_t(t) * 3);
+        if (t + 1 < end && static_cast<float>(misses) / (t - softStart + 1) <= clusterThreshold) {
+          clusters.push_back(t + 1);
+          softStart = t + 1;
+          misses = 0;
+          cache.reset();
+        }
+      }
+    }
+  }
+  clusters.push_back(static_cast<uint32_t>(triangleCount));
+  const size_t clusterCount = clusters.size() - 1;
+  if (clusterCount < 2)
+    return;
+
+  // sort clusters so those facing away from the mesh center are drawn first, they are the most likely to occlude
+  glm::vec3 meshCentroid{ 0.f };
+  float meshArea = 0.f;
+  std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{ 0.f });
+  std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{ 0.f });
+  for (size_t c = 0; c < clusterCount; c++) {
+    float clusterArea = 0.f;
+    for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+      const auto& p0 = vertices[indices[size_t(t) * 3 + 0]].position;
+      const auto& p1 = vertices[indices[size_t(t) * 3 + 1]].position;
+      const auto& p2 = vertices[indices[size_t(t) * 3 + 2]].position;
+      glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      float area = glm::length(normal);
+      glm::vec3 centroid = (p0 + p1 + p2) / 3.f;
+      clusterCentroids[c] += centroid * area;
+      clusterNormals[c] += normal;
+      clusterArea += area;
+      meshCentroid += centroid * area;
+      meshArea += area;
+    }
+    if (clusterArea > 0.f)
+      clusterCentroids[c] /= clusterArea;
+  }
+  if (meshArea > 0.f)
+    meshCentroid /= meshArea;
+
+  std::vector<float> sortKeys(clusterCount, 0.f);
+  for (size_t c = 0; c < clusterCount; c++) {
+    float normalLength = glm::length(clusterNormals[c]);
+    if (normalLength > 0.f)
+      sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / normalLength);
+  }
+  std::vector<uint32_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) {
+    return sortKeys[a] > sortKeys[b];
+  });
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+  for (uint32_t c : order)
+    output.insert(output.end(), indices.begin() + size_t(clusters[c]) * 3, indices.begin() + size_t(clusters[c + 1]) * 3);
+  indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh) {
+  std::vector<uint32_t> remap(mesh.vertices.size(), InvalidIndex);
+  uint32_t nextVertex = 0;
+  for (auto& index : mesh.indices) {
+    if (remap[index] == InvalidIndex)
+      remap[index] = nextVertex++;
+    index = remap[index];
+  }
+  std::vector<MeshVertex> vertices(nextVertex);
+  for (size_t v = 0; v < mesh.vertices.size(); v++) {
+    if (remap[v] != InvalidIndex)
+      vertices[remap[v]] = mesh.vertices[v];
+  }
+  mesh.vertices = std::move(vertices);
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+  VertexCacheStatistics stats{};
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+    return stats;
+
+  CacheSimulator cache(vertexCount, cacheSize);
+  for (size_t t = 0; t < triangleCount; t++)
+    stats.misses += cache.process(indices.data() + t * 3);
+
+  std::vector<bool> referenced(vertexCount, false);
+  uint32_t uniqueVertices = 0;
+  for (uint32_t index : indices) {
+    if (!referenced[index]) {
+      referenced[index] = true;
+      uniqueVertices++;
+    }
+  }
+  stats.acmr = static_cast<float>(stats.misses) / triangleCount;
+  stats.atvr = uniqueVertices ? static_cast<float>(stats.misses) / uniqueVertices : 0.f;
+  return stats;
+}
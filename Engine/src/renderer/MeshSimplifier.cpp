@@ -0,0 +1,363 @@
+#include "renderer/MeshSimplifier.h"
+#include "renderer/MeshOptimizer.h"
+#include <utils/logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+using Engine::MeshSimplifier;
+using Engine::MeshVertex;
+
+namespace {
+  // Symmetric 4x4 matrix accumulating area weighted squared distances to planes
+  struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+
+    void addPlane(double a, double b, double c, double d, double w) {
+      this->a00 += w * a * a; this->a01 += w * a * b; this->a02 += w * a * c; this->a03 += w * a * d;
+      this->a11 += w * b * b; this->a12 += w * b * c; this->a13 += w * b * d;
+      this->a22 += w * c * c; this->a23 += w * c * d;
+      this->a33 += w * d * d;
+      this->weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+      this->a00 += other.a00; this->a01 += other.a01; this->a02 += other.a02; this->a03 += other.a03;
+      this->a11 += other.a11; this->a12 += other.a12; this->a13 += other.a13;
+      this->a22 += other.a22; this->a23 += other.a23;
+      this->a33 += other.a33;
+      this->weight += other.weight;
+      return *this;
+    }
+
+    // mean squared distance from the point to the accumulated planes
+    double evaluate(const glm::vec3& p) const {
+      double x = p.x, y = p.y, z = p.z;
+      double error =
+        this->a00 * x * x + 2 * this->a01 * x * y + 2 * this->a02 * x * z + 2 * this->a03 * x +
+        this->a11 * y * y + 2 * this->a12 * y * z + 2 * this->a13 * y +
+        this->a22 * z * z + 2 * this->a23 * z +
+        this->a33;
+      return this->weight > 0 ? std::abs(error) / this->weight : 0;
+    }
+  };
+
+  struct PositionHash {
+    size_t operator()(const glm::vec3& p) const {
+      size_t seed = 0;
+      Engine::HashCombine(seed, p.x, p.y, p.z);
+      return seed;
+    }
+  };
+
+  struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    float cost;
+  };
+
+  uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return (uint64_t(a) << 32) | b;
+  }
+
+  glm::vec3 TriangleNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+    return glm::cross(p1 - p0, p2 - p0);
+  }
+
+  // Closest point of a triangle, by Voronoi region (Ericson, Real-Time Collision Detection 5.1.5)
+  glm::vec3 ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.f && d2 <= 0.f)
+      return a;
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.f && d4 <= d3)
+      return b;
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+      return a + ab * (d1 / (d1 - d3));
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.f && d5 <= d6)
+      return c;
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+      return a + ac * (d2 / (d2 - d6));
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+      return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    float denominator = va + vb + vc;
+    if (denominator <= 0.f)
+      return a;
+    return a + ab * (vb / denominator) + ac * (vc / denominator);
+  }
+
+  // Upper bound of the max distance from the original vertices to the simplified triangles.
+  // Each vertex is measured against the triangles around the vertex it was collapsed onto.
+  float MeasureError(
+    const std::vector<MeshVertex>& vertices,
+    const uint32_t* indices, size_t indexCount,
+    const std::vector<uint32_t>& simplified,
+    const std::vector<uint32_t>& weld,
+    const std::vector<uint32_t>& representative
+  ) {
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    std::vector<uint32_t> offsets(size_t(vertexCount) + 1, 0);
+    for (uint32_t v : simplified)
+      offsets[weld[v] + 1]++;
+    for (uint32_t v = 0; v < vertexCount; v++)
+      offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> triangles(simplified.size());
+    {
+      std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+      for (size_t i = 0; i < simplified.size(); i++)
+        triangles[cursors[weld[simplified[i]]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    float maxDistance = 0.f;
+    std::vector<bool> measured(vertexCount, false);
+    for (size_t i = 0; i < indexCount; i++) {
+      uint32_t v = indices[i];
+      if (measured[weld[v]])
+        continue;
+      measured[weld[v]] = true;
+      uint32_t r = weld[representative[v]];
+      if (offsets[r] == offsets[r + 1])
+        continue;
+      const glm::vec3& p = vertices[v].position;
+      float distance = std::numeric_limits<float>::max();
+      for (uint32_t t = offsets[r]; t < offsets[r + 1]; t++) {
+        const uint32_t* triangle = simplified.data() + size_t(triangles[t]) * 3;
+        glm::vec3 closest = ClosestPointOnTriangle(
+          p, vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position
+        );
+        distance = std::min(distance, glm::length(p - closest));
+      }
+      maxDistance = std::max(maxDistance, distance);
+    }
+    return maxDistance;
+  }
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(
+  const std::vector<MeshVertex>& vertices,
+  const uint32_t* indices, size_t indexCount,
+  size_t targetIndexCount, float targetError,
+  float* resultError
+) {
+  const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+  std::vector<uint32_t> result(indices, indices + indexCount);
+  if (resultError)
+    *resultError = 0.f;
+  if (indexCount <= targetIndexCount)
+    return result;
+
+  // weld vertices sharing a position, topology and error are tracked on the welded representative
+  std::vector<uint32_t> weld(vertexCount);
+  {
+    std::unordered_map<glm::vec3, uint32_t, PositionHash> positions;
+    positions.reserve(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+      weld[v] = positions.try_emplace(vertices[v].position, v).first->second;
+  }
+
+  // lock attribute seams (a position referenced through several vertices) and open borders
+  std::vector<bool> locked(vertexCount, false);
+  {
+    std::vector<uint32_t> wedge(vertexCount, UINT32_MAX);
+    for (size_t i = 0; i < indexCount; i++) {
+      uint32_t v = indices[i];
+      uint32_t& first = wedge[weld[v]];
+      if (first == UINT32_MAX)
+        first = v;
+      else if (first != v)
+        locked[weld[v]] = true;
+    }
+    std::unordered_set<uint64_t> edges;
+    edges.reserve(indexCount);
+    for (size_t i = 0; i < indexCount; i += 3) {
+      for (int k = 0; k < 3; k++)
+        edges.insert(EdgeKey(weld[indices[i + k]], weld[indices[i + (k + 1) % 3]]));
+    }
+    for (size_t i = 0; i < indexCount; i += 3) {
+      for (int k = 0; k < 3; k++) {
+        uint32_t a = weld[indices[i + k]];
+        uint32_t b = weld[indices[i + (k + 1) % 3]];
+        if (!edges.contains(EdgeKey(b, a)))
+          locked[a] = locked[b] = true;
+      }
+    }
+  }
+
+  std::vector<Quadric> quadrics(vertexCount);
+  for (size_t i = 0; i < indexCount; i += 3) {
+    const auto& p0 = vertices[indices[i + 0]].position;
+    const auto& p1 = vertices[indices[i + 1]].position;
+    const auto& p2 = vertices[indices[i + 2]].position;
+    glm::vec3 normal = TriangleNormal(p0, p1, p2);
+    float doubleArea = glm::length(normal);
+    if (doubleArea <= 0.f)
+      continue;
+    normal /= doubleArea;
+    double d = -glm::dot(normal, p0);
+    for (int k = 0; k < 3; k++)
+      quadrics[weld[indices[i + k]]].addPlane(normal.x, normal.y, normal.z, d, doubleArea * .5);
+  }
+
+  const double maxError = double(targetError) * targetError;
+  // vertex each original vertex ended up collapsed onto
+  std::vector<uint32_t> representative(vertexCount);
+  std::iota(representative.begin(), representative.end(), 0);
+  std::vector<uint32_t> adjacencyOffsets(size_t(vertexCount) + 1);
+  std::vector<uint32_t> adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<uint32_t> collapseRemap(vertexCount);
+  std::vector<bool> touched(vertexCount);
+
+  // each pass collapses a batch of independent edges, cheapest first
+  while (result.size() > targetIndexCount) {
+    const size_t triangleCount = result.size() / 3;
+
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (uint32_t v : result)
+      adjacencyOffsets[v + 1]++;
+    for (uint32_t v = 0; v < vertexCount; v++)
+      adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    adjacency.resize(result.size());
+    {
+      std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+      for (size_t i = 0; i < result.size(); i++)
+        adjacency[cursors[result[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    collapses.clear();
+    for (size_t i = 0; i < result.size(); i += 3) {
+      for (int k = 0; k < 3; k++) {
+        uint32_t from = result[i + k];
+        uint32_t to = result[i + (k + 1) % 3];
+        for (int direction = 0; direction < 2; direction++, std::swap(from, to)) {
+          if (locked[weld[from]] || weld[from] == weld[to])
+            continue;
+          Quadric quadric = quadrics[weld[from]];
+          quadric += quadrics[weld[to]];
+          collapses.push_back({ from, to, static_cast<float>(quadric.evaluate(vertices[to].position)) });
+        }
+      }
+    }
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+    std::iota(collapseRemap.begin(), collapseRemap.end(), 0);
+    std::fill(touched.begin(), touched.end(), false);
+    const size_t targetTriangles = targetIndexCount / 3;
+    size_t trianglesLeft = triangleCount;
+    size_t applied = 0;
+    for (const auto& collapse : collapses) {
+      if (collapse.cost > maxError || trianglesLeft <= targetTriangles)
+        break;
+      uint32_t from = collapse.from, to = collapse.to;
+      if (touched[weld[from]] || touched[weld[to]])
+        continue;
+
+      // refuse collapses flipping a neighbouring triangle
+      const uint32_t* triangles = adjacency.data() + adjacencyOffsets[from];
+      uint32_t triangleCountAround = adjacencyOffsets[from + 1] - adjacencyOffsets[from];
+      bool flips = false;
+      uint32_t removed = 0;
+      for (uint32_t t = 0; t < triangleCountAround && !flips; t++) {
+        const uint32_t* triangle = result.data() + size_t(triangles[t]) * 3;
+        if (weld[triangle[0]] == weld[to] || weld[triangle[1]] == weld[to] || weld[triangle[2]] == weld[to]) {
+          removed++;
+          continue;
+        }
+        glm::vec3 p[3], q[3];
+        for (int k = 0; k < 3; k++) {
+          p[k] = vertices[triangle[k]].position;
+          q[k] = triangle[k] == from ? vertices[to].position : p[k];
+        }
+        flips = glm::dot(TriangleNormal(p[0], p[1], p[2]), TriangleNormal(q[0], q[1], q[2])) <= 0.f;
+      }
+      if (flips)
+        continue;
+
+      collapseRemap[from] = to;
+      quadrics[weld[to]] += quadrics[weld[from]];
+      // the whole one ring is frozen until the next pass since its geometry changed
+      for (uint32_t t = 0; t < triangleCountAround; t++) {
+        const uint32_t* triangle = result.data() + size_t(triangles[t]) * 3;
+        for (int k = 0; k < 3; k++)
+          touched[weld[triangle[k]]] = true;
+      }
+      trianglesLeft -= removed;
+      applied++;
+    }
+    if (applied == 0)
+      break;
+    for (uint32_t& r : representative)
+      r = collapseRemap[r];
+
+    size_t write = 0;
+    for (size_t i = 0; i < result.size(); i += 3) {
+      uint32_t a = collapseRemap[result[i + 0]];
+      uint32_t b = collapseRemap[result[i + 1]];
+      uint32_t c = collapseRemap[result[i + 2]];
+      if (weld[a] == weld[b] || weld[b] == weld[c] || weld[c] == weld[a])
+        continue;
+      result[write++] = a;
+      result[write++] = b;
+      result[write++] = c;
+    }
+    result.resize(write);
+  }
+
+  if (resultError)
+    *resultError = MeasureError(vertices, indices, indexCount, result, weld, representative);
+  return result;
+}
+
+
+void MeshSimplifier::GenerateLods(MeshData& mesh) {
+  const uint32_t baseIndexCount = static_cast<uint32_t>(mesh.indices.size());
+  mesh.lods.clear();
+  mesh.lods.push_back({ 0, baseIndexCount, 0.f });
+  if (baseIndexCount < 3)
+    return;
+
+  const std::vector<uint32_t> base(mesh.indices.begin(), mesh.indices.end());
+  const float maxError = mesh.bounds.getRadius() * MaxRelativeError;
+  size_t previousIndexCount = baseIndexCount;
+  for (uint32_t lod = 1; lod < MaxLods; lod++) {
+    // simplify from the full mesh every time so errors are measured against it
+    size_t targetIndexCount = (baseIndexCount >> lod) / 3 * 3;
+    float error = 0.f;
+    auto indices = Simplify(mesh.vertices, base.data(), base.size(), targetIndexCount, maxError, &error);
+    if (indices.empty() || indices.size() > previousIndexCount * (1.f - MinLodReduction))
+      break;
+    MeshOptimizer::OptimizeVertexCache(indices, static_cast<uint32_t>(mesh.vertices.size()));
+
+    MeshLod level{};
+    level.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+    level.indexCount = static_cast<uint32_t>(indices.size());
+    level.error = std::max(error, mesh.lods.back().error);
+    mesh.lods.push_back(level);
+    mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+    previousIndexCount = indices.size();
+  }
+  for (uint32_t lod = 1; lod < mesh.lods.size(); lod++) {
+    LOG_INFO(
+      "Mesh {} lod {}: {} triangles ({:.1f}%), error {:.4f}",
+      mesh.name, lod,
+      mesh.lods[lod].indexCount / 3,
+      100.f * mesh.lods[lod].indexCount / baseIndexCount,
+      mesh.lods[lod].error
+    );
+  }
+}
@@ -3,6 +3,7 @@
 #include <renderer/apis/Vulkan/VulkanRenderer.h>
 #include <events/EventSystem.h>
 #include <platform/Window.h>
+#include <core/MemoryTracker.h>
 #include <renderer/logger.h>
 
 using Engine::Renderer;
@@ -19,6 +20,7 @@ Renderer::Renderer(ApplicationInfo& appInfo, Platform& platform, API api)
 }
 
 std::unique_ptr<Renderer> Renderer::Create(ApplicationInfo& appInfo, Platform& platform, API api) {
+  MEMORY_TAG(Renderer);
   try {
     Renderer::Logger = Engine::Logger::GetMainLogger()->clone("Engine/Renderer");
     switch (api) {
@@ -0,0 +1,107 @@
+#include "renderer/apis/Vulkan/BillboardRenderer.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+
+#include <core/Profiler.h>
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Engine::Renderers::Vulkan;
+
+BillboardRenderer::BillboardRenderer(Renderer& ctx, VkRenderPass renderPass, VkDescriptorSetLayout globalDescriptorSetLayout)
+  : ctx(ctx) {
+  auto& device = ctx.getDevice();
+  uint32_t framesInFlight = ctx.getSwapchain().getMaxFramesInFlight();
+  this->descriptorPool = DescriptorPool::Builder(device)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight)
+    .setMaxSets(framesInFlight)
+    .build();
+  this->instanceSetLayout = DescriptorSetLayout::Builder(device)
+    .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+    .build();
+  this->frameSets.resize(framesInFlight, VK_NULL_HANDLE);
+  for (auto& set : this->frameSets) {
+    bool allocated = this->descriptorPool->allocSet(*this->instanceSetLayout, set);
+    ASSERT(allocated, "BillboardRenderer: failed to allocate an instance set");
+  }
+  this->shader = MakeScope<Shaders::Billboard>(ctx, renderPass, globalDescriptorSetLayout, *this->instanceSetLayout);
+}
+
+BillboardRenderer::~BillboardRenderer() {}
+
+void BillboardRenderer::beginFrame() {
+  this->instances.clear();
+  this->uploaded = false;
+}
+
+void BillboardRenderer::add(const glm::vec3& position, const Components::Billboard& billboard) {
+  this->instances.push_back({
+    glm::vec4{ position, 1.f },
+    billboard.color,
+    billboard.size,
+    billboard.rounded ? 1.f : 0.f,
+    0.f
+  });
+}
+
+void BillboardRenderer::upload(uint32_t frameIndex, const glm::mat4& view) {
+  PROFILE_SCOPE("BillboardRenderer::upload");
+  this->frameIndex = frameIndex;
+  if (this->instances.empty())
+    return;
+  auto count = static_cast<uint32_t>(this->instances.size());
+  VkDeviceSize size = count * sizeof(Instance);
+  auto allocation = this->ctx.getFrameAllocator().allocate(size);
+  if (!allocation)
+    return;
+
+  // farthest first, the camera looks down -Z in view space
+  this->depths.resize(count);
+  for (uint32_t i = 0; i < count; i++)
+    this->depths[i] = (view * this->instances[i].position).z;
+  this->order.resize(count);
+  std::iota(this->order.begin(), this->order.end(), 0u);
+  std::sort(this->order.begin(), this->order.end(), [this](uint32_t a, uint32_t b) {
+    return this->depths[a] < this->depths[b];
+  });
+  auto* mapped = static_cast<Instance*>(allocation.data);
+  for (uint32_t i = 0; i < count; i++)
+    mapped[i] = this->instances[this->order[i]];
+
+  // the frame's previous use of the set is over, its fence was waited by beginFrame
+  VkDescriptorBufferInfo bufferInfo{ this->ctx.getFrameAllocator().getHandle(), allocation.offset, size };
+  DescriptorWriter(*this->instanceSetLayout, *this->descriptorPool)
+    .write(0, &bufferInfo)
+    .overwrite(this->frameSets[frameIndex]);
+  this->uploaded = true;
+}
+
+void BillboardRenderer::record(VkFrameInfo& frameInfo) {
+  if (!this->uploaded)
+    return;
+  auto& cmdBuffer = frameInfo.cmdBuffer;
+  this->shader->use(frameInfo);
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    this->shader->getPipelineLayout(),
+    1, 1, &this->frameSets[this->frameIndex],
+    0, nullptr
+  );
+  vkCmdDraw(cmdBuffer, Shaders::Billboard::VerticesPerInstance, this->getInstanceCount(), 0, 0);
+}
+
+void BillboardRenderer::recordIndirect(VkFrameInfo& frameInfo, VkDescriptorSet instanceSet, VkBuffer args, VkDeviceSize argsOffset) {
+  auto& cmdBuffer = frameInfo.cmdBuffer;
+  this->shader->use(frameInfo);
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    this->shader->getPipelineLayout(),
+    1, 1, &instanceSet,
+    0, nullptr
+  );
+  vkCmdDrawIndirect(cmdBuffer, args, argsOffset, 1, sizeof(VkDrawIndirectCommand));
+}
@@ -0,0 +1,250 @@
+#include "renderer/apis/Vulkan/CascadedShadows.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+#include "renderer/apis/Vulkan/SamplerCache.h"
+
+#include <core/Profiler.h>
+#include <utils/asserts.h>
+#include <utils/hash.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine::Renderers::Vulkan;
+
+static_assert(sizeof(CascadedShadows::ShadowUbo) == 304);
+
+namespace {
+  // graph names must be string literals
+  constexpr std::string_view ImageNames[CascadedShadows::CascadeCount] = {
+    "ShadowMap0", "ShadowMap1", "ShadowMap2", "ShadowMap3"
+  };
+  constexpr std::string_view PassNames[CascadedShadows::CascadeCount] = {
+    "ShadowCascade0", "ShadowCascade1", "ShadowCascade2", "ShadowCascade3"
+  };
+}
+
+bool CascadedShadows::Cascade::intersects(const glm::vec3& center, float radius) const {
+  // orthographic, w stays 1
+  glm::vec3 ndc = this->viewProjection * glm::vec4{ center, 1.f };
+  float extent = radius / this->halfExtent;
+  float depth = radius / this->depthRange;
+  return std::abs(ndc.x) <= 1.f + extent && std::abs(ndc.y) <= 1.f + extent && ndc.z >= -depth && ndc.z <= 1.f + depth;
+}
+
+CascadedShadows::CascadedShadows(Renderer& ctx) : ctx(ctx) {
+  this->createImages();
+  this->createDescriptors();
+}
+
+CascadedShadows::~CascadedShadows() {
+  this->ctx.getDevice().getSamplerCache().release(this->sampler);
+}
+
+void CascadedShadows::createImages() {
+  auto& device = this->ctx.getDevice();
+  this->images.reserve(CascadeCount);
+  for (uint32_t i = 0; i < CascadeCount; i++) {
+    ImageCreateInfo createInfo{};
+    createInfo.type = VK_IMAGE_TYPE_2D;
+    createInfo.extent = { Resolution, Resolution, 1 };
+    createInfo.format = Format;
+    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    createInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    createInfo.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    createInfo.viewCreateInfo.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    createInfo.createView = true;
+    this->images.emplace_back(device, createInfo);
+    // the graph imports the maps in the layout the main pass samples them in, even before their first render
+    this->images.back().transitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  }
+
+  TextureSamplerSpecification spec{};
+  spec.wrap = { TextureSamplerSpecification::Wrap::ClampToBorder, TextureSamplerSpecification::Wrap::ClampToBorder, TextureSamplerSpecification::Wrap::ClampToBorder };
+  // outside of a map is lit
+  spec.borderColor = TextureSamplerSpecification::BorderColor::FloatOpaqueWhite;
+  spec.anisotropy = false;
+  spec.compareEnable = true;
+  spec.compareOp = TextureSamplerSpecification::Compare::LessOrEqual;
+  spec.mipmapMode = TextureSamplerSpecification::MipmapMode::Nearest;
+  this->sampler = device.getSamplerCache().acquire(spec);
+}
+
+void CascadedShadows::createDescriptors() {
+  auto& device = this->ctx.getDevice();
+  this->descriptorPool = DescriptorPool::Builder(device)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, CascadeCount)
+    .setMaxSets(1)
+    .build();
+  this->descriptorSetLayout = DescriptorSetLayout::Builder(device)
+    .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_FRAGMENT_BIT)
+    .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, CascadeCount)
+    .build();
+  auto uboInfo = this->ctx.getFrameAllocator().getDescriptorInfo(sizeof(ShadowUbo));
+  std::array<VkDescriptorImageInfo, CascadeCount> imageInfos{};
+  for (uint32_t i = 0; i < CascadeCount; i++)
+    imageInfos[i] = { this->sampler, this->images[i].getView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+  DescriptorWriter(*this->descriptorSetLayout, *this->descriptorPool)
+    .write(0, &uboInfo)
+    .write(1, imageInfos.data())
+    .build(this->descriptorSet);
+}
+
+void CascadedShadows::beginFrame() {
+  this->hasLight = false;
+  this->staticHash = 0;
+  this->staticCount = 0;
+}
+
+void CascadedShadows::setLight(const glm::vec3& direction) {
+  this->hasLight = true;
+  this->lightDirection = glm::normalize(direction);
+}
+
+void CascadedShadows::addStaticCaster(const Engine::Mesh& mesh, const glm::mat4& model) {
+  size_t hash = 0;
+  Engine::HashCombine(hash, static_cast<const void*>(&mesh));
+  for (int column = 0; column < 4; column++)
+    Engine::HashCombine(hash, model[column].x, model[column].y, model[column].z, model[column].w);
+  // summed, so the submission order doesn't matter
+  this->staticHash += hash;
+  this->staticCount++;
+}
+
+void CascadedShadows::update(const GlobalUbo& globalUbo) {
+  PROFILE_SCOPE("CascadedShadows::update");
+  if (this->staticHash != this->cachedStaticHash || this->staticCount != this->cachedStaticCount) {
+    this->cacheValid.fill(false);
+    this->cachedStaticHash = this->staticHash;
+    this->cachedStaticCount = this->staticCount;
+  }
+  for (auto& cascade : this->cascades)
+    cascade.render = false;
+
+  ShadowUbo ubo{};
+  this->active = this->hasLight && this->fitCascades(globalUbo, ubo);
+  auto allocation = this->ctx.getFrameAllocator().write(ubo);
+  ASSERT(allocation, "CascadedShadows::update: frame allocator exhausted");
+  this->dynamicOffset = allocation.offset;
+}
+
+bool CascadedShadows::fitCascades(const GlobalUbo& globalUbo, ShadowUbo& ubo) {
+  // view space corners of the near and far planes, glm's -1..1 depth range
+  glm::mat4 inverseProjection = glm::inverse(globalUbo.projection);
+  std::array<glm::vec3, 4> nearCorners, farCorners;
+  for (uint32_t i = 0; i < 4; i++) {
+    glm::vec2 ndc{ i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f };
+    glm::vec4 nearCorner = inverseProjection * glm::vec4{ ndc, -1.f, 1.f };
+    glm::vec4 farCorner = inverseProjection * glm::vec4{ ndc, 1.f, 1.f };
+    nearCorners[i] = glm::vec3{ nearCorner } / nearCorner.w;
+    farCorners[i] = glm::vec3{ farCorner } / farCorner.w;
+  }
+  // the camera looks down -Z in view space
+  float nearDepth = -nearCorners[0].z;
+  float farDepth = -farCorners[0].z;
+  // logarithmic splits need a positive start, orthographic cameras may start at or behind the eye
+  float splitNear = std::max(nearDepth, .01f);
+  float shadowFar = std::min(farDepth, MaxShadowDistance);
+  if (shadowFar <= splitNear)
+    return false;
+
+  glm::vec3 up = std::abs(this->lightDirection.y) > .99f ? glm::vec3{ 0.f, 0.f, 1.f } : glm::vec3{ 0.f, 1.f, 0.f };
+  glm::mat4 lightView = glm::lookAt(glm::vec3{ 0.f }, this->lightDirection, up);
+  glm::mat4 inverseLightView = glm::inverse(lightView);
+  glm::mat4 viewToLight = lightView * globalUbo.inverseView;
+  // clip space to shadow map uv, the cascades are rendered with an unflipped viewport
+  glm::mat4 uvBias = glm::translate(glm::mat4{ 1.f }, glm::vec3{ .5f, .5f, 0.f }) * glm::scale(glm::mat4{ 1.f }, glm::vec3{ .5f, .5f, 1.f });
+  auto& frameAllocator = this->ctx.getFrameAllocator();
+
+  float sliceStart = nearDepth;
+  for (uint32_t i = 0; i < CascadeCount; i++) {
+    float ratio = static_cast<float>(i + 1) / CascadeCount;
+    float logSplit = splitNear * std::pow(shadowFar / splitNear, ratio);
+    float uniformSplit = splitNear + (shadowFar - splitNear) * ratio;
+    float sliceEnd = glm::mix(uniformSplit, logSplit, SplitLambda);
+
+    // bounding sphere of the slice, in view space so it is the same whatever the camera's orientation
+    std::array<glm::vec3, 8> corners;
+    glm::vec3 center{ 0.f };
+    for (uint32_t c = 0; c < 4; c++) {
+      corners[c] = glm::mix(nearCorners[c], farCorners[c], (sliceStart - nearDepth) / (farDepth - nearDepth));
+      corners[c + 4] = glm::mix(nearCorners[c], farCorners[c], (sliceEnd - nearDepth) / (farDepth - nearDepth));
+      center += corners[c] + corners[c + 4];
+    }
+    center /= 8.f;
+    float radius = 0.f;
+    for (const auto& corner : corners)
+      radius = std::max(radius, glm::length(corner - center));
+    // float noise would resize the cascade every frame
+    radius = std::ceil(radius * 16.f) / 16.f;
+
+    auto& cascade = this->cascades[i];
+    bool cached = i >= FirstCachedCascade;
+    float margin = cached ? radius * CachedMargin : 0.f;
+    float halfExtent = radius + margin;
+    float texelSize = 2.f * halfExtent / Resolution;
+    // whole texels, so the rasterization of static casters doesn't change as the cascade moves
+    float step = cached ? texelSize * std::max(1.f, std::floor(margin / texelSize)) : texelSize;
+    glm::vec3 lightCenter = viewToLight * glm::vec4{ center, 1.f };
+    lightCenter.x = std::round(lightCenter.x / step) * step;
+    lightCenter.y = std::round(lightCenter.y / step) * step;
+    if (cached)
+      lightCenter.z = std::round(lightCenter.z / step) * step;
+    // the light looks down -Z, casters toward the light are kept up to CasterDistance
+    float zNear = -(lightCenter.z + halfExtent + CasterDistance);
+    float zFar = -(lightCenter.z - halfExtent);
+    glm::mat4 projection = glm::orthoRH_ZO(
+      lightCenter.x - halfExtent, lightCenter.x + halfExtent,
+      lightCenter.y - halfExtent, lightCenter.y + halfExtent,
+      zNear, zFar
+    );
+    glm::mat4 viewProjection = projection * lightView;
+
+    cascade.cached = cached;
+    cascade.render = !cached || !this->cacheValid[i] || viewProjection != cascade.viewProjection;
+    cascade.viewProjection = viewProjection;
+    cascade.halfExtent = halfExtent;
+    cascade.depthRange = zFar - zNear;
+    this->cacheValid[i] = true;
+    if (cascade.render) {
+      auto allocation = frameAllocator.write(GlobalUbo{ lightView, projection, viewProjection, inverseLightView });
+      ASSERT(allocation, "CascadedShadows::fitCascades: frame allocator exhausted");
+      cascade.uniformOffset = allocation.offset;
+    }
+
+    ubo.cascadeMatrices[i] = uvBias * viewProjection * globalUbo.inverseView;
+    ubo.splitDepths[i] = sliceEnd;
+    ubo.texelSizes[i] = texelSize;
+    sliceStart = sliceEnd;
+  }
+  ubo.cascadeCount = CascadeCount;
+  return true;
+}
+
+CascadedShadows::GraphImages CascadedShadows::addPasses(RenderGraph& graph, RecordCallback record) {
+  GraphImages graphImages{};
+  if (!this->active)
+    return graphImages;
+  for (uint32_t i = 0; i < CascadeCount; i++) {
+    RenderGraph::ImportedImage image{};
+    image.image = this->images[i].getHandle();
+    image.view = this->images[i].getView();
+    image.format = Format;
+    image.extent = { Resolution, Resolution };
+    // previous frames sampled the map, rendering it again waits for them
+    image.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    image.initialStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    image.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    graphImages.cascades[i] = graph.importImage(ImageNames[i], image);
+    const auto& cascade = this->cascades[i];
+    if (!cascade.render)
+      continue;
+    graph.addPass(PassNames[i], RenderGraph::PassType::Graphics, [record, cascade](RenderGraph::PassContext& context) {
+      record(context, cascade);
+    })
+      .depthAttachment(graphImages.cascades[i], true, true);
+  }
+  return graphImages;
+}
@@ -0,0 +1,169 @@
+#include "renderer/apis/Vulkan/ClusteredLighting.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+#include "renderer/apis/Vulkan/shaders/LightCulling.h"
+
+#include <core/Profiler.h>
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine::Renderers::Vulkan;
+
+static_assert(sizeof(ClusteredLighting::GpuPointLight) == 32);
+static_assert(sizeof(ClusteredLighting::ClusterUbo) == 160);
+
+ClusteredLighting::ClusteredLighting(Renderer& ctx) : ctx(ctx) {
+  this->pointLights.reserve(MaxPointLights);
+  this->createBuffers();
+  this->createDescriptors();
+  this->cullingShader = MakeScope<Shaders::LightCulling>(ctx, *this->descriptorSetLayout);
+}
+
+ClusteredLighting::~ClusteredLighting() {}
+
+void ClusteredLighting::createBuffers() {
+  auto& device = this->ctx.getDevice();
+  this->lightCountBuffer = MakeScope<MemBuffer>(
+    device,
+    sizeof(uint32_t),
+    ClusterCount,
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+  );
+  this->lightIndexBuffer = MakeScope<MemBuffer>(
+    device,
+    sizeof(uint32_t),
+    ClusterCount * MaxLightsPerCluster,
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+  );
+}
+
+void ClusteredLighting::createDescriptors() {
+  auto& device = this->ctx.getDevice();
+  constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  this->descriptorPool = DescriptorPool::Builder(device)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2)
+    .setMaxSets(1)
+    .build();
+  this->descriptorSetLayout = DescriptorSetLayout::Builder(device)
+    .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, stages)
+    .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, stages)
+    .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages)
+    .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages)
+    .build();
+  // the frame's uniforms and lights are selected by the dynamic offsets, the froxel lists are shared by every frame
+  auto& frameAllocator = this->ctx.getFrameAllocator();
+  auto uboInfo = frameAllocator.getDescriptorInfo(sizeof(ClusterUbo));
+  auto lightsInfo = frameAllocator.getDescriptorInfo(MaxPointLights * sizeof(GpuPointLight));
+  auto countsInfo = this->lightCountBuffer->getDescriptorInfo();
+  auto indicesInfo = this->lightIndexBuffer->getDescriptorInfo();
+  DescriptorWriter(*this->descriptorSetLayout, *this->descriptorPool)
+    .write(0, &uboInfo)
+    .write(1, &lightsInfo)
+    .write(2, &countsInfo)
+    .write(3, &indicesInfo)
+    .build(this->descriptorSet);
+}
+
+void ClusteredLighting::beginFrame() {
+  this->pointLights.clear();
+  this->hasGlobalLight = false;
+}
+
+void ClusteredLighting::addPointLight(const glm::vec3& position, const Components::PointLight& light) {
+  if (this->pointLights.size() == MaxPointLights) {
+    if (!this->overflowReported) {
+      LOG_RENDERER_WARN("ClusteredLighting: more than {} point lights, the others are ignored", MaxPointLights);
+      this->overflowReported = true;
+    }
+    return;
+  }
+  this->pointLights.push_back({ glm::vec4{ position, light.range }, light.color });
+}
+
+void ClusteredLighting::setGlobalLight(const glm::vec3& direction, const Components::GlobalLight& light) {
+  this->hasGlobalLight = true;
+  this->globalLightDirection = direction;
+  this->globalLight = light;
+}
+
+void ClusteredLighting::update(const GlobalUbo& globalUbo, VkExtent2D extent) {
+  PROFILE_SCOPE("ClusteredLighting::update");
+  const auto& view = globalUbo.view;
+  const auto& projection = globalUbo.projection;
+  ClusterUbo ubo{};
+  ubo.inverseProjection = glm::inverse(projection);
+  // clip planes from the projection, glm's -1..1 depth range
+  if (projection[2][3] != 0.f) {
+    ubo.nearClip = projection[3][2] / (projection[2][2] - 1.f);
+    ubo.farClip = projection[3][2] / (projection[2][2] + 1.f);
+  }
+  else {
+    ubo.nearClip = (projection[3][2] + 1.f) / projection[2][2];
+    ubo.farClip = (projection[3][2] - 1.f) / projection[2][2];
+  }
+  // slices are exponential, orthographic cameras may start at or behind the eye
+  ubo.nearClip = std::max(ubo.nearClip, .01f);
+  ubo.farClip = std::max(ubo.farClip, ubo.nearClip * 2.f);
+  float logRange = std::log(ubo.farClip / ubo.nearClip);
+  ubo.sliceScale = GridSizeZ / logRange;
+  ubo.sliceBias = -GridSizeZ * std::log(ubo.nearClip) / logRange;
+  ubo.screenSize = { static_cast<float>(extent.width), static_cast<float>(extent.height) };
+  ubo.tileSize = glm::ceil(ubo.screenSize / glm::vec2{ GridSizeX, GridSizeY });
+  ubo.gridSize.w = static_cast<uint32_t>(this->pointLights.size());
+
+  bool unlit = this->pointLights.empty() && !this->hasGlobalLight;
+  ubo.ambient = glm::vec4{ glm::vec3{ unlit ? 1.f : AmbientIntensity }, 0.f };
+  if (this->hasGlobalLight) {
+    ubo.globalLightDirection = glm::vec4{ glm::normalize(glm::mat3(view) * this->globalLightDirection), 1.f };
+    ubo.globalLightColor = this->globalLight.color;
+  }
+
+  auto& frameAllocator = this->ctx.getFrameAllocator();
+  auto uboAllocation = frameAllocator.write(ubo);
+  // the whole range of the lights binding is allocated, the descriptor covers that many bytes past the dynamic offset
+  auto lightsAllocation = frameAllocator.allocate(MaxPointLights * sizeof(GpuPointLight));
+  ASSERT(uboAllocation && lightsAllocation, "ClusteredLighting::update: frame allocator exhausted");
+  auto* lights = static_cast<GpuPointLight*>(lightsAllocation.data);
+  for (size_t i = 0; i < this->pointLights.size(); i++) {
+    const auto& light = this->pointLights[i];
+    glm::vec3 position = view * glm::vec4{ glm::vec3{ light.positionRange }, 1.f };
+    lights[i] = { glm::vec4{ position, light.positionRange.w }, light.color };
+  }
+  this->dynamicOffsets[0] = uboAllocation.offset;
+  this->dynamicOffsets[1] = lightsAllocation.offset;
+}
+
+ClusteredLighting::GraphBuffers ClusteredLighting::addCullingPass(RenderGraph& graph) {
+  GraphBuffers buffers{};
+  // froxel lists are only read when the frame has point lights
+  if (this->pointLights.empty())
+    return buffers;
+  buffers.lightCounts = graph.importBuffer("ClusterLightCounts", this->lightCountBuffer->getHandle());
+  buffers.lightIndices = graph.importBuffer("ClusterLightIndices", this->lightIndexBuffer->getHandle());
+  graph.addPass("LightCulling", RenderGraph::PassType::Compute, [this](RenderGraph::PassContext& context) {
+    this->recordCulling(context.cmdBuffer);
+  })
+    .write(buffers.lightCounts)
+    .write(buffers.lightIndices);
+  return buffers;
+}
+
+void ClusteredLighting::recordCulling(CommandBuffer& cmdBuffer) {
+  this->cullingShader->getPipeline().bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    this->cullingShader->getPipelineLayout(),
+    0, 1, &this->descriptorSet,
+    DynamicOffsetCount, this->dynamicOffsets
+  );
+  // one invocation per froxel
+  uint32_t groupCount = (ClusterCount + Shaders::LightCulling::GroupSize - 1) / Shaders::LightCulling::GroupSize;
+  vkCmdDispatch(cmdBuffer, groupCount, 1, 1);
+}
@@ -1,6 +1,7 @@
 #include <renderer/apis/Vulkan/Device.h>
 #include <renderer/apis/Vulkan/CommandBuffer.h>
 #include <renderer/apis/Vulkan/Fence.h>
+#include <renderer/apis/Vulkan/SamplerCache.h>
 #include <core/EngineInfo.h>
 #include <renderer/logger.h>
 #include <vulkan/vulkan.h>
@@ -11,19 +12,26 @@ using namespace Engine::Renderers::Vulkan;
 
 Device::Device(ApplicationInfo& appInfo, Window& window)
   : appInfo(appInfo), window(window) {
+#if VK_ENABLE_HOST_ALLOCATOR
+  this->hostAllocator = MakeScope<HostAllocator>();
+  this->allocator = this->hostAllocator->getCallbacks();
+#endif
   this->createInstance();
 #ifdef VK_ENABLE_DEBUG_MESSENGER
   this->setupDebugMessenger();
 #endif
-  this->createSurface();
+  if (!this->isHeadless())
+    this->createSurface();
   this->pickPhysicalDevice();
   this->createLogicalDevice();
   LOG_RENDERER_INFO("Vulkan device created.");
   this->createGraphicsCommandPool();
+  this->createSamplerCache();
 }
 
 Device::~Device() {
   LOG_RENDERER_TRACE("Destroying Vulkan device...");
+  this->samplerCache.reset();
   vkDestroyCommandPool(this->logicalDevice, this->graphicsCommandPool, this->allocator);
   vkDestroyDevice(this->logicalDevice, this->allocator);
   vkDestroySurfaceKHR(this->instance, this->surface, this->allocator);
@@ -31,6 +39,8 @@ Device::~Device() {
   DestroyDebugUtilsMessengerEXT(this->instance, this->debugMessenger, this->allocator);
 #endif
   vkDestroyInstance(this->instance, this->allocator);
+  if (this->hostAllocator)
+    this->hostAllocator->logStats();
   LOG_RENDERER_INFO("Vulkan device destroyed.");
 }
 
@@ -95,6 +105,13 @@ std::vector<std::string_view> Device::getRequiredExtensions() const {
   return extensions;
 }
 
+std::vector<std::string_view> Device::getDeviceExtensions() const {
+  // the swapchain extension is useless without a surface, and may be missing on display less drivers
+  if (this->isHeadless())
+    return { VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME };
+  return this->deviceExtensions;
+}
+
 void Device::checkHasWindowRequiredInstanceExtensions() const {
   uint32_t extensionCount = 0;
   vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
@@ -228,13 +245,18 @@ QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice device) const {
       }
     }
 
-    VkBool32 presentSupport = VK_FALSE;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, this->surface, &presentSupport);
-    if (presentSupport) {
-      indices.presentFamily = i;
+    if (this->surface) {
+      VkBool32 presentSupport = VK_FALSE;
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, this->surface, &presentSupport);
+      if (presentSupport) {
+        indices.presentFamily = i;
+      }
     }
     i++;
   }
+  // nothing is ever presented, aliasing the graphics queue keeps the queue setup unchanged
+  if (!this->surface)
+    indices.presentFamily = indices.graphicsFamily;
   return indices;
 }
 
@@ -266,6 +288,8 @@ SwapChainSupportDetails Device::querySwapChainSupportForDevice(VkPhysicalDevice
 }
 
 void Device::querySwapChainSupport() {
+  if (this->isHeadless())
+    return;
   this->physicalDeviceInfo.swapChainSupport = this->querySwapChainSupportForDevice(this->physicalDevice);
 }
 
@@ -328,9 +352,11 @@ bool Device::isDeviceSuitable(VkPhysicalDevice device, const PhysicalDeviceRequi
   // checks for swapchain support also, so it needs to go before querying swapchain support
   if (!this->checkDeviceExtensionSupport(device, requirements))
     return false;
-  info.swapChainSupport = this->querySwapChainSupportForDevice(device);
-  if (info.swapChainSupport.formats.empty() || info.swapChainSupport.presentModes.empty())
-    return false;
+  if (requirements.present) {
+    info.swapChainSupport = this->querySwapChainSupportForDevice(device);
+    if (info.swapChainSupport.formats.empty() || info.swapChainSupport.presentModes.empty())
+      return false;
+  }
   if (requirements.sampleAnisotropy && !deviceFeatures.samplerAnisotropy)
     return false;
   return true;
@@ -348,11 +374,11 @@ void Device::pickPhysicalDevice() {
   PhysicalDeviceRequirements requirements{};
   requirements.graphics = true;
   requirements.compute = true;
-  requirements.present = true;
+  requirements.present = !this->isHeadless();
   requirements.transfer = true;
   requirements.sampleAnisotropy = true;
   requirements.discreteGpu = false;
-  requirements.extensions = this->deviceExtensions;
+  requirements.extensions = this->getDeviceExtensions();
 
   for (auto device : devices) {
     if (this->isDeviceSuitable(device, requirements, this->physicalDeviceInfo)) {
@@ -442,13 +468,19 @@ void Device::createLogicalDevice() {
   VkPhysicalDeviceFeatures deviceFeatures{};
   deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+  // barriers recorded by the render graph
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR };
+  synchronization2Features.synchronization2 = VK_TRUE;
+
   VkDeviceCreateInfo createInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+  createInfo.pNext = &synchronization2Features;
   createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
   createInfo.pEnabledFeatures = &deviceFeatures;
-  std::vector<const char*> extensions(this->deviceExtensions.size());
-  for (size_t i = 0; i < this->deviceExtensions.size(); i++) {
-    extensions[i] = this->deviceExtensions[i].data();
+  const auto deviceExtensions = this->getDeviceExtensions();
+  std::vector<const char*> extensions(deviceExtensions.size());
+  for (size_t i = 0; i < deviceExtensions.size(); i++) {
+    extensions[i] = deviceExtensions[i].data();
   }
   createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
   createInfo.ppEnabledExtensionNames = extensions.data();
@@ -502,6 +534,10 @@ void Device::createGraphicsCommandPool() {
   LOG_RENDERER_INFO("Graphics command pool created.");
 }
 
+void Device::createSamplerCache() {
+  this->samplerCache = MakeScope<SamplerCache>(*this);
+}
+
 void Device::createBuffer(
   VkDeviceSize size,
   VkBufferUsageFlags usage,
@@ -0,0 +1,149 @@
+#include "renderer/apis/Vulkan/FrameCapture.h"
+#include <renderer/ImageWriter.h>
+#include <renderer/logger.h>
+#include <core/Profiler.h>
+
+#include <vector>
+
+using namespace Engine::Renderers::Vulkan;
+
+FrameCapture::FrameCapture(Device& device) : device(device) {
+  this->writer = std::thread([this] { this->writerLoop(); });
+}
+
+FrameCapture::~FrameCapture() {
+  this->device.waitIdle();
+  this->poll();
+  {
+    std::lock_guard lock(this->mutex);
+    this->stopping = true;
+  }
+  this->condition.notify_one();
+  this->writer.join();
+}
+
+void FrameCapture::record(CommandBuffer& cmdBuffer, VkImage image, VkImageLayout layout, VkExtent2D extent, VkFormat format, Fence& fence) {
+  std::string path = std::move(this->requestedPath);
+  this->requestedPath.clear();
+  if (format != VK_FORMAT_B8G8R8A8_UNORM && format != VK_FORMAT_B8G8R8A8_SRGB &&
+    format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB) {
+    LOG_RENDERER_WARN("FrameCapture: unsupported image format {}, {} skipped", static_cast<int>(format), path);
+    return;
+  }
+  Slot* slot = nullptr;
+  for (auto& candidate : this->slots) {
+    if (candidate.state.load(std::memory_order_acquire) == SlotState::Free) {
+      slot = &candidate;
+      break;
+    }
+  }
+  if (!slot) {
+    LOG_RENDERER_WARN("FrameCapture: no free readback slot, {} skipped", path);
+    return;
+  }
+  VkDeviceSize size = VkDeviceSize(extent.width) * extent.height * 4;
+  if (!slot->buffer || slot->buffer->getSize() < size) {
+    slot->buffer = MakeScope<MemBuffer>(
+      this->device, size, 1,
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      1
+    );
+    slot->buffer->map();
+  }
+
+  VkImageMemoryBarrier imageBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+  imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  imageBarrier.oldLayout = layout;
+  imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  imageBarrier.image = image;
+  imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+  vkCmdPipelineBarrier(
+    cmdBuffer,
+    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+    0, 0, nullptr, 0, nullptr, 1, &imageBarrier
+  );
+
+  VkBufferImageCopy region{};
+  region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+  region.imageExtent = { extent.width, extent.height, 1 };
+  vkCmdCopyImageToBuffer(cmdBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *slot->buffer, 1, &region);
+
+  VkBufferMemoryBarrier bufferBarrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+  bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  bufferBarrier.buffer = *slot->buffer;
+  bufferBarrier.size = size;
+  imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  imageBarrier.dstAccessMask = 0;
+  imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  imageBarrier.newLayout = layout;
+  vkCmdPipelineBarrier(
+    cmdBuffer,
+    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+    0, 0, nullptr, 1, &bufferBarrier, 1, &imageBarrier
+  );
+
+  slot->fence = &fence;
+  slot->path = std::move(path);
+  slot->extent = extent;
+  slot->format = format;
+  slot->state.store(SlotState::Recorded, std::memory_order_release);
+}
+
+void FrameCapture::poll() {
+  for (uint32_t i = 0; i < SlotCount; i++) {
+    auto& slot = this->slots[i];
+    if (slot.state.load(std::memory_order_acquire) != SlotState::Recorded)
+      continue;
+    if (vkGetFenceStatus(this->device, *slot.fence) != VK_SUCCESS)
+      continue;
+    slot.state.store(SlotState::Writing, std::memory_order_release);
+    {
+      std::lock_guard lock(this->mutex);
+      this->jobs.push_back(i);
+    }
+    this->condition.notify_one();
+  }
+}
+
+void FrameCapture::writerLoop() {
+  PROFILE_THREAD("FrameCapture");
+  for (;;) {
+    uint32_t index;
+    {
+      std::unique_lock lock(this->mutex);
+      this->condition.wait(lock, [this] { return this->stopping || !this->jobs.empty(); });
+      if (this->jobs.empty())
+        return;
+      index = this->jobs.front();
+      this->jobs.pop_front();
+    }
+    this->write(this->slots[index]);
+  }
+}
+
+void FrameCapture::write(Slot& slot) {
+  PROFILE_SCOPE("FrameCapture::write");
+  const uint32_t width = slot.extent.width, height = slot.extent.height;
+  const auto* mapped = static_cast<const uint8_t*>(slot.buffer->getMappedMemory());
+  // swizzle to RGBA, alpha is meaningless for a presented frame
+  std::vector<uint8_t> pixels(size_t(width) * height * 4);
+  bool bgra = slot.format == VK_FORMAT_B8G8R8A8_UNORM || slot.format == VK_FORMAT_B8G8R8A8_SRGB;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i + 0] = mapped[i + (bgra ? 2 : 0)];
+    pixels[i + 1] = mapped[i + 1];
+    pixels[i + 2] = mapped[i + (bgra ? 0 : 2)];
+    pixels[i + 3] = 255;
+  }
+  std::string path = std::move(slot.path);
+  // the slot can be reused as soon as its content is copied out
+  slot.state.store(SlotState::Free, std::memory_order_release);
+  if (!ImageWriter::Write(path, width, height, pixels.data(), size_t(width) * 4))
+    LOG_RENDERER_ERROR("FrameCapture: failed to write {}", path);
+}
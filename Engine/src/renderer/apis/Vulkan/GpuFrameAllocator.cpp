@@ -0,0 +1,57 @@
+#include "renderer/apis/Vulkan/GpuFrameAllocator.h"
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Engine::Renderers::Vulkan;
+
+GpuFrameAllocator::GpuFrameAllocator(Device& device, uint32_t framesInFlight, VkDeviceSize frameSize) : device(device) {
+  auto& limits = device.getPhysicalDeviceInfo().properties.limits;
+  // every limit is a power of two, regions are also aligned for flushing non coherent memory
+  this->alignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+  this->nonCoherentAtomSize = std::max<VkDeviceSize>(limits.nonCoherentAtomSize, 1);
+  VkDeviceSize regionAlignment = std::lcm(this->alignment, this->nonCoherentAtomSize);
+  this->frameSize = (frameSize + regionAlignment - 1) / regionAlignment * regionAlignment;
+  this->buffer = MakeScope<MemBuffer>(
+    device,
+    this->frameSize,
+    framesInFlight,
+    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+    regionAlignment
+  );
+  // mapped for the allocator's whole lifetime
+  VK_CHECK(this->buffer->map());
+  this->mapped = static_cast<std::byte*>(this->buffer->getMappedMemory());
+}
+
+void GpuFrameAllocator::beginFrame(uint32_t frameIndex) {
+  ASSERT(frameIndex < this->buffer->getInstanceCount(), "GpuFrameAllocator: invalid frame index");
+  this->frameBegin = frameIndex * this->frameSize;
+  this->head = this->frameBegin;
+}
+
+void GpuFrameAllocator::endFrame() {
+  VkDeviceSize used = this->head - this->frameBegin;
+  if (used == 0)
+    return;
+  // flushed once per frame, no-op on coherent memory
+  used = std::min((used + this->nonCoherentAtomSize - 1) / this->nonCoherentAtomSize * this->nonCoherentAtomSize, this->frameSize);
+  VK_CHECK(this->buffer->flush(used, this->frameBegin));
+}
+
+GpuFrameAllocator::Allocation GpuFrameAllocator::allocate(VkDeviceSize size) {
+  VkDeviceSize offset = (this->head + this->alignment - 1) & ~(this->alignment - 1);
+  if (offset + size > this->frameBegin + this->frameSize) {
+    if (!this->overflowReported) {
+      LOG_RENDERER_ERROR("GpuFrameAllocator: frame region of {} bytes exhausted", this->frameSize);
+      this->overflowReported = true;
+    }
+    return {};
+  }
+  this->head = offset + size;
+  this->peakBytes = std::max(this->peakBytes, this->head - this->frameBegin);
+  return { this->mapped + offset, static_cast<uint32_t>(offset), size };
+}
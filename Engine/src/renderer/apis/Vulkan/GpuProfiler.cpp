@@ -0,0 +1,114 @@
+#include "renderer/apis/Vulkan/GpuProfiler.h"
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+
+using namespace Engine::Renderers::Vulkan;
+
+GpuProfiler::GpuProfiler(Device& device, uint32_t framesInFlight) : device(device) {
+  auto& limits = device.getPhysicalDeviceInfo().properties.limits;
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+  uint32_t validBits = families[device.getQueueFamilies().graphicsFamily].timestampValidBits;
+  if (validBits == 0 || limits.timestampPeriod == 0.f) {
+    LOG_RENDERER_WARN("GpuProfiler: timestamps are not supported by the graphics queue");
+    return;
+  }
+  if (validBits < 64)
+    this->timestampMask = (uint64_t{ 1 } << validBits) - 1;
+  this->timestampPeriod = limits.timestampPeriod;
+
+  VkQueryPoolCreateInfo createInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+  createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  createInfo.queryCount = MaxScopesPerFrame * 2;
+  this->pools.resize(framesInFlight);
+  for (auto& queries : this->pools) {
+    VK_CHECK(vkCreateQueryPool(device, &createInfo, device.getAllocator(), &queries.pool));
+    queries.scopes.reserve(MaxScopesPerFrame);
+  }
+  this->results.resize(MaxScopesPerFrame * 2);
+}
+
+GpuProfiler::~GpuProfiler() {
+  for (auto& queries : this->pools)
+    vkDestroyQueryPool(this->device, queries.pool, this->device.getAllocator());
+}
+
+void GpuProfiler::beginFrame(CommandBuffer& cmdBuffer, uint32_t frameIndex) {
+  if (!this->isSupported())
+    return;
+  auto& queries = this->pools[frameIndex];
+  if (queries.recorded)
+    this->resolve(queries);
+  vkCmdResetQueryPool(cmdBuffer, queries.pool, 0, MaxScopesPerFrame * 2);
+  queries.scopes.clear();
+  queries.frame = this->frame++;
+  queries.recorded = false;
+  this->openScopes.clear();
+  this->current = &queries;
+}
+
+void GpuProfiler::beginScope(CommandBuffer& cmdBuffer, std::string_view name) {
+  if (!this->current)
+    return;
+  auto& scopes = this->current->scopes;
+  if (scopes.size() == MaxScopesPerFrame) {
+    this->openScopes.push_back(UINT32_MAX);
+    return;
+  }
+  GpuTiming scope{};
+  scope.name = name;
+  scope.depth = static_cast<uint32_t>(this->openScopes.size());
+  // dropped parents are skipped, the scope attaches to the closest recorded one
+  for (auto it = this->openScopes.rbegin(); it != this->openScopes.rend(); it++) {
+    if (*it != UINT32_MAX) {
+      scope.parent = static_cast<int32_t>(*it);
+      break;
+    }
+  }
+  uint32_t index = static_cast<uint32_t>(scopes.size());
+  scopes.push_back(scope);
+  this->openScopes.push_back(index);
+  vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, this->current->pool, index * 2);
+}
+
+void GpuProfiler::endScope(CommandBuffer& cmdBuffer) {
+  if (!this->current)
+    return;
+  ASSERT(!this->openScopes.empty(), "GpuProfiler::endScope: no open scope");
+  uint32_t index = this->openScopes.back();
+  this->openScopes.pop_back();
+  if (index != UINT32_MAX)
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, this->current->pool, index * 2 + 1);
+}
+
+void GpuProfiler::endFrame() {
+  if (!this->current)
+    return;
+  ASSERT(this->openScopes.empty(), "GpuProfiler::endFrame: scopes left open");
+  this->current->recorded = true;
+  this->current = nullptr;
+}
+
+void GpuProfiler::resolve(FrameQueries& queries) {
+  uint32_t queryCount = static_cast<uint32_t>(queries.scopes.size()) * 2;
+  if (queryCount == 0)
+    return;
+  // the frame's fence was waited, results are available without VK_QUERY_RESULT_WAIT_BIT
+  VkResult result = vkGetQueryPoolResults(
+    this->device, queries.pool, 0, queryCount,
+    queryCount * sizeof(uint64_t), this->results.data(), sizeof(uint64_t),
+    VK_QUERY_RESULT_64_BIT
+  );
+  if (result != VK_SUCCESS)
+    return;
+  const double nanosecondsToMilliseconds = this->timestampPeriod / 1e6;
+  this->timings.frame = queries.frame;
+  this->timings.scopes = queries.scopes;
+  for (size_t i = 0; i < this->timings.scopes.size(); i++) {
+    uint64_t begin = this->results[i * 2] & this->timestampMask;
+    uint64_t end = this->results[i * 2 + 1] & this->timestampMask;
+    this->timings.scopes[i].milliseconds = static_cast<float>(((end - begin) & this->timestampMask) * nanosecondsToMilliseconds);
+  }
+}
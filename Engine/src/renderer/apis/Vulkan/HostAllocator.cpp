@@ -0,0 +1,192 @@
+#include "renderer/apis/Vulkan/HostAllocator.h"
+#include <core/MemoryTracker.h>
+#include <renderer/logger.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using Engine::Renderers::Vulkan::HostAllocator;
+
+namespace {
+  struct CommandArena {
+    std::byte* data = nullptr;
+    size_t offset = 0;
+    // freed from the thread that allocated in practice, atomic in case a driver hands it over
+    std::atomic<uint32_t> live{ 0 };
+
+    // command scope allocations never outlive the call, the block is unused once the thread exits
+    ~CommandArena() { std::free(this->data); }
+  };
+  thread_local CommandArena ThreadArena;
+
+  // Sits right before every pointer handed to the driver
+  struct alignas(std::max_align_t) AllocationHeader {
+    uint64_t size;
+    // distance from the start of the block to the returned pointer
+    uint32_t offset;
+    VkSystemAllocationScope scope;
+    // null for heap allocations
+    CommandArena* arena;
+  };
+
+  std::byte* AlignAfterHeader(std::byte* block, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(block + sizeof(AllocationHeader));
+    return reinterpret_cast<std::byte*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+  }
+
+  AllocationHeader* GetHeader(void* memory) {
+    return static_cast<AllocationHeader*>(memory) - 1;
+  }
+}
+
+HostAllocator::HostAllocator(bool useCommandArena) : useCommandArena(useCommandArena) {
+  this->callbacks.pUserData = this;
+  this->callbacks.pfnAllocation = &HostAllocator::Allocate;
+  this->callbacks.pfnReallocation = &HostAllocator::Reallocate;
+  this->callbacks.pfnFree = &HostAllocator::Free;
+  this->callbacks.pfnInternalAllocation = &HostAllocator::InternalAllocate;
+  this->callbacks.pfnInternalFree = &HostAllocator::InternalFree;
+}
+
+HostAllocator::~HostAllocator() {
+  for (size_t scope = 0; scope < ScopeCount; scope++) {
+    uint64_t live = this->counters[scope].liveBytes.load(std::memory_order_relaxed);
+    if (live)
+      LOG_RENDERER_WARN("HostAllocator: {} bytes of {} scope memory were never freed", live, GetScopeName(static_cast<VkSystemAllocationScope>(scope)));
+  }
+}
+
+std::string_view HostAllocator::GetScopeName(VkSystemAllocationScope scope) {
+  switch (scope) {
+    case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND: return "Command";
+    case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT: return "Object";
+    case VK_SYSTEM_ALLOCATION_SCOPE_CACHE: return "Cache";
+    case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE: return "Device";
+    case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "Instance";
+    default: return "Unknown";
+  }
+}
+
+HostAllocator::ScopeStats HostAllocator::getStats(VkSystemAllocationScope scope) const {
+  auto& counters = this->counters[scope];
+  ScopeStats stats{};
+  stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+  stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+  stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+  stats.frameAllocations = counters.frameAllocations.load(std::memory_order_relaxed);
+  stats.arenaAllocations = counters.arenaAllocations.load(std::memory_order_relaxed);
+  stats.internalBytes = counters.internalBytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void HostAllocator::newFrame() {
+  for (auto& counters : this->counters)
+    counters.frameAllocations.store(0, std::memory_order_relaxed);
+}
+
+void HostAllocator::logStats() const {
+  for (size_t i = 0; i < ScopeCount; i++) {
+    auto stats = this->getStats(static_cast<VkSystemAllocationScope>(i));
+    if (!stats.allocations && !stats.internalBytes)
+      continue;
+    LOG_RENDERER_INFO(
+      "Vulkan host memory, {} scope: peak {} bytes, {} allocations ({} from the command arena), {} internal bytes",
+      GetScopeName(static_cast<VkSystemAllocationScope>(i)), stats.peakBytes, stats.allocations, stats.arenaAllocations, stats.internalBytes
+    );
+  }
+}
+
+void* HostAllocator::allocate(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+  alignment = std::max(alignment, alignof(AllocationHeader));
+  // the padding only covers blocks starting header aligned, arena blocks are carved back to back so their size is rounded up
+  const size_t blockSize = (size + sizeof(AllocationHeader) + alignment - 1) & ~(alignof(AllocationHeader) - 1);
+  std::byte* block = nullptr;
+  CommandArena* arena = nullptr;
+  if (this->useCommandArena && scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND) {
+    auto& threadArena = ThreadArena;
+    if (!threadArena.data)
+      threadArena.data = static_cast<std::byte*>(std::malloc(CommandArenaSize));
+    if (threadArena.live.load(std::memory_order_acquire) == 0)
+      threadArena.offset = 0;
+    // too large or arena full, falls back to the heap
+    if (threadArena.data && threadArena.offset + blockSize <= CommandArenaSize) {
+      block = threadArena.data + threadArena.offset;
+      threadArena.offset += blockSize;
+      threadArena.live.fetch_add(1, std::memory_order_relaxed);
+      arena = &threadArena;
+    }
+  }
+  if (!block) {
+    block = static_cast<std::byte*>(std::malloc(blockSize));
+    if (!block)
+      return nullptr;
+    MemoryTracker::OnAllocate(MemoryTag::Renderer, size);
+  }
+
+  std::byte* result = AlignAfterHeader(block, alignment);
+  auto* header = GetHeader(result);
+  header->size = size;
+  header->offset = static_cast<uint32_t>(result - block);
+  header->scope = scope;
+  header->arena = arena;
+
+  auto& counters = this->counters[scope];
+  uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (arena)
+    counters.arenaAllocations.fetch_add(1, std::memory_order_relaxed);
+  return result;
+}
+
+void* HostAllocator::reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+  if (!original)
+    return this->allocate(size, alignment, scope);
+  if (size == 0) {
+    this->free(original);
+    return nullptr;
+  }
+  void* result = this->allocate(size, alignment, scope);
+  // the original must stay valid if the reallocation fails
+  if (!result)
+    return nullptr;
+  std::memcpy(result, original, std::min<size_t>(size, GetHeader(original)->size));
+  this->free(original);
+  return result;
+}
+
+void HostAllocator::free(void* memory) {
+  if (!memory)
+    return;
+  auto* header = GetHeader(memory);
+  this->counters[header->scope].liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+  if (header->arena) {
+    header->arena->live.fetch_sub(1, std::memory_order_release);
+    return;
+  }
+  MemoryTracker::OnFree(MemoryTag::Renderer, header->size);
+  std::free(static_cast<std::byte*>(memory) - header->offset);
+}
+
+void* HostAllocator::Allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+  return static_cast<HostAllocator*>(userData)->allocate(size, alignment, scope);
+}
+
+void* HostAllocator::Reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+  return static_cast<HostAllocator*>(userData)->reallocate(original, size, alignment, scope);
+}
+
+void HostAllocator::Free(void* userData, void* memory) {
+  static_cast<HostAllocator*>(userData)->free(memory);
+}
+
+void HostAllocator::InternalAllocate(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+  static_cast<HostAllocator*>(userData)->counters[scope].internalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void HostAllocator::InternalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+  static_cast<HostAllocator*>(userData)->counters[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
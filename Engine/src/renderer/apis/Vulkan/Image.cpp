@@ -76,7 +76,7 @@ void Image::init(const ImageCreateInfo& createInfo) {
 
 void Image::createView(const ImageViewCreateInfo& createViewInfo) {
   ASSERT(this->view == VK_NULL_HANDLE, "Image view already exists");
-  this->viewAspectFlags = viewAspectFlags;
+  this->viewAspectFlags = createViewInfo.aspectMask;
   VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
   viewInfo.image = this->handle;
   switch (this->type) {
@@ -98,13 +98,68 @@ void Image::createView(const ImageViewCreateInfo& createViewInfo) {
   VK_CHECK(vkCreateImageView(this->device, &viewInfo, this->device.getAllocator(), &this->view));
 }
 
+namespace {
+  struct LayoutAccess {
+    VkPipelineStageFlags2KHR stages;
+    VkAccessFlags2KHR access;
+  };
+  // accesses an image is expected to see in a layout, both before and after a transition
+  LayoutAccess GetLayoutAccess(VkImageLayout layout) {
+    switch (layout) {
+      case VK_IMAGE_LAYOUT_UNDEFINED:
+      case VK_IMAGE_LAYOUT_PREINITIALIZED:
+        return { VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR };
+      case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        return { VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR };
+      case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        return { VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR };
+      case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        return {
+          VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+          VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR
+        };
+      case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        return {
+          VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+          VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+        };
+      case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        return {
+          VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+          VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR
+        };
+      case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        return {
+          VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+          VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR
+        };
+      case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        // ordered by the present semaphore
+        return { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_NONE_KHR };
+      default:
+        return { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR };
+    }
+  }
+}
+
 void Image::transitionLayout(
   CommandBuffer& cmdBuffer,
   uint32_t queueFamilyIndex,
   VkImageLayout oldLayout,
   VkImageLayout newLayout
 ) {
-  VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+  // per frame images go through the render graph, this is for uploads and one off transitions
+  auto src = GetLayoutAccess(oldLayout);
+  auto dst = GetLayoutAccess(newLayout);
+  VkImageMemoryBarrier2KHR barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR };
+  barrier.srcStageMask = src.stages;
+  // only writes need to be made available
+  barrier.srcAccessMask = src.access & (
+    VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+  );
+  barrier.dstStageMask = dst.stages;
+  barrier.dstAccessMask = dst.access;
   barrier.oldLayout = oldLayout;
   barrier.newLayout = newLayout;
   barrier.srcQueueFamilyIndex = queueFamilyIndex;
@@ -112,39 +167,14 @@ void Image::transitionLayout(
   barrier.image = this->handle;
   barrier.subresourceRange.aspectMask = this->viewAspectFlags;
   barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
   barrier.subresourceRange.baseArrayLayer = 0;
-  barrier.subresourceRange.layerCount = 1;
-
-  VkPipelineStageFlags sourceStage;
-  VkPipelineStageFlags destinationStage;
-
-  if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
 
-    sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-  }
-  else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-  }
-  else
-    ASSERT(false, "Unsupported layout transition");
-
-  vkCmdPipelineBarrier(
-    cmdBuffer,
-    sourceStage,
-    destinationStage,
-    0,
-    0, nullptr,
-    0, nullptr,
-    1, &barrier
-  );
+  VkDependencyInfoKHR dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR };
+  dependencyInfo.imageMemoryBarrierCount = 1;
+  dependencyInfo.pImageMemoryBarriers = &barrier;
+  CmdPipelineBarrier2(this->device, cmdBuffer, &dependencyInfo);
 }
 
 void Image::copyFromBuffer(
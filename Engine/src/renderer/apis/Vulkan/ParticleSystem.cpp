@@ -0,0 +1,223 @@
+#include "renderer/apis/Vulkan/ParticleSystem.h"
+#include "renderer/apis/Vulkan/BillboardRenderer.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+#include "renderer/apis/Vulkan/shaders/Particles.h"
+
+#include <core/Profiler.h>
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+using namespace Engine::Renderers::Vulkan;
+
+static_assert(sizeof(ParticleSystem::GpuParticle) == 64);
+static_assert(sizeof(ParticleSystem::GpuEmitter) == 112);
+static_assert(offsetof(ParticleSystem::IndirectArgs, draw) == 16);
+static_assert(ParticleSystem::MaxEmitters * sizeof(ParticleSystem::GpuEmitter) <= 16384);
+
+static uint32_t GetGroupCount(uint32_t invocations) {
+  constexpr uint32_t groupSize = Shaders::Particles::GroupSize;
+  return (invocations + groupSize - 1) / groupSize;
+}
+
+ParticleSystem::ParticleSystem(Renderer& ctx, BillboardRenderer& billboards) : ctx(ctx), billboards(billboards) {
+  this->emitters.reserve(MaxEmitters);
+  this->createBuffers();
+  this->createDescriptors(billboards.getInstanceSetLayout());
+  using Kernel = Shaders::Particles::Kernel;
+  uint32_t pushConstantsSize = sizeof(PushConstants);
+  this->resetKernel = MakeScope<Shaders::Particles>(ctx, Kernel::Reset, *this->descriptorSetLayout, pushConstantsSize);
+  this->kickoffKernel = MakeScope<Shaders::Particles>(ctx, Kernel::Kickoff, *this->descriptorSetLayout, pushConstantsSize);
+  this->emitKernel = MakeScope<Shaders::Particles>(ctx, Kernel::Emit, *this->descriptorSetLayout, pushConstantsSize);
+  this->simulateKernel = MakeScope<Shaders::Particles>(ctx, Kernel::Simulate, *this->descriptorSetLayout, pushConstantsSize);
+}
+
+ParticleSystem::~ParticleSystem() {}
+
+void ParticleSystem::createBuffers() {
+  auto& device = this->ctx.getDevice();
+  auto createStorage = [&device](VkDeviceSize instanceSize, uint32_t count, VkBufferUsageFlags usage = 0) {
+    return MakeScope<MemBuffer>(
+      device,
+      instanceSize,
+      count,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    );
+  };
+  this->particleBuffer = createStorage(sizeof(GpuParticle), MaxParticles);
+  this->deadListBuffer = createStorage(sizeof(uint32_t), MaxParticles);
+  // both alive lists back to back
+  this->aliveListBuffer = createStorage(sizeof(uint32_t), MaxParticles * 2);
+  this->counterBuffer = createStorage(sizeof(Counters), 1);
+  this->indirectBuffer = createStorage(sizeof(IndirectArgs), 1, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+  this->instanceBuffer = createStorage(sizeof(BillboardRenderer::Instance), MaxParticles);
+}
+
+void ParticleSystem::createDescriptors(DescriptorSetLayout& instanceSetLayout) {
+  auto& device = this->ctx.getDevice();
+  this->descriptorPool = DescriptorPool::Builder(device)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+    .setMaxSets(2)
+    .build();
+  this->descriptorSetLayout = DescriptorSetLayout::Builder(device)
+    .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+    .addBinding(6, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+    .build();
+  auto particlesInfo = this->particleBuffer->getDescriptorInfo();
+  auto deadListInfo = this->deadListBuffer->getDescriptorInfo();
+  auto aliveListInfo = this->aliveListBuffer->getDescriptorInfo();
+  auto countersInfo = this->counterBuffer->getDescriptorInfo();
+  auto indirectInfo = this->indirectBuffer->getDescriptorInfo();
+  auto instancesInfo = this->instanceBuffer->getDescriptorInfo();
+  // the frame's emitters are selected by the dynamic offset
+  auto emittersInfo = this->ctx.getFrameAllocator().getDescriptorInfo(MaxEmitters * sizeof(GpuEmitter));
+  DescriptorWriter(*this->descriptorSetLayout, *this->descriptorPool)
+    .write(0, &particlesInfo)
+    .write(1, &deadListInfo)
+    .write(2, &aliveListInfo)
+    .write(3, &countersInfo)
+    .write(4, &indirectInfo)
+    .write(5, &instancesInfo)
+    .write(6, &emittersInfo)
+    .build(this->descriptorSet);
+
+  DescriptorWriter(instanceSetLayout, *this->descriptorPool)
+    .write(0, &instancesInfo)
+    .build(this->instanceSet);
+}
+
+void ParticleSystem::beginFrame() {
+  this->emitters.clear();
+  this->requestedCount = 0;
+  this->drawThisFrame = false;
+}
+
+void ParticleSystem::emit(const glm::vec3& position, const Components::ParticleEmitter& emitter, uint32_t count) {
+  count = std::min(count, MaxParticles - this->requestedCount);
+  if (count == 0)
+    return;
+  if (this->emitters.size() == MaxEmitters) {
+    if (!this->overflowReported) {
+      LOG_RENDERER_WARN("ParticleSystem: more than {} emitters in a frame, the others are ignored", MaxEmitters);
+      this->overflowReported = true;
+    }
+    return;
+  }
+  this->emitters.push_back({
+    glm::vec4{ position, emitter.radius },
+    glm::vec4{ emitter.velocity, emitter.spread },
+    glm::vec4{ emitter.acceleration, emitter.rounded ? 1.f : 0.f },
+    emitter.startColor,
+    emitter.endColor,
+    glm::vec4{ emitter.lifetime.x, std::max(emitter.lifetime.x, emitter.lifetime.y), emitter.startSize, emitter.endSize },
+    glm::uvec4{ this->requestedCount, count, 0, 0 }
+  });
+  this->requestedCount += count;
+  this->activeTime = std::max(this->activeTime, std::max(emitter.lifetime.x, emitter.lifetime.y));
+}
+
+ParticleSystem::GraphBuffers ParticleSystem::addPasses(RenderGraph& graph, float deltaTime) {
+  PROFILE_SCOPE("ParticleSystem::addPasses");
+  GraphBuffers buffers{};
+  // particles left in an alive list while skipped expire on the next simulation
+  bool active = this->requestedCount > 0 || this->activeTime > 0.f;
+  this->activeTime -= deltaTime;
+  if (!active)
+    return buffers;
+
+  if (this->requestedCount > 0) {
+    // the whole block is allocated, the descriptor range covers MaxEmitters
+    auto allocation = this->ctx.getFrameAllocator().allocate(MaxEmitters * sizeof(GpuEmitter));
+    if (!allocation)
+      return buffers;
+    std::memcpy(allocation.data, this->emitters.data(), this->emitters.size() * sizeof(GpuEmitter));
+    this->emitterOffset = allocation.offset;
+  }
+  PushConstants pushConstants{};
+  pushConstants.deltaTime = deltaTime;
+  pushConstants.emitCount = this->requestedCount;
+  pushConstants.emitterCount = static_cast<uint32_t>(this->emitters.size());
+  pushConstants.seed = this->frame++;
+  pushConstants.aliveList = this->aliveList;
+  this->aliveList ^= 1;
+
+  auto particles = graph.importBuffer("Particles", this->particleBuffer->getHandle());
+  auto deadList = graph.importBuffer("ParticleDeadList", this->deadListBuffer->getHandle());
+  auto aliveLists = graph.importBuffer("ParticleAliveLists", this->aliveListBuffer->getHandle());
+  auto counters = graph.importBuffer("ParticleCounters", this->counterBuffer->getHandle());
+  buffers.indirectArgs = graph.importBuffer("ParticleIndirectArgs", this->indirectBuffer->getHandle());
+  buffers.instances = graph.importBuffer("ParticleInstances", this->instanceBuffer->getHandle());
+
+  if (this->needsReset) {
+    graph.addPass("ParticleReset", RenderGraph::PassType::Compute, [this, pushConstants](RenderGraph::PassContext& context) {
+      this->bindKernel(context.cmdBuffer, *this->resetKernel, pushConstants);
+      vkCmdDispatch(context.cmdBuffer, GetGroupCount(MaxParticles), 1, 1);
+    })
+      .write(deadList)
+      .write(counters);
+    this->needsReset = false;
+  }
+  graph.addPass("ParticleKickoff", RenderGraph::PassType::Compute, [this, pushConstants](RenderGraph::PassContext& context) {
+    this->bindKernel(context.cmdBuffer, *this->kickoffKernel, pushConstants);
+    vkCmdDispatch(context.cmdBuffer, 1, 1, 1);
+  })
+    .write(counters)
+    .write(buffers.indirectArgs);
+  if (this->requestedCount > 0) {
+    graph.addPass("ParticleEmit", RenderGraph::PassType::Compute, [this, pushConstants](RenderGraph::PassContext& context) {
+      this->bindKernel(context.cmdBuffer, *this->emitKernel, pushConstants);
+      vkCmdDispatch(context.cmdBuffer, GetGroupCount(pushConstants.emitCount), 1, 1);
+    })
+      .write(particles)
+      .write(deadList)
+      .write(aliveLists)
+      .write(counters);
+  }
+  // the dispatch size is read before the invocations add to the draw's instance count
+  graph.addPass("ParticleSimulate", RenderGraph::PassType::Compute, [this, pushConstants](RenderGraph::PassContext& context) {
+    this->bindKernel(context.cmdBuffer, *this->simulateKernel, pushConstants);
+    vkCmdDispatchIndirect(context.cmdBuffer, this->indirectBuffer->getHandle(), offsetof(IndirectArgs, simulate));
+  })
+    .read(buffers.indirectArgs, RenderGraph::BufferUsage::Indirect)
+    .write(buffers.indirectArgs)
+    .write(particles)
+    .write(deadList)
+    .write(aliveLists)
+    .write(counters)
+    .write(buffers.instances);
+  this->drawThisFrame = true;
+  return buffers;
+}
+
+void ParticleSystem::bindKernel(CommandBuffer& cmdBuffer, const Shaders::Particles& kernel, const PushConstants& pushConstants) {
+  kernel.getPipeline().bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    kernel.getPipelineLayout(),
+    0, 1, &this->descriptorSet,
+    1, &this->emitterOffset
+  );
+  vkCmdPushConstants(
+    cmdBuffer,
+    kernel.getPipelineLayout(),
+    VK_SHADER_STAGE_COMPUTE_BIT,
+    0, sizeof(PushConstants), &pushConstants
+  );
+}
+
+void ParticleSystem::record(VkFrameInfo& frameInfo) {
+  if (!this->drawThisFrame)
+    return;
+  this->billboards.recordIndirect(frameInfo, this->instanceSet, this->indirectBuffer->getHandle(), offsetof(IndirectArgs, draw));
+}
@@ -82,10 +82,40 @@ void Pipeline::createGraphicsPipeline(
   throw std::runtime_error(std::format("Failed to create graphics pipeline - {}", CallResultToString(result, true)));
 }
 
+void Pipeline::createComputePipeline(
+  const ConfigInfo& configInfo
+) {
+  ASSERT(configInfo.pipelineLayout != VK_NULL_HANDLE, "pipeline layout is null");
+
+  VkComputePipelineCreateInfo pipelineInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+  pipelineInfo.stage = configInfo.stages[0];
+  pipelineInfo.layout = configInfo.pipelineLayout;
+  pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+  pipelineInfo.basePipelineIndex = -1;
+
+  VkResult result = vkCreateComputePipelines(
+    this->device.getHandle(),
+    VK_NULL_HANDLE,
+    1,
+    &pipelineInfo,
+    this->device.getAllocator(),
+    &this->handle
+  );
+  if (IsCallResultSuccess(result)) {
+    LOG_RENDERER_INFO("Created compute pipeline");
+    return;
+  }
+  throw std::runtime_error(std::format("Failed to create compute pipeline - {}", CallResultToString(result, true)));
+}
+
 void Pipeline::init(ConfigInfo& configInfo) {
   this->createLayout(configInfo);
   configInfo.pipelineLayout = this->layout;
-  this->createGraphicsPipeline(configInfo);
+  this->compute = configInfo.stages.size() == 1 && configInfo.stages[0].stage == VK_SHADER_STAGE_COMPUTE_BIT;
+  if (this->compute)
+    this->createComputePipeline(configInfo);
+  else
+    this->createGraphicsPipeline(configInfo);
 }
 
 void Pipeline::SetupDefaultConfigInfo(Pipeline::ConfigInfo& configInfo) {
@@ -188,5 +218,6 @@ PipelineConfigInfo& PipelineConfigInfo::enableRasterizationCulling(VkCullModeFla
 }
 
 void Pipeline::bind(CommandBuffer& cmdBuffer, VkPipelineBindPoint bindPoint) {
+  ASSERT(!this->compute || bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE, "compute pipeline bound to the graphics bind point");
   vkCmdBindPipeline(cmdBuffer, bindPoint, this->handle);
 }
\ No newline at end of file
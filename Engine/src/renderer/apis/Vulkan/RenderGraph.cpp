@@ -0,0 +1,711 @@
+#include "renderer/apis/Vulkan/RenderGraph.h"
+#include "renderer/apis/Vulkan/GpuProfiler.h"
+#include <core/Profiler.h>
+#include <renderer/logger.h>
+#include <utils/asserts.h>
+#include <utils/hash.h>
+
+#include <algorithm>
+
+using namespace Engine::Renderers::Vulkan;
+
+namespace {
+  constexpr VkPipelineStageFlags2KHR DepthStages =
+    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR;
+  constexpr VkAccessFlags2KHR WriteAccess =
+    VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+    VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_HOST_WRITE_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+  VkImageAspectFlags GetAspect(VkFormat format) {
+    switch (format) {
+      case VK_FORMAT_D16_UNORM:
+      case VK_FORMAT_X8_D24_UNORM_PACK32:
+      case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+      case VK_FORMAT_D16_UNORM_S8_UINT:
+      case VK_FORMAT_D24_UNORM_S8_UINT:
+      case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+      default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+  }
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::colorAttachment(ImageHandle image, bool clear, const glm::vec4& clearColor) {
+  auto& pass = this->graph.getPass(this->pass);
+  ASSERT(pass.type == PassType::Graphics, "RenderGraph: attachments need a graphics pass");
+  Attachment attachment{ image.index, clear, true };
+  attachment.clearValue.color = { clearColor.r, clearColor.g, clearColor.b, clearColor.a };
+  pass.colors.push_back(attachment);
+  Access access{
+    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR | (clear ? 0 : VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR),
+    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+    true, clear
+  };
+  this->graph.useImage(this->pass, image.index, access, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::depthAttachment(ImageHandle image, bool write, bool clear, float clearDepth) {
+  auto& pass = this->graph.getPass(this->pass);
+  ASSERT(pass.type == PassType::Graphics, "RenderGraph: attachments need a graphics pass");
+  ASSERT(write || !clear, "RenderGraph: a read only depth attachment cannot be cleared");
+  Attachment attachment{ image.index, clear, write };
+  attachment.clearValue.depthStencil = { clearDepth, 0 };
+  pass.depth = attachment;
+  Access access{
+    DepthStages,
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | (write ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR : 0),
+    write ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+    write, clear
+  };
+  this->graph.useImage(this->pass, image.index, access, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::sample(ImageHandle image) {
+  auto& pass = this->graph.getPass(this->pass);
+  Access access{
+    pass.type == PassType::Compute ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR : VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+    VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR,
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+  };
+  this->graph.useImage(this->pass, image.index, access, VK_IMAGE_USAGE_SAMPLED_BIT);
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(BufferHandle buffer, BufferUsage usage) {
+  auto& pass = this->graph.getPass(this->pass);
+  auto access = this->graph.getBufferAccess(pass.type, usage);
+  ASSERT(!access.write, "RenderGraph: buffer usage is a write");
+  pass.buffers.push_back({ buffer.index, access });
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(BufferHandle buffer, BufferUsage usage) {
+  auto& pass = this->graph.getPass(this->pass);
+  auto access = this->graph.getBufferAccess(pass.type, usage);
+  ASSERT(access.write, "RenderGraph: buffer usage is a read");
+  pass.buffers.push_back({ buffer.index, access });
+  return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::setSideEffects() {
+  this->graph.getPass(this->pass).sideEffects = true;
+  return *this;
+}
+
+RenderGraph::RenderGraph(Device& device, uint32_t framesInFlight) : device(device), framesInFlight(framesInFlight) {}
+
+RenderGraph::~RenderGraph() {
+  this->releaseResources();
+  for (auto& [key, renderPass] : this->renderPasses)
+    vkDestroyRenderPass(this->device, renderPass, this->device.getAllocator());
+}
+
+void RenderGraph::reset() {
+  this->frame++;
+  this->destroyRetired(false);
+  // framebuffers unused for a whole round of frames in flight may reference views that no longer exist
+  std::erase_if(this->framebuffers, [this](const auto& entry) {
+    if (this->frame - entry.second.lastUsedFrame <= this->framesInFlight)
+      return false;
+    vkDestroyFramebuffer(this->device, entry.second.handle, this->device.getAllocator());
+    return true;
+  });
+  this->passCount = 0;
+  this->imageCount = 0;
+  this->bufferCount = 0;
+  this->finalBarriers.clear();
+  this->compiled = false;
+}
+
+RenderGraph::ImageHandle RenderGraph::importImage(std::string_view name, const ImportedImage& image) {
+  if (this->imageCount == this->images.size())
+    this->images.emplace_back();
+  auto& resource = this->images[this->imageCount];
+  resource = ImageResource{};
+  resource.name = name;
+  resource.imported = true;
+  resource.import = image;
+  resource.aspect = GetAspect(image.format);
+  return { this->imageCount++ };
+}
+
+RenderGraph::ImageHandle RenderGraph::createImage(std::string_view name, const ImageDesc& desc) {
+  if (this->imageCount == this->images.size())
+    this->images.emplace_back();
+  auto& resource = this->images[this->imageCount];
+  resource = ImageResource{};
+  resource.name = name;
+  resource.import.format = desc.format;
+  resource.import.extent = desc.extent;
+  resource.aspect = GetAspect(desc.format);
+  return { this->imageCount++ };
+}
+
+RenderGraph::BufferHandle RenderGraph::importBuffer(std::string_view name, VkBuffer buffer) {
+  if (this->bufferCount == this->buffers.size())
+    this->buffers.emplace_back();
+  auto& resource = this->buffers[this->bufferCount];
+  resource = BufferResource{};
+  resource.name = name;
+  resource.buffer = buffer;
+  // buffers outlive the graph, the accesses of previous frames must be waited on
+  auto it = this->bufferStates.find(buffer);
+  if (it != this->bufferStates.end())
+    resource.state = it->second;
+  return { this->bufferCount++ };
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(std::string_view name, PassType type, ExecuteCallback execute) {
+  if (this->passCount == this->passes.size())
+    this->passes.emplace_back();
+  auto& pass = this->passes[this->passCount];
+  // vectors keep their capacity across frames
+  pass.name = name;
+  pass.type = type;
+  pass.execute = std::move(execute);
+  pass.colors.clear();
+  pass.depth = {};
+  pass.images.clear();
+  pass.buffers.clear();
+  pass.sideEffects = false;
+  pass.culled = false;
+  pass.imageBarriers.clear();
+  pass.bufferBarriers.clear();
+  pass.renderPass = VK_NULL_HANDLE;
+  pass.framebuffer = VK_NULL_HANDLE;
+  pass.clearValues.clear();
+  return PassBuilder(*this, this->passCount++);
+}
+
+void RenderGraph::useImage(uint32_t pass, uint32_t image, const Access& access, VkImageUsageFlags usage) {
+  ASSERT(image < this->imageCount, "RenderGraph: invalid image handle");
+  this->passes[pass].images.push_back({ image, access });
+  this->images[image].usage |= usage;
+}
+
+RenderGraph::Access RenderGraph::getBufferAccess(PassType type, BufferUsage usage) const {
+  VkPipelineStageFlags2KHR shaderStages = type == PassType::Compute
+    ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR
+    : VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+  switch (usage) {
+    case BufferUsage::Vertex:
+      return { VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR };
+    case BufferUsage::Index:
+      return { VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR, VK_ACCESS_2_INDEX_READ_BIT_KHR };
+    case BufferUsage::Indirect:
+      return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR };
+    case BufferUsage::Uniform:
+      return { shaderStages, VK_ACCESS_2_UNIFORM_READ_BIT_KHR };
+    case BufferUsage::StorageRead:
+      return { shaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR };
+    case BufferUsage::StorageWrite:
+      return { shaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_UNDEFINED, true };
+    case BufferUsage::TransferSrc:
+      return { VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR };
+    case BufferUsage::TransferDst:
+      return { VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_UNDEFINED, true };
+  }
+  return {};
+}
+
+void RenderGraph::cull() {
+  // walks the passes backwards: a pass is kept if it writes something a kept pass reads later, or an imported resource
+  this->imageNeeded.assign(this->imageCount, 0);
+  for (uint32_t i = 0; i < this->imageCount; i++)
+    this->imageNeeded[i] = this->images[i].imported;
+  this->stats.passes = this->passCount;
+  this->stats.culledPasses = 0;
+  for (uint32_t i = this->passCount; i-- > 0;) {
+    auto& pass = this->passes[i];
+    bool alive = pass.sideEffects;
+    for (const auto& use : pass.images)
+      alive |= use.access.write && this->imageNeeded[use.image];
+    // buffers are all imported
+    for (const auto& use : pass.buffers)
+      alive |= use.access.write;
+    pass.culled = !alive;
+    if (pass.culled) {
+      this->stats.culledPasses++;
+      continue;
+    }
+    for (const auto& use : pass.images) {
+      if (use.access.discard)
+        this->imageNeeded[use.image] = this->images[use.image].imported;
+    }
+    for (const auto& use : pass.images) {
+      if (!use.access.discard)
+        this->imageNeeded[use.image] = 1;
+    }
+  }
+}
+
+void RenderGraph::compile() {
+  PROFILE_SCOPE("RenderGraph::compile");
+  this->cull();
+  for (uint32_t i = 0; i < this->passCount; i++) {
+    if (this->passes[i].culled)
+      continue;
+    for (const auto& use : this->passes[i].images) {
+      auto& image = this->images[use.image];
+      image.firstPass = std::min(image.firstPass, i);
+      image.lastPass = std::max(image.lastPass, i);
+    }
+  }
+  this->allocateTransientImages();
+
+  for (uint32_t i = 0; i < this->imageCount; i++) {
+    auto& image = this->images[i];
+    image.state = {};
+    image.written = false;
+    if (image.imported) {
+      image.state.layout = image.import.initialLayout;
+      image.state.writeStages = image.import.initialStage;
+      image.state.writeAccess = image.import.initialAccess;
+    }
+  }
+  this->stats.barriers = 0;
+  for (uint32_t i = 0; i < this->passCount; i++) {
+    auto& pass = this->passes[i];
+    if (pass.culled)
+      continue;
+    // load ops depend on what was written before the pass
+    if (pass.type == PassType::Graphics)
+      this->createRenderPass(pass, i);
+    this->computeBarriers(pass, i);
+  }
+
+  for (uint32_t i = 0; i < this->imageCount; i++) {
+    auto& image = this->images[i];
+    if (!image.imported || image.import.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || image.import.finalLayout == image.state.layout)
+      continue;
+    VkImageMemoryBarrier2KHR barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR };
+    barrier.srcStageMask = image.state.writeStages | image.state.readStages;
+    barrier.srcAccessMask = image.state.writeAccess;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+    // presentation is ordered by the semaphore signaled at submission
+    barrier.dstAccessMask = image.import.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+      ? VK_ACCESS_2_NONE_KHR
+      : VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+    barrier.oldLayout = image.state.layout;
+    barrier.newLayout = image.import.finalLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image.import.image;
+    barrier.subresourceRange = { image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+    this->finalBarriers.push_back(barrier);
+    this->stats.barriers++;
+  }
+  this->compiled = true;
+}
+
+bool RenderGraph::transition(
+  ResourceState& state, const Access& access, bool isImage,
+  VkPipelineStageFlags2KHR& srcStages, VkAccessFlags2KHR& srcAccess
+) {
+  bool layoutChange = isImage && state.layout != access.layout;
+  if (layoutChange || access.write) {
+    // writes and layout transitions wait on every access since the last write
+    srcStages = state.writeStages | state.readStages;
+    srcAccess = state.writeAccess;
+    bool needed = layoutChange || srcStages != VK_PIPELINE_STAGE_2_NONE_KHR;
+    if (isImage)
+      state.layout = access.layout;
+    if (access.write) {
+      state.writeStages = access.stages;
+      state.writeAccess = access.access & WriteAccess;
+      state.readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+      state.readAccess = VK_ACCESS_2_NONE_KHR;
+    }
+    else {
+      // reads in other stages chain on this transition
+      state.writeStages = access.stages;
+      state.writeAccess = VK_ACCESS_2_NONE_KHR;
+      state.readStages = access.stages;
+      state.readAccess = access.access;
+    }
+    return needed;
+  }
+  // reads only wait on the last write, once per stage and access
+  bool covered = (access.stages & ~state.readStages) == 0 && (access.access & ~state.readAccess) == 0;
+  srcStages = state.writeStages;
+  srcAccess = state.writeAccess;
+  state.readStages |= access.stages;
+  state.readAccess |= access.access;
+  return srcStages != VK_PIPELINE_STAGE_2_NONE_KHR && !covered;
+}
+
+void RenderGraph::computeBarriers(Pass& pass, uint32_t passIndex) {
+  for (const auto& use : pass.images) {
+    auto& image = this->images[use.image];
+    MemoryBlock* block = image.imported ? nullptr : &this->memoryBlocks[this->physicalImages[image.physical].block];
+    // the memory may have been used by another image, or by this one in a previous frame
+    if (block && image.firstPass == passIndex && image.state.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+      image.state.writeStages = block->lastStages;
+      image.state.writeAccess = block->lastWriteAccess;
+    }
+    VkImageLayout oldLayout = image.state.layout;
+    VkPipelineStageFlags2KHR srcStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR srcAccess = VK_ACCESS_2_NONE_KHR;
+    if (this->transition(image.state, use.access, true, srcStages, srcAccess)) {
+      VkImageMemoryBarrier2KHR barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR };
+      barrier.srcStageMask = srcStages;
+      barrier.srcAccessMask = srcAccess;
+      barrier.dstStageMask = use.access.stages;
+      barrier.dstAccessMask = use.access.access;
+      // content that is discarded is never transitioned
+      barrier.oldLayout = use.access.discard ? VK_IMAGE_LAYOUT_UNDEFINED : oldLayout;
+      barrier.newLayout = use.access.layout;
+      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.image = this->getImage({ use.image });
+      barrier.subresourceRange = { image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+      pass.imageBarriers.push_back(barrier);
+      this->stats.barriers++;
+    }
+    image.written |= use.access.write;
+    if (block) {
+      block->lastStages = image.state.writeStages | image.state.readStages;
+      block->lastWriteAccess = image.state.writeAccess;
+    }
+  }
+  for (const auto& use : pass.buffers) {
+    auto& buffer = this->buffers[use.buffer];
+    VkPipelineStageFlags2KHR srcStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR srcAccess = VK_ACCESS_2_NONE_KHR;
+    if (this->transition(buffer.state, use.access, false, srcStages, srcAccess)) {
+      VkBufferMemoryBarrier2KHR barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR };
+      barrier.srcStageMask = srcStages;
+      barrier.srcAccessMask = srcAccess;
+      barrier.dstStageMask = use.access.stages;
+      barrier.dstAccessMask = use.access.access;
+      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.buffer = buffer.buffer;
+      barrier.offset = 0;
+      barrier.size = VK_WHOLE_SIZE;
+      pass.bufferBarriers.push_back(barrier);
+      this->stats.barriers++;
+    }
+  }
+}
+
+void RenderGraph::createRenderPass(Pass& pass, uint32_t passIndex) {
+  ASSERT_MSG(!pass.colors.empty() || pass.depth.image != UINT32_MAX, "RenderGraph: graphics pass {} has no attachment", pass.name);
+  auto describe = [this, passIndex](const Attachment& attachment, VkImageLayout layout) {
+    const auto& image = this->images[attachment.image];
+    bool hasContent = image.written || (image.imported && image.import.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+    AttachmentKey key{};
+    key.format = image.import.format;
+    key.loadOp = attachment.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : hasContent ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    key.storeOp = image.imported || image.lastPass > passIndex ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    key.layout = layout;
+    return key;
+  };
+  this->colorKeys.clear();
+  this->attachmentViews.clear();
+  VkExtent2D extent{};
+  for (const auto& attachment : pass.colors) {
+    this->colorKeys.push_back(describe(attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL));
+    this->attachmentViews.push_back(this->getImageView({ attachment.image }));
+    pass.clearValues.push_back(attachment.clearValue);
+    extent = this->images[attachment.image].import.extent;
+  }
+  AttachmentKey depthKey{};
+  bool hasDepth = pass.depth.image != UINT32_MAX;
+  if (hasDepth) {
+    depthKey = describe(pass.depth, pass.depth.write ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+    this->attachmentViews.push_back(this->getImageView({ pass.depth.image }));
+    pass.clearValues.push_back(pass.depth.clearValue);
+    extent = this->images[pass.depth.image].import.extent;
+  }
+  pass.extent = extent;
+  pass.renderPass = this->getRenderPass(this->colorKeys, hasDepth ? &depthKey : nullptr);
+  pass.framebuffer = this->getFramebuffer(pass.renderPass, this->attachmentViews, extent);
+}
+
+VkRenderPass RenderGraph::getRenderPass(const std::vector<AttachmentKey>& colors, const AttachmentKey* depth) {
+  size_t key = colors.size();
+  for (const auto& color : colors)
+    Engine::HashCombine(key, color.format, color.loadOp, color.storeOp, color.layout);
+  if (depth)
+    Engine::HashCombine(key, depth->format, depth->loadOp, depth->storeOp, depth->layout);
+  auto it = this->renderPasses.find(key);
+  if (it != this->renderPasses.end())
+    return it->second;
+
+  // layouts are transitioned by the graph's barriers, the render pass keeps them as is
+  std::vector<VkAttachmentDescription> attachments;
+  std::vector<VkAttachmentReference> colorReferences;
+  auto addAttachment = [&attachments](const AttachmentKey& key) {
+    VkAttachmentDescription attachment = {};
+    attachment.format = key.format;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = key.loadOp;
+    attachment.storeOp = key.storeOp;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = key.layout;
+    attachment.finalLayout = key.layout;
+    attachments.push_back(attachment);
+    return VkAttachmentReference{ static_cast<uint32_t>(attachments.size() - 1), key.layout };
+  };
+  for (const auto& color : colors)
+    colorReferences.push_back(addAttachment(color));
+  VkAttachmentReference depthReference{};
+  if (depth)
+    depthReference = addAttachment(*depth);
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+  subpass.pColorAttachments = colorReferences.data();
+  subpass.pDepthStencilAttachment = depth ? &depthReference : nullptr;
+
+  VkRenderPassCreateInfo createInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+  createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+  createInfo.pAttachments = attachments.data();
+  createInfo.subpassCount = 1;
+  createInfo.pSubpasses = &subpass;
+
+  VkRenderPass renderPass = VK_NULL_HANDLE;
+  VK_CHECK(vkCreateRenderPass(this->device, &createInfo, this->device.getAllocator(), &renderPass));
+  this->renderPasses.emplace(key, renderPass);
+  return renderPass;
+}
+
+VkRenderPass RenderGraph::getCompatibleRenderPass(const std::vector<VkFormat>& colorFormats, VkFormat depthFormat) {
+  // compatibility only depends on formats and sample counts
+  std::vector<AttachmentKey> colors;
+  for (VkFormat format : colorFormats)
+    colors.push_back({ format, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+  AttachmentKey depth{ depthFormat, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+  return this->getRenderPass(colors, depthFormat != VK_FORMAT_UNDEFINED ? &depth : nullptr);
+}
+
+VkFramebuffer RenderGraph::getFramebuffer(VkRenderPass renderPass, const std::vector<VkImageView>& views, VkExtent2D extent) {
+  size_t key = 0;
+  Engine::HashCombine(key, renderPass, extent.width, extent.height);
+  for (VkImageView view : views)
+    Engine::HashCombine(key, view);
+  auto& framebuffer = this->framebuffers[key];
+  framebuffer.lastUsedFrame = this->frame;
+  if (framebuffer.handle)
+    return framebuffer.handle;
+
+  VkFramebufferCreateInfo createInfo = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+  createInfo.renderPass = renderPass;
+  createInfo.attachmentCount = static_cast<uint32_t>(views.size());
+  createInfo.pAttachments = views.data();
+  createInfo.width = extent.width;
+  createInfo.height = extent.height;
+  createInfo.layers = 1;
+  VK_CHECK(vkCreateFramebuffer(this->device, &createInfo, this->device.getAllocator(), &framebuffer.handle));
+  return framebuffer.handle;
+}
+
+void RenderGraph::allocateTransientImages() {
+  size_t layout = this->imageCount;
+  for (uint32_t i = 0; i < this->imageCount; i++) {
+    const auto& image = this->images[i];
+    if (image.imported || image.firstPass == UINT32_MAX)
+      continue;
+    Engine::HashCombine(
+      layout, i, image.import.format, image.import.extent.width, image.import.extent.height,
+      image.usage, image.firstPass, image.lastPass
+    );
+  }
+  bool reuse = layout == this->transientLayout;
+  if (!reuse) {
+    // frames in flight may still use the previous images
+    if (!this->physicalImages.empty())
+      this->retired.push_back({ this->frame, std::move(this->physicalImages), std::move(this->memoryBlocks) });
+    this->physicalImages.clear();
+    this->memoryBlocks.clear();
+    this->transientLayout = layout;
+  }
+
+  // physical images are created in image order, so an unchanged graph maps to the same ones
+  std::vector<VkMemoryRequirements> requirements;
+  std::vector<uint32_t> order;
+  uint32_t physical = 0;
+  for (uint32_t i = 0; i < this->imageCount; i++) {
+    auto& image = this->images[i];
+    if (image.imported || image.firstPass == UINT32_MAX)
+      continue;
+    image.physical = physical++;
+    if (reuse)
+      continue;
+    VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = { image.import.extent.width, image.import.extent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = image.import.format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = image.usage;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    PhysicalImage physicalImage{};
+    VK_CHECK(vkCreateImage(this->device, &imageInfo, this->device.getAllocator(), &physicalImage.image));
+    this->physicalImages.push_back(physicalImage);
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(this->device, physicalImage.image, &memoryRequirements);
+    requirements.push_back(memoryRequirements);
+    order.push_back(i);
+  }
+  if (reuse)
+    return;
+
+  // largest first, each image goes to the first block whose images are all dead or not yet alive during its lifetime
+  std::vector<uint32_t> byImage(this->imageCount, UINT32_MAX);
+  for (uint32_t p = 0; p < order.size(); p++)
+    byImage[order[p]] = p;
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return requirements[byImage[a]].size > requirements[byImage[b]].size;
+  });
+  this->stats.unaliasedBytes = 0;
+  for (uint32_t index : order) {
+    const auto& image = this->images[index];
+    const auto& memoryRequirements = requirements[byImage[index]];
+    this->stats.unaliasedBytes += memoryRequirements.size;
+    auto overlaps = [&image](const std::pair<uint32_t, uint32_t>& lifetime) {
+      return image.firstPass <= lifetime.second && lifetime.first <= image.lastPass;
+    };
+    uint32_t blockIndex = 0;
+    for (; blockIndex < this->memoryBlocks.size(); blockIndex++) {
+      auto& block = this->memoryBlocks[blockIndex];
+      if ((block.memoryTypeBits & memoryRequirements.memoryTypeBits) && std::none_of(block.lifetimes.begin(), block.lifetimes.end(), overlaps))
+        break;
+    }
+    if (blockIndex == this->memoryBlocks.size())
+      this->memoryBlocks.emplace_back();
+    auto& block = this->memoryBlocks[blockIndex];
+    block.size = std::max(block.size, memoryRequirements.size);
+    block.alignment = std::max(block.alignment, memoryRequirements.alignment);
+    block.memoryTypeBits &= memoryRequirements.memoryTypeBits;
+    block.lifetimes.push_back({ image.firstPass, image.lastPass });
+    this->physicalImages[image.physical].block = blockIndex;
+  }
+
+  this->stats.transientBytes = 0;
+  for (auto& block : this->memoryBlocks) {
+    VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocateInfo.allocationSize = block.size;
+    allocateInfo.memoryTypeIndex = this->device.findMemoryType(block.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    VK_CHECK(vkAllocateMemory(this->device, &allocateInfo, this->device.getAllocator(), &block.memory));
+    this->stats.transientBytes += block.size;
+  }
+  for (uint32_t i = 0; i < this->imageCount; i++) {
+    const auto& image = this->images[i];
+    if (image.imported || image.firstPass == UINT32_MAX)
+      continue;
+    auto& physicalImage = this->physicalImages[image.physical];
+    // every image of a block starts at its beginning, their lifetimes never overlap
+    VK_CHECK(vkBindImageMemory(this->device, physicalImage.image, this->memoryBlocks[physicalImage.block].memory, 0));
+    VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = physicalImage.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = image.import.format;
+    viewInfo.subresourceRange = { image.aspect, 0, 1, 0, 1 };
+    VK_CHECK(vkCreateImageView(this->device, &viewInfo, this->device.getAllocator(), &physicalImage.view));
+  }
+  this->stats.transientImages = static_cast<uint32_t>(this->physicalImages.size());
+  LOG_RENDERER_INFO(
+    "RenderGraph: {} transient images in {} blocks, {:.1f}MB ({:.1f}MB without aliasing)",
+    this->stats.transientImages, this->memoryBlocks.size(),
+    this->stats.transientBytes / (1024.f * 1024.f), this->stats.unaliasedBytes / (1024.f * 1024.f)
+  );
+}
+
+void RenderGraph::destroyRetired(bool all) {
+  std::erase_if(this->retired, [this, all](RetiredResources& resources) {
+    if (!all && this->frame < resources.frame + this->framesInFlight)
+      return false;
+    for (auto& image : resources.images) {
+      vkDestroyImageView(this->device, image.view, this->device.getAllocator());
+      vkDestroyImage(this->device, image.image, this->device.getAllocator());
+    }
+    for (auto& block : resources.blocks)
+      vkFreeMemory(this->device, block.memory, this->device.getAllocator());
+    return true;
+  });
+}
+
+void RenderGraph::releaseResources() {
+  if (!this->physicalImages.empty())
+    this->retired.push_back({ this->frame, std::move(this->physicalImages), std::move(this->memoryBlocks) });
+  this->physicalImages.clear();
+  this->memoryBlocks.clear();
+  this->transientLayout = 0;
+  this->destroyRetired(true);
+  for (auto& [key, framebuffer] : this->framebuffers)
+    vkDestroyFramebuffer(this->device, framebuffer.handle, this->device.getAllocator());
+  this->framebuffers.clear();
+}
+
+VkImage RenderGraph::getImage(ImageHandle image) const {
+  const auto& resource = this->images[image.index];
+  if (resource.imported)
+    return resource.import.image;
+  return resource.physical != UINT32_MAX ? this->physicalImages[resource.physical].image : VK_NULL_HANDLE;
+}
+
+VkImageView RenderGraph::getImageView(ImageHandle image) const {
+  const auto& resource = this->images[image.index];
+  if (resource.imported)
+    return resource.import.view;
+  return resource.physical != UINT32_MAX ? this->physicalImages[resource.physical].view : VK_NULL_HANDLE;
+}
+
+void RenderGraph::execute(CommandBuffer& cmdBuffer, GpuProfiler* profiler) {
+  PROFILE_SCOPE("RenderGraph::execute");
+  ASSERT(this->compiled, "RenderGraph::execute: graph not compiled");
+  auto recordBarriers = [this, &cmdBuffer](
+    const std::vector<VkImageMemoryBarrier2KHR>& imageBarriers,
+    const std::vector<VkBufferMemoryBarrier2KHR>& bufferBarriers
+  ) {
+    if (imageBarriers.empty() && bufferBarriers.empty())
+      return;
+    VkDependencyInfoKHR dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR };
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+    CmdPipelineBarrier2(this->device, cmdBuffer, &dependencyInfo);
+  };
+
+  for (uint32_t i = 0; i < this->passCount; i++) {
+    auto& pass = this->passes[i];
+    if (pass.culled)
+      continue;
+    if (profiler)
+      profiler->beginScope(cmdBuffer, pass.name);
+    recordBarriers(pass.imageBarriers, pass.bufferBarriers);
+    PassContext context{ cmdBuffer, pass.renderPass, pass.extent, *this };
+    if (pass.type == PassType::Graphics) {
+      VkRenderPassBeginInfo beginInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+      beginInfo.renderPass = pass.renderPass;
+      beginInfo.framebuffer = pass.framebuffer;
+      beginInfo.renderArea = { { 0, 0 }, pass.extent };
+      beginInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+      beginInfo.pClearValues = pass.clearValues.data();
+      vkCmdBeginRenderPass(cmdBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+    if (pass.execute)
+      pass.execute(context);
+    if (pass.type == PassType::Graphics)
+      vkCmdEndRenderPass(cmdBuffer);
+    if (profiler)
+      profiler->endScope(cmdBuffer);
+  }
+  recordBarriers(this->finalBarriers, {});
+  for (uint32_t i = 0; i < this->bufferCount; i++)
+    this->bufferStates[this->buffers[i].buffer] = this->buffers[i].state;
+}
@@ -34,7 +34,7 @@ void RenderPass::init() {
   colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  colorAttachment.finalLayout = this->swapchain.getFinalLayout();
 
   VkAttachmentReference colorAttachmentRef = {};
   colorAttachmentRef.attachment = 0;
@@ -0,0 +1,63 @@
+#include "renderer/apis/Vulkan/SamplerCache.h"
+#include "renderer/apis/Vulkan/Device.h"
+#include "renderer/apis/Vulkan/Texture2D.h"
+#include <renderer/logger.h>
+
+#include <algorithm>
+
+using namespace Engine::Renderers::Vulkan;
+
+SamplerCache::SamplerCache(Device& device) : device(device) {}
+
+SamplerCache::~SamplerCache() {
+  for (auto& [spec, entry] : this->samplers) {
+    if (entry.refCount > 0)
+      LOG_RENDERER_WARN("Destroying sampler with {} live references", entry.refCount);
+    vkDestroySampler(this->device, entry.handle, this->device.getAllocator());
+  }
+  this->samplers.clear();
+  this->owners.clear();
+}
+
+VkSampler SamplerCache::create(const TextureSamplerSpecification& spec) const {
+  VkSamplerCreateInfo samplerInfo = Texture2D::CreateSamplerInfo(spec);
+  auto& limits = this->device.getPhysicalDeviceInfo().properties.limits;
+  samplerInfo.maxAnisotropy = std::min(samplerInfo.maxAnisotropy, limits.maxSamplerAnisotropy);
+
+  VkSampler sampler = VK_NULL_HANDLE;
+  VK_CHECK(vkCreateSampler(this->device, &samplerInfo, this->device.getAllocator(), &sampler));
+  return sampler;
+}
+
+VkSampler SamplerCache::acquire(const TextureSamplerSpecification& spec) {
+  std::lock_guard lock(this->mutex);
+  auto& entry = this->samplers[spec];
+  if (entry.handle == VK_NULL_HANDLE) {
+    entry.handle = this->create(spec);
+    this->owners.emplace(entry.handle, spec);
+    LOG_RENDERER_TRACE("Created sampler ({} unique)", this->samplers.size());
+  }
+  entry.refCount++;
+  return entry.handle;
+}
+
+void SamplerCache::release(VkSampler sampler) {
+  if (sampler == VK_NULL_HANDLE)
+    return;
+  std::lock_guard lock(this->mutex);
+  auto owner = this->owners.find(sampler);
+  ASSERT(owner != this->owners.end(), "Sampler is not owned by this cache");
+  if (owner == this->owners.end())
+    return;
+  auto it = this->samplers.find(owner->second);
+  if (--it->second.refCount > 0)
+    return;
+  vkDestroySampler(this->device, sampler, this->device.getAllocator());
+  this->samplers.erase(it);
+  this->owners.erase(owner);
+}
+
+uint32_t SamplerCache::getSize() const {
+  std::lock_guard lock(this->mutex);
+  return static_cast<uint32_t>(this->samplers.size());
+}
@@ -11,6 +11,7 @@ Swapchain::Swapchain(
   : device(device),
   windowExtent(createInfo.windowExtent),
   vSync(createInfo.vSync),
+  offscreen(createInfo.offscreen),
   oldSwapchain(createInfo.oldSwapchain) {
   this->init(createInfo);
   this->oldSwapchain = nullptr;
@@ -21,7 +22,8 @@ Swapchain::~Swapchain() {
   this->device.waitIdle();
   for (auto imageView : this->imageViews)
     vkDestroyImageView(this->device, imageView, this->device.getAllocator());
-  vkDestroySwapchainKHR(this->device, this->handle, this->device.getAllocator());
+  if (this->handle)
+    vkDestroySwapchainKHR(this->device, this->handle, this->device.getAllocator());
   LOG_RENDERER_INFO("Swapchain destroyed");
 
 }
@@ -29,14 +31,18 @@ Swapchain::~Swapchain() {
 void Swapchain::init(const SwapchainCreateInfo& createInfo) {
   this->createSwapChain();
   this->createImageViews();
-  this->createDepthResources();
+  // the depth buffer is a transient image of the render graph
+  this->depthFormat = this->findDepthFormat();
   this->createMainRenderPass(createInfo.mainRenderPassCreateInfo);
-  this->createFramebuffers();
   // this->createSyncObjects();
   LOG_RENDERER_INFO("Swapchain initialized");
 }
 
 void Swapchain::createSwapChain() {
+  if (this->offscreen) {
+    this->createOffscreenImages();
+    return;
+  }
   auto& support = this->device.getSwapChainSupport();
   auto surfaceFormat = this->chooseSurfaceFormat(support.formats);
   auto presentMode = this->choosePresentMode(support.presentModes);
@@ -54,6 +60,10 @@ void Swapchain::createSwapChain() {
   createInfo.imageExtent = extent;
   createInfo.imageArrayLayers = 1;
   createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  // lets frames be captured, see FrameCapture
+  if (support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+    createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  this->imageUsage = createInfo.imageUsage;
 
   auto& indices = this->device.getQueueFamilies();
   uint32_t queueFamilyIndices[] = { indices.graphicsFamily, indices.presentFamily };
@@ -82,6 +92,31 @@ void Swapchain::createSwapChain() {
   this->maxFramesInFlight = std::max(1u, imageCount - 1);
 }
 
+void Swapchain::createOffscreenImages() {
+  this->imageFormat = { OffscreenImageFormat, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+  this->swapChainExtent = this->windowExtent;
+  this->colorImages.reserve(OffscreenImageCount);
+  this->images.reserve(OffscreenImageCount);
+  for (uint32_t i = 0; i < OffscreenImageCount; i++) {
+    ImageCreateInfo createInfo{};
+    createInfo.type = VK_IMAGE_TYPE_2D;
+    createInfo.extent.width = this->swapChainExtent.width;
+    createInfo.extent.height = this->swapChainExtent.height;
+    createInfo.format = OffscreenImageFormat;
+    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // transfer source so frames can be read back
+    createInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    this->imageUsage = createInfo.usage;
+    createInfo.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    // views are created by createImageViews like for swapchain images
+    createInfo.createView = false;
+    this->colorImages.emplace_back(this->device, createInfo);
+    this->images.push_back(this->colorImages.back().getHandle());
+  }
+  this->maxFramesInFlight = OffscreenImageCount - 1;
+  LOG_RENDERER_INFO("Offscreen targets: {}x{}", this->swapChainExtent.width, this->swapChainExtent.height);
+}
+
 void Swapchain::createImageViews() {
   this->imageViews.resize(this->images.size());
   for (size_t i = 0; i < this->images.size(); i++) {
@@ -100,29 +135,6 @@ void Swapchain::createImageViews() {
   }
 }
 
-void Swapchain::createDepthResources() {
-  this->depthFormat = this->findDepthFormat();
-  this->depthImages.reserve(this->images.size());
-
-  for (uint32_t i = 0; i < this->images.size(); i++) {
-    ImageCreateInfo createInfo{};
-    createInfo.type = VK_IMAGE_TYPE_2D;
-    createInfo.extent.width = this->swapChainExtent.width;
-    createInfo.extent.height = this->swapChainExtent.height;
-    createInfo.format = this->depthFormat;
-    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    createInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-    createInfo.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-    createInfo.createView = true;
-    createInfo.viewAspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
-    createInfo.viewCreateInfo.subresourceRange.baseMipLevel = 0;
-    createInfo.viewCreateInfo.subresourceRange.levelCount = 1;
-    createInfo.viewCreateInfo.subresourceRange.baseArrayLayer = 0;
-    createInfo.viewCreateInfo.subresourceRange.layerCount = 1;
-    this->depthImages.emplace_back(this->device, createInfo);
-  }
-}
-
 void Swapchain::createMainRenderPass(const RenderPassCreateInfo& baseCreateInfo) {
   RenderPassCreateInfo createInfo = baseCreateInfo;
   createInfo.renderArea.size = { this->swapChainExtent.width, this->swapChainExtent.height };
@@ -130,17 +142,6 @@ void Swapchain::createMainRenderPass(const RenderPassCreateInfo& baseCreateInfo)
   this->mainRenderPass = MakeScope<RenderPass>(this->device, *this, createInfo);
 }
 
-void Swapchain::createFramebuffers() {
-  this->framebuffers.reserve(this->getImageCount());
-  for (uint32_t i = 0; i < this->getImageCount(); i++) {
-    FramebufferCreateInfo createInfo;
-    createInfo.renderPass = *this->mainRenderPass;
-    createInfo.size = { this->swapChainExtent.width, this->swapChainExtent.height };
-    createInfo.attachments = { this->getImageView(i), this->getDepthImageView(i) };
-    this->framebuffers.emplace_back(this->device, createInfo);
-  }
-}
-
 // we'll do sanity checks on the VkResult when we call this function
 VkResult Swapchain::acquireNextImage(
   uint32_t* imageIndex,
@@ -149,6 +150,12 @@ VkResult Swapchain::acquireNextImage(
   uint64_t timeout
 ) {
   fence.wait(timeout);
+  // nothing to wait for, the image semaphore is left unsignaled and must not be waited on
+  if (this->offscreen) {
+    *imageIndex = this->nextOffscreenImage;
+    this->nextOffscreenImage = (this->nextOffscreenImage + 1) % this->getImageCount();
+    return VK_SUCCESS;
+  }
 
   return vkAcquireNextImageKHR(
     this->device,
@@ -160,6 +167,10 @@ VkResult Swapchain::acquireNextImage(
 
 // we'll do sanity checks on the VkResult when we call this function
 VkResult Swapchain::presentImage(uint32_t imageIndex, VkSemaphore renderFinishedSemaphore) {
+  if (this->offscreen) {
+    this->currentFrame = (this->currentFrame + 1) % this->maxFramesInFlight;
+    return VK_SUCCESS;
+  }
   VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
   presentInfo.waitSemaphoreCount = 1;
   presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
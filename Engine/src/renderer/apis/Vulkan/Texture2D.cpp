@@ -1,5 +1,8 @@
 #include "renderer/apis/Vulkan/Texture2D.h"
 #include "renderer/apis/Vulkan/MemBuffer.h"
+#include "renderer/apis/Vulkan/SamplerCache.h"
+
+#include <algorithm>
 
 using namespace Engine::Renderers::Vulkan;
 
@@ -10,8 +13,7 @@ Texture2D::Texture2D(Device& device, const TextureSpecification& spec)
 
 Texture2D::~Texture2D() {
   this->device.waitIdle();
-  if (this->sampler != VK_NULL_HANDLE)
-    vkDestroySampler(this->device, this->sampler, this->device.getAllocator());
+  this->device.getSamplerCache().release(this->sampler);
 }
 
 VkFormat Texture2D::TexChannelsToVkFormat(TextureChannels channels) {
@@ -75,7 +77,8 @@ VkSamplerCreateInfo Texture2D::CreateSamplerInfo(const TextureSamplerSpecificati
   samplerInfo.addressModeV = TextureWrapToVkWrap(spec.wrap.t);
   samplerInfo.addressModeW = TextureWrapToVkWrap(spec.wrap.r);
   samplerInfo.anisotropyEnable = spec.anisotropy;
-  samplerInfo.maxAnisotropy = spec.anisotropy ? 16.0f : 1.0f;
+  // the device limit is applied by the SamplerCache
+  samplerInfo.maxAnisotropy = spec.anisotropy ? std::max(spec.maxAnisotropy, 1.0f) : 1.0f;
   samplerInfo.borderColor = TextureBorderColorToVkBorderColor(spec.borderColor);
   samplerInfo.unnormalizedCoordinates = spec.unnormalizedCoordinates;
   samplerInfo.compareEnable = spec.compareEnable;
@@ -101,9 +104,7 @@ void Texture2D::init() {
 
   this->image = MakeScope<Image>(this->device, createInfo);
 
-  VkSamplerCreateInfo samplerInfo = CreateSamplerInfo(this->spec.sampler);
-
-  VK_CHECK(vkCreateSampler(this->device, &samplerInfo, this->device.getAllocator(), &this->sampler));
+  this->sampler = this->device.getSamplerCache().acquire(this->spec.sampler);
   this->generation++;
 }
 
@@ -1,12 +1,23 @@
 #include "renderer/apis/Vulkan/VulkanRenderer.h"
 #include "renderer/apis/Vulkan/shaders/Object.h"
+#include "renderer/apis/Vulkan/shaders/Depth.h"
 #include "renderer/apis/Vulkan/Texture2D.h"
+#include "renderer/apis/Vulkan/Mesh.h"
 
 #include <core/EngineInfo.h>
 #include <core/Coordinates.h>
 #include <core/PoolManager.h>
+#include <core/Profiler.h>
+#include <core/MemoryTracker.h>
+#include <renderer/MeshImporter.h>
 #include <renderer/logger.h>
 
+#include <imgui.h>
+#include <backends/imgui_impl_vulkan.h>
+
+#include <algorithm>
+#include <numeric>
+
 using Engine::Renderers::Vulkan::Renderer;
 
 Renderer::Renderer(ApplicationInfo& appInfo, Platform& platform)
@@ -18,6 +29,14 @@ Renderer::Renderer(ApplicationInfo& appInfo, Platform& platform)
 
 Renderer::~Renderer() {
   this->device.waitIdle();
+  this->shutdownImGui();
+  this->frameCapture.reset();
+  this->gpuProfiler.reset();
+  this->renderGraph.reset();
+  this->lighting.reset();
+  this->shadows.reset();
+  this->particles.reset();
+  this->billboards.reset();
   this->imageAvailableSemaphores.clear();
   this->renderFinishedSemaphores.clear();
   this->inFlightFences.clear();
@@ -26,16 +45,41 @@ Renderer::~Renderer() {
 }
 
 void Renderer::init() {
+  MEMORY_TAG(Renderer);
   this->recreateSwapchain();
   this->createGraphicsCommandBuffers();
   this->createSyncObjects();
+  this->frameCapture = MakeScope<FrameCapture>(this->device);
+  this->gpuProfiler = MakeScope<GpuProfiler>(this->device, this->swapchain->getMaxFramesInFlight());
+  this->frameAllocator = MakeScope<GpuFrameAllocator>(this->device, this->swapchain->getMaxFramesInFlight());
+  this->renderGraph = MakeScope<RenderGraph>(this->device, this->swapchain->getMaxFramesInFlight());
+  // the object shaders use their descriptor set layouts
+  this->lighting = MakeScope<ClusteredLighting>(*this);
+  this->shadows = MakeScope<CascadedShadows>(*this);
   this->objectShader = MakeScope<Shaders::Object>(*this, this->getMainRenderPass());
+  this->packedObjectShader = MakeScope<Shaders::Object>(*this, this->getMainRenderPass(), MeshVertexFormat::Packed);
+  this->prepassObjectShader = MakeScope<Shaders::Object>(*this, this->getMainRenderPass(), MeshVertexFormat::Standard, true);
+  this->prepassPackedObjectShader = MakeScope<Shaders::Object>(*this, this->getMainRenderPass(), MeshVertexFormat::Packed, true);
+  // the prepass only has a depth attachment
+  VkRenderPass depthRenderPass = this->renderGraph->getCompatibleRenderPass({}, this->swapchain->getDepthFormat());
+  VkDescriptorSetLayout globalDescriptorSetLayout = this->objectShader->getGlobalDescriptorSetLayout();
+  this->depthShader = MakeScope<Shaders::Depth>(*this, depthRenderPass, globalDescriptorSetLayout);
+  this->packedDepthShader = MakeScope<Shaders::Depth>(*this, depthRenderPass, globalDescriptorSetLayout, MeshVertexFormat::Packed);
+  VkRenderPass shadowRenderPass = this->renderGraph->getCompatibleRenderPass({}, CascadedShadows::Format);
+  this->shadowDepthShader = MakeScope<Shaders::Depth>(*this, shadowRenderPass, globalDescriptorSetLayout, MeshVertexFormat::Standard, true);
+  this->packedShadowDepthShader = MakeScope<Shaders::Depth>(*this, shadowRenderPass, globalDescriptorSetLayout, MeshVertexFormat::Packed, true);
+  this->billboards = MakeScope<BillboardRenderer>(*this, this->getMainRenderPass(), globalDescriptorSetLayout);
+  this->particles = MakeScope<ParticleSystem>(*this, *this->billboards);
   this->createObjectBuffers();
   this->uploadTestObjectData();
 }
 
 bool Renderer::beginFrame(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("Renderer::beginFrame");
+  MEMORY_TAG(Renderer);
   ASSERT(!this->hasFrameStarted, "Renderer::beginFrame: Frame already started");
+  if (auto* hostAllocator = this->device.getHostAllocator())
+    hostAllocator->newFrame();
   if (this->recreateSwapchainFlag) {
     if (!this->recreateSwapchain()) {
       LOG_RENDERER_ERROR("Renderer::beginFrame: Failed to recreate swapchain");
@@ -55,79 +99,48 @@ bool Renderer::beginFrame(FrameInfo& frameInfo) {
     this->recreateSwapchainFlag = true;
     return false;
   }
+  // this frame's fence was just waited, before endFrame resets it
+  this->frameCapture->poll();
+  this->frameAllocator->beginFrame(this->currentFrameIndex);
   this->hasFrameStarted = true;
-  VkFrameInfo vkFrameInfo{
-    frameInfo,
-    this->currentFrameIndex,
-    this->getCurrentGraphicsCommandBuffer(),
-    this->objectShader->getGlobalDescriptorSet(this->currentFrameIndex)
-  };
 
-  auto& cmdBuffer = vkFrameInfo.cmdBuffer;
+  auto& cmdBuffer = this->getCurrentGraphicsCommandBuffer();
   cmdBuffer.reset().beginRecording();
+  this->gpuProfiler->beginFrame(cmdBuffer, this->currentFrameIndex);
+  this->gpuProfiler->beginScope(cmdBuffer, "Frame");
 
-  VkViewport viewport = {};
-  viewport.x = 0.0f;
-  viewport.y = static_cast<float>(this->swapchain->getExtent().height);
-  viewport.width = static_cast<float>(this->swapchain->getExtent().width);
-  viewport.height = -static_cast<float>(this->swapchain->getExtent().height);
-  viewport.minDepth = 0.0f;
-  viewport.maxDepth = 1.0f;
-
-  VkRect2D scissor = {};
-  scissor.offset = { 0, 0 };
-  scissor.extent = this->swapchain->getExtent();
-
-  vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
-  vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
-
-  this->getMainRenderPass().begin(
-    cmdBuffer,
-    this->swapchain->getFramebuffer(this->currentImageIndex)
-  );
-
-  // TODO: tmp code
-  this->objectShader->updateGlobalUniforms(vkFrameInfo);
-
-  this->objectShader->use(vkFrameInfo);
-  VkBuffer vertexBuffers[] = { this->objectVertexBuffer->getHandle() };
-  VkDeviceSize offsets[] = { 0 };
-  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
-  vkCmdBindIndexBuffer(cmdBuffer, this->objectIndexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
-
-  // plane
-  glm::vec3 offset{ 0.f, -5.f, 0.f };
-  glm::vec3 scale{ 20.f, 1.f, 20.f };
-  glm::mat4 planeModel = glm::translate(glm::mat4(1.f), offset) * glm::scale(glm::mat4(1.f), scale);
-  vkCmdPushConstants(
-    cmdBuffer,
-    this->objectShader->getPipelineLayout(),
-    VK_SHADER_STAGE_VERTEX_BIT,
-    0, sizeof(glm::mat4), &planeModel
-  );
-  vkCmdDrawIndexed(cmdBuffer, 6, 1, 36, 0, 0);
-
-  // static float angle = 0.f;
-  // angle += 2.f * frameInfo.deltaTime;
-  // glm::mat4 cubeModel = glm::rotate(glm::mat4(1.f), angle, Coordinates::Up<glm::vec3>);
-  glm::mat4 cubeModel = glm::mat4{ 1.f };
-  vkCmdPushConstants(
-    cmdBuffer,
-    this->objectShader->getPipelineLayout(),
-    VK_SHADER_STAGE_VERTEX_BIT,
-    0, sizeof(glm::mat4), &cubeModel
-  );
-  // cube
-  vkCmdDrawIndexed(cmdBuffer, 36, 1, 0, 0, 0);
+  // draws are recorded by the graph's passes in endFrame
+  this->meshDraws.clear();
+  this->lighting->beginFrame();
+  this->shadows->beginFrame();
+  this->billboards->beginFrame();
+  this->particles->beginFrame();
 
   return true;
 }
 
 bool Renderer::endFrame(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("Renderer::endFrame");
+  MEMORY_TAG(Renderer);
   ASSERT(this->hasFrameStarted, "Renderer::endFrame: Frame not started");
   auto& cmdBuffer = this->getCurrentGraphicsCommandBuffer();
 
-  this->swapchain->getMainRenderPass().end(cmdBuffer);
+  this->buildRenderGraph(frameInfo);
+  this->renderGraph->execute(cmdBuffer, this->gpuProfiler.get());
+  if (this->frameCapture->hasRequest()) {
+    GpuProfiler::ScopeGuard scope(*this->gpuProfiler, cmdBuffer, "Capture");
+    this->frameCapture->record(
+      cmdBuffer,
+      this->swapchain->getImage(this->currentImageIndex),
+      this->swapchain->getFinalLayout(),
+      this->swapchain->getExtent(),
+      this->swapchain->getImageFormat(),
+      this->inFlightFences[this->currentFrameIndex]
+    );
+  }
+  this->gpuProfiler->endScope(cmdBuffer);
+  this->gpuProfiler->endFrame();
+  this->frameAllocator->endFrame();
   cmdBuffer.endRecording();
 
   if (this->imagesInFlightFences[this->currentImageIndex])
@@ -136,13 +149,17 @@ bool Renderer::endFrame(FrameInfo& frameInfo) {
 
   CommandBufferSubmitInfo submitInfo{};
   submitInfo.fence = &this->inFlightFences[this->currentFrameIndex];
-  submitInfo.waitSemaphores = { this->imageAvailableSemaphores[this->currentFrameIndex] };
-  submitInfo.signalSemaphores = { this->renderFinishedSemaphores[this->currentFrameIndex] };
+  // offscreen images are neither acquired nor presented, nothing signals or waits on the semaphores
+  if (!this->swapchain->isOffscreen()) {
+    submitInfo.waitSemaphores = { this->imageAvailableSemaphores[this->currentFrameIndex] };
+    submitInfo.signalSemaphores = { this->renderFinishedSemaphores[this->currentFrameIndex] };
+  }
   submitInfo.waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
   submitInfo.resetFence = true;
 
   cmdBuffer.submit(this->device.getGraphicsQueue(), submitInfo);
 
+  PROFILE_SCOPE("Renderer::present");
   auto result = this->swapchain->presentImage(
     this->currentImageIndex,
     this->renderFinishedSemaphores[this->currentFrameIndex]
@@ -166,8 +183,10 @@ void Renderer::onResize(uint32_t width, uint32_t height) {
 }
 
 bool Renderer::recreateSwapchain() {
+  MEMORY_TAG(Renderer);
   VkExtent2D windowExtent = this->getWindowExtent();
-  while (windowExtent.width == 0 || windowExtent.height == 0) {
+  // a headless window never gets events, its size is fixed
+  while (!this->device.isHeadless() && (windowExtent.width == 0 || windowExtent.height == 0)) {
     windowExtent = this->getWindowExtent();
     this->platform.window->waitEvents();
   }
@@ -176,12 +195,16 @@ bool Renderer::recreateSwapchain() {
     LOG_RENDERER_ERROR("Renderer::recreateSwapchain: Device::waitIdle(1) failed: {}", CallResultToString(result));
     return false;
   }
+  // transient images and framebuffers have the size of the old swapchain
+  if (this->renderGraph)
+    this->renderGraph->releaseResources();
   this->device.querySwapChainSupport();
 
   SwapchainCreateInfo createInfo;
   createInfo.oldSwapchain = nullptr;
   createInfo.vSync = this->appInfo.windowInfo.vSync;
   createInfo.windowExtent = windowExtent;
+  createInfo.offscreen = this->device.isHeadless();
 
   auto& renderPassCreateInfo = createInfo.mainRenderPassCreateInfo;
   renderPassCreateInfo.clearColor = { 0.1f, 0.1f, 0.1f, 1.0f };
@@ -196,6 +219,8 @@ bool Renderer::recreateSwapchain() {
       this->swapchain = MakeScope<Swapchain>(this->device, createInfo);
       ASSERT(this->swapchain->compareFormats(*createInfo.oldSwapchain), "Swapchain image format has changed");
     }
+    if (this->imguiEnabled)
+      ImGui_ImplVulkan_SetMinImageCount(std::max(2u, this->swapchain->getImageCount()));
   }
   catch (const std::exception& e) {
     LOG_RENDERER_ERROR("Renderer::recreateSwapchain: {}", e.what());
@@ -204,6 +229,238 @@ bool Renderer::recreateSwapchain() {
   return true;
 }
 
+void Renderer::buildRenderGraph(FrameInfo& frameInfo) {
+  PROFILE_SCOPE("Renderer::buildRenderGraph");
+  // the camera is uploaded while rendering, after beginFrame
+  VkFrameInfo vkFrameInfo{
+    frameInfo,
+    this->currentFrameIndex,
+    this->getCurrentGraphicsCommandBuffer(),
+    this->objectShader->getGlobalDescriptorSet()
+  };
+  this->objectShader->updateGlobalUniforms(vkFrameInfo);
+  this->lighting->update(frameInfo.globalUbo, this->swapchain->getExtent());
+  this->shadows->update(frameInfo.globalUbo);
+  this->billboards->upload(this->currentFrameIndex, frameInfo.globalUbo.view);
+  this->frameDepthPrepass = this->depthPrepass;
+  this->sortMeshDraws(frameInfo.globalUbo.view);
+
+  auto& graph = *this->renderGraph;
+  graph.reset();
+
+  RenderGraph::ImportedImage backbuffer{};
+  backbuffer.image = this->swapchain->getImage(this->currentImageIndex);
+  backbuffer.view = this->swapchain->getImageView(this->currentImageIndex);
+  backbuffer.format = this->swapchain->getImageFormat();
+  backbuffer.extent = this->swapchain->getExtent();
+  // the submission waits on the acquisition at this stage
+  backbuffer.initialStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+  backbuffer.finalLayout = this->swapchain->getFinalLayout();
+  auto color = graph.importImage("Backbuffer", backbuffer);
+  auto depth = graph.createImage("Depth", { this->swapchain->getDepthFormat(), this->swapchain->getExtent() });
+
+  const auto& mainRenderPass = this->getMainRenderPass();
+  if (this->frameDepthPrepass) {
+    graph.addPass("DepthPrepass", RenderGraph::PassType::Graphics, [this, &frameInfo](RenderGraph::PassContext& context) {
+      this->recordDepthPrepass(context, frameInfo);
+    })
+      .depthAttachment(depth, true, true, mainRenderPass.getDepth());
+  }
+  auto shadowMaps = this->shadows->addPasses(graph, [this, &frameInfo](RenderGraph::PassContext& context, const CascadedShadows::Cascade& cascade) {
+    this->recordShadowCascade(context, frameInfo, cascade);
+  });
+  auto clusters = this->lighting->addCullingPass(graph);
+  auto particleBuffers = this->particles->addPasses(graph, frameInfo.deltaTime);
+  // depth is read only after the prepass
+  auto mainPass = graph.addPass("MainPass", RenderGraph::PassType::Graphics, [this, &frameInfo](RenderGraph::PassContext& context) {
+    this->recordMainPass(context, frameInfo);
+  });
+  mainPass
+    .colorAttachment(color, true, mainRenderPass.getClearColor())
+    .depthAttachment(depth, !this->frameDepthPrepass, !this->frameDepthPrepass, mainRenderPass.getDepth());
+  if (clusters.lightCounts.isValid()) {
+    mainPass
+      .read(clusters.lightCounts, RenderGraph::BufferUsage::StorageRead)
+      .read(clusters.lightIndices, RenderGraph::BufferUsage::StorageRead);
+  }
+  for (auto shadowMap : shadowMaps.cascades) {
+    if (shadowMap.isValid())
+      mainPass.sample(shadowMap);
+  }
+  if (particleBuffers.instances.isValid()) {
+    mainPass
+      .read(particleBuffers.instances, RenderGraph::BufferUsage::StorageRead)
+      .read(particleBuffers.indirectArgs, RenderGraph::BufferUsage::Indirect);
+  }
+  graph.compile();
+}
+
+void Renderer::sortMeshDraws(const glm::mat4& view) {
+  PROFILE_SCOPE("Renderer::sortMeshDraws");
+  for (auto& draw : this->meshDraws) {
+    const auto& bounds = draw.mesh->getBounds();
+    glm::vec4 center{ (bounds.min + bounds.max) * .5f, 1.f };
+    // the camera looks down -Z in view space
+    draw.viewDepth = -(view * (draw.model * center)).z;
+  }
+  this->depthOrder.resize(this->meshDraws.size());
+  std::iota(this->depthOrder.begin(), this->depthOrder.end(), 0u);
+  std::sort(this->depthOrder.begin(), this->depthOrder.end(), [this](uint32_t a, uint32_t b) {
+    return this->meshDraws[a].viewDepth < this->meshDraws[b].viewDepth;
+  });
+}
+
+static void SetFlippedViewport(Engine::Renderers::Vulkan::CommandBuffer& cmdBuffer, VkExtent2D extent) {
+  VkViewport viewport = {};
+  viewport.x = 0.0f;
+  viewport.y = static_cast<float>(extent.height);
+  viewport.width = static_cast<float>(extent.width);
+  viewport.height = -static_cast<float>(extent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+
+  VkRect2D scissor = {};
+  scissor.offset = { 0, 0 };
+  scissor.extent = extent;
+
+  vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+}
+
+void Renderer::recordDepthPrepass(RenderGraph::PassContext& context, FrameInfo& frameInfo) {
+  auto& cmdBuffer = context.cmdBuffer;
+  SetFlippedViewport(cmdBuffer, context.extent);
+
+  VkFrameInfo vkFrameInfo{
+    frameInfo,
+    this->currentFrameIndex,
+    cmdBuffer,
+    this->objectShader->getGlobalDescriptorSet(),
+    this->objectShader->getGlobalUniformOffset()
+  };
+  this->depthShader->use(vkFrameInfo);
+  this->boundObjectShader = this->depthShader.get();
+  this->passGlobalUniformOffset = vkFrameInfo.globalUniformOffset;
+  VkBuffer vertexBuffers[] = { this->objectPositionBuffer->getHandle() };
+  VkDeviceSize offsets[] = { 0 };
+  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+  vkCmdBindIndexBuffer(cmdBuffer, this->objectIndexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+  this->recordTestObjects(cmdBuffer, this->depthShader->getPipelineLayout());
+
+  // closest first, so most hidden fragments fail the depth test before being written
+  for (uint32_t index : this->depthOrder)
+    this->recordMeshDepth(cmdBuffer, this->meshDraws[index]);
+}
+
+void Renderer::recordMainPass(RenderGraph::PassContext& context, FrameInfo& frameInfo) {
+  auto& cmdBuffer = context.cmdBuffer;
+  SetFlippedViewport(cmdBuffer, context.extent);
+
+  // the prepass pipeline binds the object shader's offset, it never updates the global uniforms itself
+  VkFrameInfo vkFrameInfo{
+    frameInfo,
+    this->currentFrameIndex,
+    cmdBuffer,
+    this->objectShader->getGlobalDescriptorSet(),
+    this->objectShader->getGlobalUniformOffset()
+  };
+  auto& shader = this->frameDepthPrepass ? *this->prepassObjectShader : *this->objectShader;
+  shader.use(vkFrameInfo);
+  this->bindLightingSet(cmdBuffer, shader.getPipelineLayout());
+  this->boundObjectShader = &shader;
+  this->passGlobalUniformOffset = vkFrameInfo.globalUniformOffset;
+  VkBuffer vertexBuffers[] = { this->objectVertexBuffer->getHandle() };
+  VkDeviceSize offsets[] = { 0 };
+  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+  vkCmdBindIndexBuffer(cmdBuffer, this->objectIndexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+  this->recordTestObjects(cmdBuffer, shader.getPipelineLayout());
+
+  // after the prepass nothing is overdrawn, the submission order groups pipeline and buffer changes
+  if (this->frameDepthPrepass) {
+    for (const auto& draw : this->meshDraws)
+      this->recordMeshDraw(cmdBuffer, draw);
+  }
+  else {
+    for (uint32_t index : this->depthOrder)
+      this->recordMeshDraw(cmdBuffer, this->meshDraws[index]);
+  }
+  // blended over the opaque meshes
+  this->billboards->record(vkFrameInfo);
+  this->particles->record(vkFrameInfo);
+
+  if (this->imguiEnabled) {
+    // valid since ImGui::Render was called for this frame by ImGuiLayer::end
+    if (auto* drawData = ImGui::GetDrawData()) {
+      GpuProfiler::ScopeGuard scope(*this->gpuProfiler, cmdBuffer, "ImGui");
+      ImGui_ImplVulkan_RenderDrawData(drawData, cmdBuffer);
+    }
+  }
+}
+
+void Renderer::recordShadowCascade(RenderGraph::PassContext& context, FrameInfo& frameInfo, const CascadedShadows::Cascade& cascade) {
+  auto& cmdBuffer = context.cmdBuffer;
+  // unflipped, CascadedShadows maps clip space to uv accordingly
+  VkViewport viewport{ 0.f, 0.f, static_cast<float>(context.extent.width), static_cast<float>(context.extent.height), 0.f, 1.f };
+  VkRect2D scissor{ { 0, 0 }, context.extent };
+  vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+
+  VkFrameInfo vkFrameInfo{
+    frameInfo,
+    this->currentFrameIndex,
+    cmdBuffer,
+    this->objectShader->getGlobalDescriptorSet(),
+    cascade.uniformOffset
+  };
+  this->shadowDepthShader->use(vkFrameInfo);
+  this->boundObjectShader = this->shadowDepthShader.get();
+  this->passGlobalUniformOffset = cascade.uniformOffset;
+  VkBuffer vertexBuffers[] = { this->objectPositionBuffer->getHandle() };
+  VkDeviceSize offsets[] = { 0 };
+  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+  vkCmdBindIndexBuffer(cmdBuffer, this->objectIndexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+  // the test objects never move
+  this->recordTestObjects(cmdBuffer, this->shadowDepthShader->getPipelineLayout());
+
+  for (const auto& draw : this->meshDraws) {
+    if (cascade.cached && !draw.isStatic)
+      continue;
+    const auto& bounds = draw.mesh->getBounds();
+    glm::vec3 center = draw.model * glm::vec4{ (bounds.min + bounds.max) * .5f, 1.f };
+    float scale = std::max({ glm::length(glm::vec3{ draw.model[0] }), glm::length(glm::vec3{ draw.model[1] }), glm::length(glm::vec3{ draw.model[2] }) });
+    if (!cascade.intersects(center, glm::length(bounds.max - bounds.min) * .5f * scale))
+      continue;
+    this->recordMeshDepth(cmdBuffer, draw, true);
+  }
+}
+
+void Renderer::recordTestObjects(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout) {
+  // plane
+  glm::vec3 offset{ 0.f, -5.f, 0.f };
+  glm::vec3 scale{ 20.f, 1.f, 20.f };
+  glm::mat4 planeModel = glm::translate(glm::mat4(1.f), offset) * glm::scale(glm::mat4(1.f), scale);
+  vkCmdPushConstants(
+    cmdBuffer,
+    pipelineLayout,
+    VK_SHADER_STAGE_VERTEX_BIT,
+    0, sizeof(glm::mat4), &planeModel
+  );
+  vkCmdDrawIndexed(cmdBuffer, 6, 1, 36, 0, 0);
+
+  // static float angle = 0.f;
+  // angle += 2.f * frameInfo.deltaTime;
+  // glm::mat4 cubeModel = glm::rotate(glm::mat4(1.f), angle, Coordinates::Up<glm::vec3>);
+  glm::mat4 cubeModel = glm::mat4{ 1.f };
+  vkCmdPushConstants(
+    cmdBuffer,
+    pipelineLayout,
+    VK_SHADER_STAGE_VERTEX_BIT,
+    0, sizeof(glm::mat4), &cubeModel
+  );
+  // cube
+  vkCmdDrawIndexed(cmdBuffer, 36, 1, 0, 0, 0);
+}
+
 void Renderer::createGraphicsCommandBuffers() {
   auto graphicsCommandPool = this->device.getGraphicsCommandPool();
   ASSERT(graphicsCommandPool != VK_NULL_HANDLE, "Invalid command pool");
@@ -251,6 +508,33 @@ void Renderer::createObjectBuffers() {
     VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
   );
+  // one position per standard vertex slot, packed meshes take slots without positions so it never runs out first
+  this->objectPositionBuffer = MakeScope<MemBuffer>(
+    this->device,
+    sizeof(glm::vec3),
+    static_cast<uint32_t>(vertexPool->getMaxSize()),
+    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+  );
+}
+
+uint64_t Renderer::uploadVertexPositions(const void* vertices, uint32_t vertexCount) {
+  const auto* source = static_cast<const Shaders::Object::Vertex*>(vertices);
+  std::vector<glm::vec3> positions(vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++)
+    positions[i] = source[i].position;
+  uint64_t offset = this->objectPositionOffset;
+  this->uploadDataToBuffer(
+    *this->objectPositionBuffer,
+    this->device.getGraphicsQueue(),
+    this->device.getGraphicsCommandPool(),
+    nullptr,
+    positions.data(),
+    positions.size() * sizeof(glm::vec3),
+    offset
+  );
+  this->objectPositionOffset += positions.size() * sizeof(glm::vec3);
+  return offset;
 }
 
 void Renderer::uploadDataToBuffer(
@@ -258,6 +542,7 @@ void Renderer::uploadDataToBuffer(
   VkQueue queue, VkCommandPool cmdPool, Fence* fence,
   const void* data, size_t size, uint64_t offset
 ) {
+  PROFILE_SCOPE("Renderer::uploadDataToBuffer");
   MemBuffer stagingBuffer(
     this->device,
     size,
@@ -280,40 +565,40 @@ void Renderer::uploadTestObjectData() {
   constexpr float mult = 10.f;
   std::vector<Shaders::Object::Vertex> vertices = {
     // right face (white)
-    {{-.5f, -.5f, -.5f}, {.9f, .9f, .9f}},
-    {{-.5f, .5f, .5f}, {.9f, .9f, .9f}},
-    {{-.5f, -.5f, .5f}, {.9f, .9f, .9f}},
-    {{-.5f, .5f, -.5f}, {.9f, .9f, .9f}},
+    {{-.5f, -.5f, -.5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+    {{-.5f, .5f, .5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+    {{-.5f, -.5f, .5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+    {{-.5f, .5f, -.5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
 
     // left face (yellow)
-    {{.5f, -.5f, -.5f}, {.8f, .8f, .1f}},
-    {{.5f, .5f, .5f}, {.8f, .8f, .1f}},
-    {{.5f, -.5f, .5f}, {.8f, .8f, .1f}},
-    {{.5f, .5f, -.5f}, {.8f, .8f, .1f}},
+    {{.5f, -.5f, -.5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+    {{.5f, .5f, .5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+    {{.5f, -.5f, .5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+    {{.5f, .5f, -.5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
 
     // bottom face (orange)
-    {{-.5f, -.5f, -.5f}, {.9f, .6f, .1f}},
-    {{.5f, -.5f, .5f}, {.9f, .6f, .1f}},
-    {{-.5f, -.5f, .5f}, {.9f, .6f, .1f}},
-    {{.5f, -.5f, -.5f}, {.9f, .6f, .1f}},
+    {{-.5f, -.5f, -.5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+    {{.5f, -.5f, .5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+    {{-.5f, -.5f, .5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+    {{.5f, -.5f, -.5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
 
     // top face (red)
-    {{-.5f, .5f, -.5f}, {.8f, .1f, .1f}},
-    {{.5f, .5f, .5f}, {.8f, .1f, .1f}},
-    {{-.5f, .5f, .5f}, {.8f, .1f, .1f}},
-    {{.5f, .5f, -.5f}, {.8f, .1f, .1f}},
+    {{-.5f, .5f, -.5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+    {{.5f, .5f, .5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+    {{-.5f, .5f, .5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+    {{.5f, .5f, -.5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
 
     // tail face (blue)
-    {{-.5f, -.5f, 0.5f}, {.1f, .1f, .8f}},
-    {{.5f, .5f, 0.5f}, {.1f, .1f, .8f}},
-    {{-.5f, .5f, 0.5f}, {.1f, .1f, .8f}},
-    {{.5f, -.5f, 0.5f}, {.1f, .1f, .8f}},
+    {{-.5f, -.5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+    {{.5f, .5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+    {{-.5f, .5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+    {{.5f, -.5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
 
     // nose face (green)
-    {{-.5f, -.5f, -0.5f}, {.1f, .8f, .1f}},
-    {{.5f, .5f, -0.5f}, {.1f, .8f, .1f}},
-    {{-.5f, .5f, -0.5f}, {.1f, .8f, .1f}},
-    {{.5f, -.5f, -0.5f}, {.1f, .8f, .1f}},
+    {{-.5f, -.5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+    {{.5f, .5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+    {{-.5f, .5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+    {{.5f, -.5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
   };
   std::vector<uint32_t> indices = {
     2,  1,  0,  1,  3,  0, // right face
@@ -332,8 +617,9 @@ void Renderer::uploadTestObjectData() {
     vertices.size() * sizeof(Shaders::Object::Vertex),
     this->objectVertexOffset
   );
-  vertexPool += vertices.size();
+  *vertexPool += vertices.size();
   this->objectVertexOffset += vertices.size() * sizeof(Shaders::Object::Vertex);
+  this->uploadVertexPositions(vertices.data(), static_cast<uint32_t>(vertices.size()));
   this->uploadDataToBuffer(
     *this->objectIndexBuffer,
     this->device.getGraphicsQueue(),
@@ -343,14 +629,14 @@ void Renderer::uploadTestObjectData() {
     indices.size() * sizeof(uint32_t),
     this->objectIndexOffset
   );
-  indexPool += indices.size();
+  *indexPool += indices.size();
   this->objectIndexOffset += indices.size() * sizeof(uint32_t);
 
   std::vector<Shaders::Object::Vertex> planeVertices = {
-    {{-.5f, 0.f, -.5f}, {.9f, .9f, .9f}},
-    {{-.5f, 0.f, .5f}, {.9f, .9f, .9f}},
-    {{.5f, 0.f, -.5f}, {.9f, .9f, .9f}},
-    {{.5f, 0.f, .5f}, {.9f, .9f, .9f}},
+    {{-.5f, 0.f, -.5f}, {.9f, .9f, .9f}, {0.f, 1.f, 0.f}},
+    {{-.5f, 0.f, .5f}, {.9f, .9f, .9f}, {0.f, 1.f, 0.f}},
+    {{.5f, 0.f, -.5f}, {.9f, .9f, .9f}, {0.f, 1.f, 0.f}},
+    {{.5f, 0.f, .5f}, {.9f, .9f, .9f}, {0.f, 1.f, 0.f}},
   };
   std::vector<uint32_t> planeIndices = { 0, 1, 2, 2, 1, 3 };
   for (auto& index : planeIndices) {
@@ -365,8 +651,9 @@ void Renderer::uploadTestObjectData() {
     planeVertices.size() * sizeof(Shaders::Object::Vertex),
     this->objectVertexOffset
   );
-  vertexPool += planeVertices.size();
+  *vertexPool += planeVertices.size();
   this->objectVertexOffset += planeVertices.size() * sizeof(Shaders::Object::Vertex);
+  this->uploadVertexPositions(planeVertices.data(), static_cast<uint32_t>(planeVertices.size()));
   this->uploadDataToBuffer(
     *this->objectIndexBuffer,
     this->device.getGraphicsQueue(),
@@ -376,14 +663,276 @@ void Renderer::uploadTestObjectData() {
     planeIndices.size() * sizeof(uint32_t),
     this->objectIndexOffset
   );
-  indexPool += planeIndices.size();
+  *indexPool += planeIndices.size();
   this->objectIndexOffset += planeIndices.size() * sizeof(uint32_t);
 }
 
 Engine::Ref<Engine::Texture2D> Renderer::createTexture2D(const TextureSpecification& spec) {
+  PROFILE_SCOPE("Renderer::createTexture2D");
+  MEMORY_TAG(Assets);
   return MakeRef<Texture2D>(this->device, spec);
 }
 Engine::Ref<Engine::Texture2D> Renderer::createTexture2D(const std::string_view& path) {
   ASSERT(false, "Not implemented");
   return nullptr;
-}
\ No newline at end of file
+}
+
+Engine::Ref<Engine::Mesh> Renderer::createMesh(const std::string_view& path, MeshVertexFormat format) {
+  PROFILE_SCOPE("Renderer::createMesh");
+  MEMORY_TAG(Assets);
+  std::string cookedPath = MeshImporter::Cook(path, format);
+  if (cookedPath.empty()) {
+    LOG_RENDERER_ERROR("Renderer::createMesh: Failed to cook {}", path);
+    return nullptr;
+  }
+  MappedFile file(cookedPath);
+  CookedMesh cooked;
+  if (!file.isOpen() || !MeshImporter::ReadCooked(file, cooked)) {
+    LOG_RENDERER_ERROR("Renderer::createMesh: Failed to load {}", cookedPath);
+    return nullptr;
+  }
+  const auto& header = *cooked.header;
+  uint32_t expectedStride = header.vertexFormat == MeshVertexFormat::Packed ? sizeof(Shaders::Object::PackedVertex) : sizeof(Shaders::Object::Vertex);
+  if (header.vertexStride != expectedStride) {
+    LOG_RENDERER_ERROR("Renderer::createMesh: {} has an unsupported vertex stride {}", cookedPath, header.vertexStride);
+    return nullptr;
+  }
+  uint64_t vertexBytes = uint64_t(header.vertexStride) * header.vertexCount;
+  uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(uint32_t);
+  // the vertex pool is accounted in standard vertex slots, packed meshes take less than half of them
+  uint64_t vertexSlots = (vertexBytes + sizeof(Shaders::Object::Vertex) - 1) / sizeof(Shaders::Object::Vertex);
+  if (vertexPool->getSize() + vertexSlots > vertexPool->getMaxSize() ||
+    indexPool->getSize() + header.indexCount > indexPool->getMaxSize()) {
+    LOG_RENDERER_ERROR("Renderer::createMesh: Not enough space left in the object buffers for {}", path);
+    return nullptr;
+  }
+
+  MeshAllocation allocation{};
+  allocation.firstIndex = static_cast<uint32_t>(this->objectIndexOffset / sizeof(uint32_t));
+  allocation.indexCount = header.indexCount;
+  allocation.vertexByteOffset = this->objectVertexOffset;
+  allocation.vertexCount = header.vertexCount;
+  allocation.vertexFormat = header.vertexFormat;
+
+  // the mapping is read directly by the staging copy, no intermediate buffer
+  this->uploadDataToBuffer(
+    *this->objectVertexBuffer,
+    this->device.getGraphicsQueue(),
+    this->device.getGraphicsCommandPool(),
+    nullptr,
+    cooked.vertices,
+    vertexBytes,
+    this->objectVertexOffset
+  );
+  *vertexPool += vertexSlots;
+  this->objectVertexOffset += vertexBytes;
+  if (header.vertexFormat == MeshVertexFormat::Standard)
+    allocation.positionByteOffset = this->uploadVertexPositions(cooked.vertices, header.vertexCount);
+  this->uploadDataToBuffer(
+    *this->objectIndexBuffer,
+    this->device.getGraphicsQueue(),
+    this->device.getGraphicsCommandPool(),
+    nullptr,
+    cooked.indices,
+    indexBytes,
+    this->objectIndexOffset
+  );
+  *indexPool += header.indexCount;
+  this->objectIndexOffset += indexBytes;
+
+  std::vector<MeshLod> lods;
+  if (cooked.lods)
+    lods.assign(cooked.lods, cooked.lods + header.lodCount);
+  else
+    lods.push_back({ 0, header.indexCount, 0.f });
+
+  LOG_RENDERER_INFO("Loaded mesh {} ({} vertices, {} indices, {} lods)", path, header.vertexCount, header.indexCount, lods.size());
+  // Mesh objects and their control blocks live in a fixed slab, meshes are created and destroyed while streaming
+  auto* meshPool = Engine::PoolManager::Get<Engine::Pools::RendererMeshes>();
+  return std::allocate_shared<Mesh>(Engine::PoolAllocator<Mesh>(*meshPool), path, allocation, header.bounds, std::move(lods));
+}
+
+void Renderer::drawMesh(const Engine::Mesh& mesh, const glm::mat4& model, uint32_t lod, bool isStatic) {
+  ASSERT(this->hasFrameStarted, "Renderer::drawMesh: Frame not started");
+  this->meshDraws.push_back({ &static_cast<const Mesh&>(mesh), model, lod, isStatic });
+  if (isStatic)
+    this->shadows->addStaticCaster(mesh, model);
+}
+
+void Renderer::drawBillboard(const glm::vec3& position, const Components::Billboard& billboard) {
+  ASSERT(this->hasFrameStarted, "Renderer::drawBillboard: Frame not started");
+  this->billboards->add(position, billboard);
+}
+
+void Renderer::emitParticles(const glm::vec3& position, const Components::ParticleEmitter& emitter, uint32_t count) {
+  ASSERT(this->hasFrameStarted, "Renderer::emitParticles: Frame not started");
+  this->particles->emit(position, emitter, count);
+}
+
+void Renderer::addPointLight(const glm::vec3& position, const Components::PointLight& light) {
+  ASSERT(this->hasFrameStarted, "Renderer::addPointLight: Frame not started");
+  this->lighting->addPointLight(position, light);
+}
+
+void Renderer::setGlobalLight(const glm::vec3& direction, const Components::GlobalLight& light) {
+  ASSERT(this->hasFrameStarted, "Renderer::setGlobalLight: Frame not started");
+  this->lighting->setGlobalLight(direction, light);
+  this->shadows->setLight(direction);
+}
+
+void Renderer::bindObjectShader(CommandBuffer& cmdBuffer, const Shaders::Base& shader, bool lit) {
+  if (this->boundObjectShader == &shader)
+    return;
+  // every object and depth pipeline uses the same global set layout, so the object shader's set can be reused
+  VkDescriptorSet globalDescriptorSet = this->objectShader->getGlobalDescriptorSet();
+  uint32_t globalUniformOffset = this->passGlobalUniformOffset;
+  shader.getPipeline().bind(cmdBuffer);
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    shader.getPipelineLayout(),
+    0, 1, &globalDescriptorSet,
+    1, &globalUniformOffset
+  );
+  // standard and packed layouts differ by their push constants, so binding the other one disturbs every set
+  if (lit)
+    this->bindLightingSet(cmdBuffer, shader.getPipelineLayout());
+  this->boundObjectShader = &shader;
+}
+
+void Renderer::bindLightingSet(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout) {
+  VkDescriptorSet lightingDescriptorSet = this->lighting->getDescriptorSet();
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    pipelineLayout,
+    1, 1, &lightingDescriptorSet,
+    ClusteredLighting::DynamicOffsetCount, this->lighting->getDynamicOffsets()
+  );
+  VkDescriptorSet shadowDescriptorSet = this->shadows->getDescriptorSet();
+  uint32_t shadowOffset = this->shadows->getDynamicOffset();
+  vkCmdBindDescriptorSets(
+    cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    pipelineLayout,
+    2, 1, &shadowDescriptorSet,
+    1, &shadowOffset
+  );
+}
+
+void Renderer::pushMeshConstants(CommandBuffer& cmdBuffer, VkPipelineLayout pipelineLayout, const MeshDraw& draw) {
+  if (draw.mesh->getVertexFormat() == MeshVertexFormat::Packed) {
+    const auto& bounds = draw.mesh->getBounds();
+    Shaders::Object::PackedPushConstants pushConstants{
+      draw.model,
+      glm::vec4{ bounds.min, 0.f },
+      glm::vec4{ bounds.max - bounds.min, 0.f }
+    };
+    vkCmdPushConstants(
+      cmdBuffer,
+      pipelineLayout,
+      VK_SHADER_STAGE_VERTEX_BIT,
+      0, sizeof(pushConstants), &pushConstants
+    );
+  }
+  else {
+    vkCmdPushConstants(
+      cmdBuffer,
+      pipelineLayout,
+      VK_SHADER_STAGE_VERTEX_BIT,
+      0, sizeof(glm::mat4), &draw.model
+    );
+  }
+}
+
+void Renderer::recordMeshDraw(CommandBuffer& cmdBuffer, const MeshDraw& draw) {
+  const auto& allocation = draw.mesh->getAllocation();
+  bool packed = allocation.vertexFormat == MeshVertexFormat::Packed;
+  const Shaders::Object* shader = nullptr;
+  if (this->frameDepthPrepass)
+    shader = packed ? this->prepassPackedObjectShader.get() : this->prepassObjectShader.get();
+  else
+    shader = packed ? this->packedObjectShader.get() : this->objectShader.get();
+  this->bindObjectShader(cmdBuffer, *shader, true);
+
+  VkBuffer vertexBuffers[] = { this->objectVertexBuffer->getHandle() };
+  VkDeviceSize offsets[] = { allocation.vertexByteOffset };
+  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+  this->pushMeshConstants(cmdBuffer, shader->getPipelineLayout(), draw);
+  const auto& range = draw.mesh->getLod(draw.lod);
+  vkCmdDrawIndexed(cmdBuffer, range.indexCount, 1, allocation.firstIndex + range.firstIndex, 0, 0);
+}
+
+void Renderer::recordMeshDepth(CommandBuffer& cmdBuffer, const MeshDraw& draw, bool shadowCaster) {
+  const auto& allocation = draw.mesh->getAllocation();
+  bool packed = allocation.vertexFormat == MeshVertexFormat::Packed;
+  const Shaders::Depth* shader = nullptr;
+  if (shadowCaster)
+    shader = packed ? this->packedShadowDepthShader.get() : this->shadowDepthShader.get();
+  else
+    shader = packed ? this->packedDepthShader.get() : this->depthShader.get();
+  this->bindObjectShader(cmdBuffer, *shader, false);
+
+  // packed positions are already compact, they are read from the interleaved vertices
+  VkBuffer vertexBuffers[] = { packed ? this->objectVertexBuffer->getHandle() : this->objectPositionBuffer->getHandle() };
+  VkDeviceSize offsets[] = { packed ? allocation.vertexByteOffset : allocation.positionByteOffset };
+  vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+  this->pushMeshConstants(cmdBuffer, shader->getPipelineLayout(), draw);
+  // same lod as the color pass, the depth must match exactly
+  const auto& range = draw.mesh->getLod(draw.lod);
+  vkCmdDrawIndexed(cmdBuffer, range.indexCount, 1, allocation.firstIndex + range.firstIndex, 0, 0);
+}
+
+void Renderer::captureFrame(const std::string_view& path) {
+  ASSERT(this->hasFrameStarted, "Renderer::captureFrame: Frame not started");
+  if (!this->swapchain->canReadback()) {
+    LOG_RENDERER_WARN("Renderer::captureFrame: swapchain images cannot be read back");
+    return;
+  }
+  this->frameCapture->request(std::string(path));
+}
+
+bool Renderer::initImGui() {
+  // the backend only allocates the font texture set, the rest is left for user textures
+  this->imguiDescriptorPool = DescriptorPool::Builder(this->device)
+    .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+    .setMaxSets(64)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64)
+    .build();
+
+  uint32_t imageCount = this->swapchain->getImageCount();
+  ImGui_ImplVulkan_InitInfo initInfo{};
+  initInfo.Instance = this->device.getInstance();
+  initInfo.PhysicalDevice = this->device.getPhysicalDevice();
+  initInfo.Device = this->device;
+  initInfo.QueueFamily = this->device.getQueueFamilies().graphicsFamily;
+  initInfo.Queue = this->device.getGraphicsQueue();
+  initInfo.DescriptorPool = *this->imguiDescriptorPool;
+  // swapchain recreation keeps the formats, so the pipeline stays compatible with the new render pass
+  initInfo.RenderPass = this->getMainRenderPass();
+  initInfo.MinImageCount = std::max(2u, imageCount);
+  initInfo.ImageCount = std::max(2u, imageCount);
+  initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+  initInfo.Allocator = this->device.getAllocator();
+  if (!ImGui_ImplVulkan_Init(&initInfo)) {
+    this->imguiDescriptorPool.reset();
+    return false;
+  }
+  this->imguiEnabled = true;
+  LOG_RENDERER_INFO("ImGui backend initialized");
+  return true;
+}
+
+void Renderer::shutdownImGui() {
+  if (!this->imguiEnabled)
+    return;
+  this->device.waitIdle();
+  ImGui_ImplVulkan_Shutdown();
+  this->imguiDescriptorPool.reset();
+  this->imguiEnabled = false;
+}
+
+void Renderer::beginImGuiFrame() {
+  // creates the font texture on first use
+  ImGui_ImplVulkan_NewFrame();
+}
@@ -31,4 +31,17 @@ namespace Engine::Renderers::Vulkan {
       func(instance, debugMessenger, pAllocator);
     }
   }
+
+  void CmdPipelineBarrier2(
+    VkDevice device,
+    VkCommandBuffer commandBuffer,
+    const VkDependencyInfoKHR* pDependencyInfo
+  ) {
+    static auto func = (PFN_vkCmdPipelineBarrier2KHR)vkGetDeviceProcAddr(
+      device,
+      "vkCmdPipelineBarrier2KHR");
+    if (func != nullptr) {
+      func(commandBuffer, pDependencyInfo);
+    }
+  }
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "renderer/apis/Vulkan/shaders/Billboard.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+
+using namespace Engine::Renderers::Vulkan::Shaders;
+
+static_assert(sizeof(Billboard::Instance) == 48);
+
+Billboard::Billboard(
+  Renderer& ctx,
+  VkRenderPass renderPass,
+  VkDescriptorSetLayout globalDescriptorSetLayout,
+  VkDescriptorSetLayout instanceDescriptorSetLayout
+) : Base(ctx, Billboard::StagesName), renderPass(renderPass) {
+  this->init(globalDescriptorSetLayout, instanceDescriptorSetLayout);
+}
+
+void Billboard::init(VkDescriptorSetLayout globalDescriptorSetLayout, VkDescriptorSetLayout instanceDescriptorSetLayout) {
+  auto vertexStage = this->addStage<BuiltinStage>(StageType::Vertex);
+  auto fragStage = this->addStage<BuiltinStage>(StageType::Fragment);
+  Pipeline::ConfigInfo configInfo = {};
+  Pipeline::SetupDefaultConfigInfo(configInfo);
+  configInfo.enableAlphaBlending();
+  // transparent, the opaque depth is kept for whatever is drawn next
+  configInfo.depthStencilInfo.depthWriteEnable = VK_FALSE;
+  configInfo.renderPass = this->renderPass;
+  configInfo.stages = {
+    vertexStage->getPipelineShaderStageCreateInfo(),
+    fragStage->getPipelineShaderStageCreateInfo()
+  };
+  configInfo.descriptorSetLayouts = { globalDescriptorSetLayout, instanceDescriptorSetLayout };
+
+  this->Base::init(configInfo);
+}
+
+void Billboard::use(VkFrameInfo& frameInfo) {
+  this->pipeline->bind(frameInfo.cmdBuffer);
+  vkCmdBindDescriptorSets(
+    frameInfo.cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    this->pipeline->getLayout(),
+    0, 1, &frameInfo.globalDescriptorSet,
+    1, &frameInfo.globalUniformOffset
+  );
+}
@@ -0,0 +1,64 @@
+#include "renderer/apis/Vulkan/shaders/Depth.h"
+#include "renderer/apis/Vulkan/shaders/Object.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+
+#include <cstddef>
+
+using namespace Engine::Renderers::Vulkan::Shaders;
+
+Depth::Depth(
+  Renderer& ctx,
+  VkRenderPass renderPass,
+  VkDescriptorSetLayout globalDescriptorSetLayout,
+  MeshVertexFormat vertexFormat,
+  bool shadowCaster
+)
+  : Base(ctx, vertexFormat == MeshVertexFormat::Packed ? Depth::PackedStagesName : Depth::StagesName),
+  renderPass(renderPass), vertexFormat(vertexFormat), shadowCaster(shadowCaster) {
+  this->init(globalDescriptorSetLayout);
+}
+
+void Depth::init(VkDescriptorSetLayout globalDescriptorSetLayout) {
+  auto vertexStage = this->addStage<BuiltinStage>(StageType::Vertex);
+  Pipeline::ConfigInfo configInfo = {};
+  Pipeline::SetupDefaultConfigInfo(configInfo);
+  if (this->shadowCaster) {
+    // single sided casters like planes must still cast, acne is pushed back by the bias instead
+    configInfo.rasterizerInfo.depthBiasEnable = VK_TRUE;
+    configInfo.rasterizerInfo.depthBiasConstantFactor = 1.f;
+    configInfo.rasterizerInfo.depthBiasSlopeFactor = 2.f;
+  }
+  else
+    configInfo.enableRasterizationCulling();
+  configInfo.colorBlendingInfo.attachmentCount = 0;
+  configInfo.colorBlendingInfo.pAttachments = nullptr;
+  bool packed = this->vertexFormat == MeshVertexFormat::Packed;
+  if (packed) {
+    configInfo.bindingDescriptions = { { 0, sizeof(Object::PackedVertex), VK_VERTEX_INPUT_RATE_VERTEX } };
+    configInfo.attributeDescriptions = { { 0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(Object::PackedVertex, position) } };
+  }
+  else {
+    configInfo.bindingDescriptions = { { 0, sizeof(glm::vec3), VK_VERTEX_INPUT_RATE_VERTEX } };
+    configInfo.attributeDescriptions = { { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 } };
+  }
+  configInfo.renderPass = this->renderPass;
+  configInfo.stages = { vertexStage->getPipelineShaderStageCreateInfo() };
+  configInfo.descriptorSetLayouts = { globalDescriptorSetLayout };
+  uint32_t pushConstantsSize = packed ? sizeof(Object::PackedPushConstants) : sizeof(glm::mat4);
+  configInfo.pushConstantRanges = {
+    { VK_SHADER_STAGE_VERTEX_BIT, 0, pushConstantsSize }
+  };
+
+  this->Base::init(configInfo);
+}
+
+void Depth::use(VkFrameInfo& frameInfo) {
+  this->pipeline->bind(frameInfo.cmdBuffer);
+  vkCmdBindDescriptorSets(
+    frameInfo.cmdBuffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    this->pipeline->getLayout(),
+    0, 1, &frameInfo.globalDescriptorSet,
+    1, &frameInfo.globalUniformOffset
+  );
+}
@@ -0,0 +1,22 @@
+#include "renderer/apis/Vulkan/shaders/LightCulling.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+
+using namespace Engine::Renderers::Vulkan::Shaders;
+
+LightCulling::LightCulling(Renderer& ctx, VkDescriptorSetLayout clusterDescriptorSetLayout)
+  : Base(ctx, LightCulling::StagesName) {
+  this->init(clusterDescriptorSetLayout);
+}
+
+void LightCulling::init(VkDescriptorSetLayout clusterDescriptorSetLayout) {
+  auto computeStage = this->addStage<BuiltinStage>(StageType::Compute);
+  Pipeline::ConfigInfo configInfo = {};
+  configInfo.stages = { computeStage->getPipelineShaderStageCreateInfo() };
+  configInfo.descriptorSetLayouts = { clusterDescriptorSetLayout };
+
+  this->Base::init(configInfo);
+}
+
+void LightCulling::use(VkFrameInfo& frameInfo) {
+  this->pipeline->bind(frameInfo.cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
+}
@@ -1,10 +1,25 @@
 #include "renderer/apis/Vulkan/shaders/Object.h"
 #include "renderer/apis/Vulkan/VulkanRenderer.h"
+#include <engine/renderer/Mesh.h>
+
+#include <cstddef>
 
 using namespace Engine::Renderers::Vulkan::Shaders;
 
-Object::Object(Renderer& ctx, RenderPass& renderPass)
-  : Base(ctx, Object::StagesName), renderPass(renderPass), ubo(ctx.getDevice(), ctx.getSwapchain().getMaxFramesInFlight()) {
+// cooked meshes are uploaded without conversion
+static_assert(sizeof(Object::Vertex) == sizeof(Engine::MeshVertex));
+static_assert(offsetof(Object::Vertex, position) == offsetof(Engine::MeshVertex, position));
+static_assert(offsetof(Object::Vertex, color) == offsetof(Engine::MeshVertex, color));
+static_assert(offsetof(Object::Vertex, normal) == offsetof(Engine::MeshVertex, normal));
+static_assert(offsetof(Object::Vertex, uv) == offsetof(Engine::MeshVertex, uv));
+static_assert(sizeof(Object::PackedVertex) == sizeof(Engine::PackedMeshVertex));
+static_assert(offsetof(Object::PackedVertex, normal) == offsetof(Engine::PackedMeshVertex, normal));
+static_assert(offsetof(Object::PackedVertex, uv) == offsetof(Engine::PackedMeshVertex, uv));
+static_assert(offsetof(Object::PackedVertex, color) == offsetof(Engine::PackedMeshVertex, color));
+
+Object::Object(Renderer& ctx, RenderPass& renderPass, MeshVertexFormat vertexFormat, bool afterDepthPrepass)
+  : Base(ctx, vertexFormat == MeshVertexFormat::Packed ? Object::PackedStagesName : Object::StagesName),
+  renderPass(renderPass), vertexFormat(vertexFormat), afterDepthPrepass(afterDepthPrepass) {
   this->init();
 }
 
@@ -12,41 +27,54 @@ Object::~Object() {}
 
 void Object::init() {
   auto vertexStage = this->addStage<BuiltinStage>(StageType::Vertex);
-  auto fragStage = this->addStage<BuiltinStage>(StageType::Fragment);
+  // both vertex formats output the same varyings
+  auto fragStage = this->addStage<BuiltinStage>(StageType::Fragment, Object::StagesName);
   Pipeline::ConfigInfo configInfo = {};
   Pipeline::SetupDefaultConfigInfo(configInfo);
   configInfo.enableRasterizationCulling();
-  configInfo.bindingDescriptions = Vertex::GetBindingDescriptions();
-  configInfo.attributeDescriptions = Vertex::GetAttributeDescriptions();
+  if (this->afterDepthPrepass) {
+    // only the closest fragment of each pixel passes, everything else was rejected by early depth testing
+    configInfo.depthStencilInfo.depthCompareOp = VK_COMPARE_OP_EQUAL;
+    configInfo.depthStencilInfo.depthWriteEnable = VK_FALSE;
+  }
+  if (this->vertexFormat == MeshVertexFormat::Packed) {
+    configInfo.bindingDescriptions = PackedVertex::GetBindingDescriptions();
+    configInfo.attributeDescriptions = PackedVertex::GetAttributeDescriptions();
+  }
+  else {
+    configInfo.bindingDescriptions = Vertex::GetBindingDescriptions();
+    configInfo.attributeDescriptions = Vertex::GetAttributeDescriptions();
+  }
   configInfo.renderPass = this->renderPass;
   configInfo.stages = {
     vertexStage->getPipelineShaderStageCreateInfo(),
     fragStage->getPipelineShaderStageCreateInfo()
   };
   // Descriptors
-  uint32_t maxFramesInFlight = this->ctx.getSwapchain().getMaxFramesInFlight();
+  // a single set for every frame, the frame's uniforms are selected by the dynamic offset
   this->globalDescriptorPool = std::move(DescriptorPool::Builder(this->ctx.getDevice())
-    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxFramesInFlight)
-    .setMaxSets(maxFramesInFlight)
+    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+    .setMaxSets(1)
     .build());
   this->globalDescriptorSetLayout = std::move(DescriptorSetLayout::Builder(this->ctx.getDevice())
-    .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+    .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
     .build());
-  this->globalDescriptorSets.resize(maxFramesInFlight);
-  for (uint32_t i = 0; i < maxFramesInFlight; i++) {
-    this->ubo.bind(
-      *this->globalDescriptorPool,
-      *this->globalDescriptorSetLayout,
-      i, 0,
-      this->globalDescriptorSets[i]
-    );
-  }
-  std::vector<VkDescriptorSetLayout> setLayouts = { *this->globalDescriptorSetLayout };
+  auto bufferInfo = this->ctx.getFrameAllocator().getDescriptorInfo(sizeof(GlobalUbo));
+  DescriptorWriter(*this->globalDescriptorSetLayout, *this->globalDescriptorPool)
+    .write(0, &bufferInfo)
+    .build(this->globalDescriptorSet);
+  // set 1 is the clustered lighting set and set 2 the shadow set, bound by the renderer
+  std::vector<VkDescriptorSetLayout> setLayouts = {
+    *this->globalDescriptorSetLayout,
+    this->ctx.getLighting().getDescriptorSetLayout(),
+    this->ctx.getShadows().getDescriptorSetLayout()
+  };
   configInfo.descriptorSetLayouts = setLayouts;
 
   // push constants
+  uint32_t pushConstantsSize = this->vertexFormat == MeshVertexFormat::Packed ? sizeof(PackedPushConstants) : sizeof(glm::mat4);
   configInfo.pushConstantRanges = {
-    { VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4) }
+    { VK_SHADER_STAGE_VERTEX_BIT, 0, pushConstantsSize }
   };
 
   this->Base::init(configInfo);
@@ -65,8 +93,27 @@ std::vector<VkVertexInputAttributeDescription> Object::Vertex::GetAttributeDescr
 
   attributeDescriptions.push_back({ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) });
   attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color) });
-  // attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal) });
-  // attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) });
+  attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal) });
+  attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) });
+
+  return attributeDescriptions;
+}
+
+std::vector<VkVertexInputBindingDescription> Object::PackedVertex::GetBindingDescriptions() {
+  std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+  bindingDescriptions[0].binding = 0;
+  bindingDescriptions[0].stride = sizeof(PackedVertex);
+  bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  return bindingDescriptions;
+}
+
+std::vector<VkVertexInputAttributeDescription> Object::PackedVertex::GetAttributeDescriptions() {
+  std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+  attributeDescriptions.push_back({ 0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, position) });
+  attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color) });
+  attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal) });
+  attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, uv) });
 
   return attributeDescriptions;
 }
@@ -78,12 +125,12 @@ void Object::use(VkFrameInfo& frameInfo) {
     VK_PIPELINE_BIND_POINT_GRAPHICS,
     this->pipeline->getLayout(),
     0, 1, &frameInfo.globalDescriptorSet,
-    0, nullptr
+    1, &frameInfo.globalUniformOffset
   );
 }
 
 void Object::updateGlobalUniforms(VkFrameInfo& frameInfo) {
-  GlobalUbo& uboData = this->ubo;
-  uboData = frameInfo.shared.globalUbo;
-  this->ubo.update(frameInfo.frameIndex);
+  auto allocation = this->ctx.getFrameAllocator().write(frameInfo.shared.globalUbo);
+  ASSERT(allocation, "Object::updateGlobalUniforms: frame allocator exhausted");
+  this->globalUniformOffset = allocation.offset;
 }
@@ -0,0 +1,25 @@
+#include "renderer/apis/Vulkan/shaders/Particles.h"
+#include "renderer/apis/Vulkan/VulkanRenderer.h"
+
+using namespace Engine::Renderers::Vulkan::Shaders;
+
+Particles::Particles(Renderer& ctx, Kernel kernel, VkDescriptorSetLayout descriptorSetLayout, uint32_t pushConstantsSize)
+  : Base(ctx, Particles::GetStagesName(kernel)) {
+  this->init(descriptorSetLayout, pushConstantsSize);
+}
+
+void Particles::init(VkDescriptorSetLayout descriptorSetLayout, uint32_t pushConstantsSize) {
+  auto computeStage = this->addStage<BuiltinStage>(StageType::Compute);
+  Pipeline::ConfigInfo configInfo = {};
+  configInfo.stages = { computeStage->getPipelineShaderStageCreateInfo() };
+  configInfo.descriptorSetLayouts = { descriptorSetLayout };
+  configInfo.pushConstantRanges = {
+    { VK_SHADER_STAGE_COMPUTE_BIT, 0, pushConstantsSize }
+  };
+
+  this->Base::init(configInfo);
+}
+
+void Particles::use(VkFrameInfo& frameInfo) {
+  this->pipeline->bind(frameInfo.cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
+}
@@ -35,6 +35,7 @@ namespace Engine::Renderers::Vulkan::Shaders {
     switch (type) {
       case StageType::Vertex: return "vert";
       case StageType::Fragment: return "frag";
+      case StageType::Compute: return "comp";
     }
     return "";
   }
@@ -43,6 +44,7 @@ namespace Engine::Renderers::Vulkan::Shaders {
     switch (type) {
       case StageType::Vertex: return VK_SHADER_STAGE_VERTEX_BIT;
       case StageType::Fragment: return VK_SHADER_STAGE_FRAGMENT_BIT;
+      case StageType::Compute: return VK_SHADER_STAGE_COMPUTE_BIT;
     }
     return VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
   }
@@ -1,10 +1,19 @@
 #include "engine/scene/Scene.h"
 #include <engine/scene/Entity.h>
+#include <engine/renderer/Camera.h>
+#include <engine/renderer/FrameInfo.h>
+#include <engine/renderer/RendererAPI.h>
+#include <engine/core/Profiler.h>
+#include <engine/core/MemoryTracker.h>
+#include <engine/core/FrameAllocator.h>
+
+#include <algorithm>
 
 using Engine::Scene;
 using Engine::Entity;
 
 Entity Scene::createEntity(const std::string_view tag) {
+  MEMORY_TAG(Scene);
   Entity entity{ this->registry.create(), this };
   Entity::UUID uuid = Components::ID::GenerateId();
   if (tag.empty())
@@ -16,6 +25,7 @@ Entity Scene::createEntity(const std::string_view tag) {
   return entity;
 }
 void Scene::destroyEntity(Entity entity) {
+  MEMORY_TAG(Scene);
   this->registry.destroy(entity);
   this->entityMap.erase(entity.getUniqId());
 }
@@ -44,4 +54,67 @@ std::vector<Entity> Scene::getEntitiesByTag(const std::string_view tag) {
       entities.emplace_back(handle, this);
   }
   return entities;
+}
+
+void Scene::render(const Camera& camera, FrameInfo& frameInfo) {
+  PROFILE_SCOPE("Scene::render");
+  MEMORY_TAG(Scene);
+  auto* renderer = Renderer::Get();
+  glm::vec3 cameraPosition{ frameInfo.globalUbo.inverseView[3] };
+  auto view = this->viewEntitiesWith<Components::Transform, Components::Mesh>();
+
+  struct Draw {
+    const Mesh* mesh;
+    glm::mat4 model;
+    uint32_t lod;
+    bool isStatic;
+  };
+  // sorted by vertex format then mesh so pipeline and vertex buffer changes are grouped
+  FrameVector<Draw> draws;
+  draws.reserve(view.size_hint());
+  for (auto handle : view) {
+    const auto& [transform, mesh] = view.get<Components::Transform, Components::Mesh>(handle);
+    if (!mesh.mesh)
+      continue;
+    auto model = static_cast<glm::mat4>(transform);
+    uint32_t lod = mesh.mesh->selectLod(model, cameraPosition, camera, mesh.lodPixelError);
+    draws.push_back({ mesh.mesh.get(), model, lod, mesh.isStatic });
+  }
+  std::sort(draws.begin(), draws.end(), [](const Draw& a, const Draw& b) {
+    if (a.mesh->getVertexFormat() != b.mesh->getVertexFormat())
+      return a.mesh->getVertexFormat() < b.mesh->getVertexFormat();
+    return a.mesh < b.mesh;
+  });
+  for (const auto& draw : draws)
+    renderer->drawMesh(*draw.mesh, draw.model, draw.lod, draw.isStatic);
+
+  auto billboards = this->viewEntitiesWith<Components::Transform, Components::Billboard>();
+  for (auto handle : billboards) {
+    const auto& [transform, billboard] = billboards.get<Components::Transform, Components::Billboard>(handle);
+    renderer->drawBillboard(transform.translation, billboard);
+  }
+
+  // the GPU only gets the number of particles to spawn this frame
+  auto emitters = this->viewEntitiesWith<Components::Transform, Components::ParticleEmitter>();
+  for (auto handle : emitters) {
+    auto [transform, emitter] = emitters.get<Components::Transform, Components::ParticleEmitter>(handle);
+    if (!emitter.emitting)
+      continue;
+    emitter.emitAccumulator += emitter.rate * frameInfo.deltaTime;
+    auto count = static_cast<uint32_t>(emitter.emitAccumulator);
+    emitter.emitAccumulator -= static_cast<float>(count);
+    if (count > 0)
+      renderer->emitParticles(transform.translation, emitter, count);
+  }
+
+  auto pointLights = this->viewEntitiesWith<Components::Transform, Components::PointLight>();
+  for (auto handle : pointLights) {
+    const auto& [transform, light] = pointLights.get<Components::Transform, Components::PointLight>(handle);
+    renderer->addPointLight(transform.translation, light);
+  }
+  auto globalLights = this->viewEntitiesWith<Components::Transform, Components::GlobalLight>();
+  for (auto handle : globalLights) {
+    const auto& [transform, light] = globalLights.get<Components::Transform, Components::GlobalLight>(handle);
+    renderer->setGlobalLight(transform.forward(), light);
+  }
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "utils/MappedFile.h"
+#include <utils/logger.h>
+
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using Engine::MappedFile;
+
+MappedFile::MappedFile(const std::string_view path) {
+  this->open(path);
+}
+
+MappedFile::~MappedFile() {
+  this->close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this == &other)
+    return *this;
+  this->close();
+#ifdef _WIN32
+  this->fileHandle = std::exchange(other.fileHandle, nullptr);
+  this->mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+  this->fd = std::exchange(other.fd, -1);
+#endif
+  this->ptr = std::exchange(other.ptr, nullptr);
+  this->length = std::exchange(other.length, 0);
+  return *this;
+}
+
+bool MappedFile::open(const std::string_view path) {
+  this->close();
+  std::string filePath{ path };
+#ifdef _WIN32
+  HANDLE file = CreateFileA(
+    filePath.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+    nullptr
+  );
+  if (file == INVALID_HANDLE_VALUE) {
+    LOG_ERROR("Failed to open file {} for mapping", path);
+    return false;
+  }
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    LOG_ERROR("Failed to map file {}: empty or unreadable", path);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    LOG_ERROR("Failed to create file mapping for {}", path);
+    return false;
+  }
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    LOG_ERROR("Failed to map view of file {}", path);
+    return false;
+  }
+  this->fileHandle = file;
+  this->mappingHandle = mapping;
+  this->ptr = static_cast<const uint8_t*>(view);
+  this->length = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int file = ::open(filePath.c_str(), O_RDONLY);
+  if (file < 0) {
+    LOG_ERROR("Failed to open file {} for mapping", path);
+    return false;
+  }
+  struct stat info {};
+  if (fstat(file, &info) != 0 || info.st_size == 0) {
+    ::close(file);
+    LOG_ERROR("Failed to map file {}: empty or unreadable", path);
+    return false;
+  }
+  void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+  if (view == MAP_FAILED) {
+    ::close(file);
+    LOG_ERROR("Failed to map file {}", path);
+    return false;
+  }
+  madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+  this->fd = file;
+  this->ptr = static_cast<const uint8_t*>(view);
+  this->length = static_cast<size_t>(info.st_size);
+#endif
+  return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+  if (this->ptr)
+    UnmapViewOfFile(this->ptr);
+  if (this->mappingHandle)
+    CloseHandle(this->mappingHandle);
+  if (this->fileHandle)
+    CloseHandle(this->fileHandle);
+  this->fileHandle = nullptr;
+  this->mappingHandle = nullptr;
+#else
+  if (this->ptr)
+    munmap(const_cast<uint8_t*>(this->ptr), this->length);
+  if (this->fd >= 0)
+    ::close(this->fd);
+  this->fd = -1;
+#endif
+  this->ptr = nullptr;
+  this->length = 0;
+}
@@ -42,7 +42,7 @@ project "Sandbox"
 		runtime "Debug"
 		symbols "on"
 
-	filter "configurations:Release"
+	filter "configurations:Release or Profile"
 		defines "RELEASE"
 		runtime "Release"
 		optimize "on"
\ No newline at end of file
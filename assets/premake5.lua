@@ -7,6 +7,10 @@ project "assets"
   objdir (PROJECT_OBJ_DIR)
   files {
     "models/**.obj",
+    "models/**.mtl",
+    "models/**.gltf",
+    "models/**.glb",
+    "models/**.bin",
     "configs/**.yaml",
   }
   filter { "files:**"}
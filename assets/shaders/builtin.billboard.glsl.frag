@@ -0,0 +1,29 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec4 vertColor;
+layout(location = 1) in vec2 quadPosition;
+layout(location = 2) flat in vec2 halfSize;
+layout(location = 3) flat in float rounded;
+layout(location = 0) out vec4 fragColor;
+
+// signed distance to a box whose corners are rounded by radius
+float roundedBoxDistance(vec2 position, vec2 halfExtents, float radius) {
+  vec2 q = abs(position) - halfExtents + radius;
+  return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
+
+void main() {
+  float alpha = vertColor.a;
+  if (rounded > 0.5) {
+    // fully rounded: square billboards are discs, others are pills
+    vec2 position = quadPosition * halfSize;
+    float distance = roundedBoxDistance(position, halfSize, min(halfSize.x, halfSize.y));
+    // one pixel wide antialiased edge
+    float edge = max(fwidth(distance), 1e-6);
+    alpha *= clamp(0.5 - distance / edge, 0.0, 1.0);
+    if (alpha <= 0.0)
+      discard;
+  }
+  fragColor = vec4(vertColor.rgb, alpha);
+}
@@ -0,0 +1,47 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Camera facing quads expanded from the instance stream, 6 vertices per instance and no vertex input
+struct Billboard {
+  vec4 position; // world space
+  vec4 color;
+  vec2 size;
+  float rounded;
+  float _pad0;
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  mat4 inverseView;
+} gUbo;
+
+layout(std430, set = 1, binding = 0) readonly buffer Billboards {
+  Billboard billboards[];
+};
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 quadPosition; // -1..1 across the quad
+layout(location = 2) flat out vec2 halfSize;
+layout(location = 3) flat out float rounded;
+
+const vec2 Corners[6] = vec2[](
+  vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+  vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+void main() {
+  Billboard billboard = billboards[gl_InstanceIndex];
+  vec2 corner = Corners[gl_VertexIndex];
+  // the camera's right and up axes in world space
+  vec3 right = gUbo.inverseView[0].xyz;
+  vec3 up = gUbo.inverseView[1].xyz;
+  vec2 offset = corner * billboard.size * 0.5;
+  vec3 position = billboard.position.xyz + right * offset.x + up * offset.y;
+  gl_Position = gUbo.viewProjection * vec4(position, 1.0);
+  fragColor = billboard.color;
+  quadPosition = corner;
+  halfSize = billboard.size * 0.5;
+  rounded = billboard.rounded;
+}
@@ -0,0 +1,22 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Depth prepass variant of builtin.object, reads the position only stream
+layout(location = 0) in vec3 position;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+} gUbo;
+
+layout(push_constant) uniform PushConstants {
+  mat4 model;
+} pushConsts;
+
+// the color pass tests EQUAL against this depth
+invariant gl_Position;
+
+void main() {
+  gl_Position = gUbo.viewProjection * pushConsts.model * vec4(position, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Depth prepass variant of builtin.object.packed, only the position attribute is fetched
+layout(location = 0) in vec4 position; // unorm16, relative to the mesh bounds
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+} gUbo;
+
+layout(push_constant) uniform PushConstants {
+  mat4 model;
+  vec4 positionOffset;
+  vec4 positionScale;
+} pushConsts;
+
+// the color pass tests EQUAL against this depth
+invariant gl_Position;
+
+void main() {
+  vec3 localPosition = pushConsts.positionOffset.xyz + position.xyz * pushConsts.positionScale.xyz;
+  gl_Position = gUbo.viewProjection * pushConsts.model * vec4(localPosition, 1.0);
+}
@@ -2,8 +2,120 @@
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(location = 0) in vec3 vertColor;
+layout(location = 1) in vec3 viewPosition;
+layout(location = 2) in vec3 viewNormal;
 layout(location = 0) out vec4 fragColor;
 
+struct PointLight {
+  vec4 positionRange; // view space, range in w
+  vec4 color; // rgb, intensity in w
+};
+
+// Clustered lighting, see builtin.lightculling
+layout(set = 1, binding = 0) uniform ClusterUbo {
+  mat4 inverseProjection;
+  vec4 globalLightDirection; // view space, w is 1 when there is a global light
+  vec4 globalLightColor;
+  vec4 ambient;
+  uvec4 gridSize; // point light count in w
+  vec2 tileSize;
+  float sliceScale;
+  float sliceBias;
+  vec2 screenSize;
+  float nearClip;
+  float farClip;
+} cluster;
+
+layout(std430, set = 1, binding = 1) readonly buffer Lights {
+  PointLight lights[];
+};
+layout(std430, set = 1, binding = 2) readonly buffer LightCounts {
+  uint lightCounts[];
+};
+layout(std430, set = 1, binding = 3) readonly buffer LightIndices {
+  uint lightIndices[];
+};
+
+// Cascaded shadow maps of the global light, see CascadedShadows
+// must match CascadedShadows::CascadeCount
+const uint CascadeCount = 4;
+layout(set = 2, binding = 0) uniform ShadowUbo {
+  mat4 cascadeMatrices[CascadeCount]; // view space to shadow map uv and depth
+  vec4 splitDepths; // far view depth of each cascade
+  vec4 texelSizes; // world size of a texel of each cascade
+  uint cascadeCount; // 0 when the frame has no shadows
+  float inverseResolution;
+} shadow;
+layout(set = 2, binding = 1) uniform sampler2DShadow shadowMaps[CascadeCount];
+
+// must match ClusteredLighting::MaxLightsPerCluster
+const uint MaxLightsPerCluster = 128;
+
+uint clusterIndex() {
+  uvec3 gridSize = cluster.gridSize.xyz;
+  uvec2 tile = min(uvec2(gl_FragCoord.xy / cluster.tileSize), gridSize.xy - 1);
+  float slice = log(max(-viewPosition.z, 1e-4)) * cluster.sliceScale + cluster.sliceBias;
+  uint z = uint(clamp(slice, 0.0, float(gridSize.z - 1)));
+  return tile.x + gridSize.x * (tile.y + gridSize.y * z);
+}
+
+// sampler arrays can only be indexed with dynamically uniform values, the cascade varies per fragment
+float sampleShadowMap(uint cascade, vec3 coord) {
+  switch (cascade) {
+    case 0: return texture(shadowMaps[0], coord);
+    case 1: return texture(shadowMaps[1], coord);
+    case 2: return texture(shadowMaps[2], coord);
+    default: return texture(shadowMaps[3], coord);
+  }
+}
+
+// 1 when lit by the global light
+float globalShadow(vec3 normal) {
+  float depth = -viewPosition.z;
+  uint cascade = 0;
+  while (cascade < shadow.cascadeCount && depth > shadow.splitDepths[cascade])
+    cascade++;
+  if (cascade >= shadow.cascadeCount)
+    return 1.0;
+  // pushed along the normal by a texel and a half, against acne on surfaces grazing the light
+  vec3 position = viewPosition + normal * shadow.texelSizes[cascade] * 1.5;
+  vec3 coord = (shadow.cascadeMatrices[cascade] * vec4(position, 1.0)).xyz;
+  // 3x3 taps, each one filtered by the hardware comparison
+  float lit = 0.0;
+  for (int y = -1; y <= 1; y++) {
+    for (int x = -1; x <= 1; x++)
+      lit += sampleShadowMap(cascade, vec3(coord.xy + vec2(x, y) * shadow.inverseResolution, coord.z));
+  }
+  return lit / 9.0;
+}
+
 void main() {
-  fragColor = vec4(vertColor, 1.0);
-}
\ No newline at end of file
+  vec3 normal = normalize(viewNormal);
+  vec3 light = cluster.ambient.rgb;
+  if (cluster.globalLightDirection.w > 0.0) {
+    vec3 color = cluster.globalLightColor.rgb * cluster.globalLightColor.w;
+    float lambert = max(dot(normal, -cluster.globalLightDirection.xyz), 0.0);
+    if (lambert > 0.0)
+      light += color * lambert * globalShadow(normal);
+  }
+  if (cluster.gridSize.w > 0) {
+    uint index = clusterIndex();
+    uint count = lightCounts[index];
+    uint listOffset = index * MaxLightsPerCluster;
+    for (uint i = 0; i < count; i++) {
+      PointLight pointLight = lights[lightIndices[listOffset + i]];
+      vec3 toLight = pointLight.positionRange.xyz - viewPosition;
+      float distanceSquared = dot(toLight, toLight);
+      float range = pointLight.positionRange.w;
+      if (distanceSquared >= range * range)
+        continue;
+      // inverse square falloff, smoothly windowed to reach zero at the light's range
+      float ratio = distanceSquared / (range * range);
+      float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+      float attenuation = window * window / (distanceSquared + 1.0);
+      float lambert = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-8))), 0.0);
+      light += pointLight.color.rgb * pointLight.color.w * lambert * attenuation;
+    }
+  }
+  fragColor = vec4(vertColor * light, 1.0);
+}
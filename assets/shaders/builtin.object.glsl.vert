@@ -3,7 +3,11 @@
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
 layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 viewPosition;
+layout(location = 2) out vec3 viewNormal;
 
 layout(set = 0, binding = 0) uniform GlobalUbo {
   mat4 view;
@@ -15,7 +19,13 @@ layout(push_constant) uniform PushConstants {
   mat4 model;
 } pushConsts;
 
+// must match builtin.depth, the depth prepass output is tested EQUAL
+invariant gl_Position;
+
 void main() {
   gl_Position = gUbo.viewProjection * pushConsts.model * vec4(position, 1.0);
   fragColor = color;
+  // lighting happens in view space, see builtin.object.frag
+  viewPosition = vec3(gUbo.view * (pushConsts.model * vec4(position, 1.0)));
+  viewNormal = mat3(gUbo.view) * (transpose(inverse(mat3(pushConsts.model))) * normal);
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Quantized variant of builtin.object, see Engine::PackedMeshVertex
+layout(location = 0) in vec4 position; // unorm16, relative to the mesh bounds
+layout(location = 1) in vec4 color; // rgba8
+layout(location = 2) in vec2 normal; // octahedral snorm16
+layout(location = 3) in vec2 uv; // half floats
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 viewPosition;
+layout(location = 2) out vec3 viewNormal;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+} gUbo;
+
+layout(push_constant) uniform PushConstants {
+  mat4 model;
+  vec4 positionOffset;
+  vec4 positionScale;
+} pushConsts;
+
+// must match builtin.depth.packed, the depth prepass output is tested EQUAL
+invariant gl_Position;
+
+vec3 octahedronDecode(vec2 e) {
+  vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+  float t = max(-n.z, 0.0);
+  n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+  return normalize(n);
+}
+
+void main() {
+  vec3 localPosition = pushConsts.positionOffset.xyz + position.xyz * pushConsts.positionScale.xyz;
+  gl_Position = gUbo.viewProjection * pushConsts.model * vec4(localPosition, 1.0);
+  fragColor = color.rgb;
+  viewPosition = vec3(gUbo.view * (pushConsts.model * vec4(localPosition, 1.0)));
+  viewNormal = mat3(gUbo.view) * (transpose(inverse(mat3(pushConsts.model))) * octahedronDecode(normal));
+}
@@ -4,9 +4,10 @@ project "shaders"
   objdir (ASSETS_OBJ_DIR)
   files {
     "**.vert",
-    "**.frag"
+    "**.frag",
+    "**.comp"
   }
-  filter { "files:**.vert or **.frag"}
+  filter { "files:**.vert or **.frag or **.comp"}
     buildmessage "Compiling %{file.relpath} to %{cfg.targetdir}/%{file.name:gsub('.glsl', '')}.spv"
     buildcommands {
       "{MKDIR} %[%{cfg.targetdir}]",
@@ -50,6 +50,9 @@ Vendors.ImGuizmo = MPDepTrack.new('ImGuizmo')
 Vendors.Engine = MPDepTrack.new('engine', '%{wks.location}/Engine')
   :addInclude("includes")
 
+Vendors.tinyobjloader = MPDepTrack.new('tinyobjloader')
+  :addInclude("")
+
 Vendors.stb_image = MPDepTrack.new('stb_image')
   :addInclude("")
   :addLink("stb_image")
\ No newline at end of file
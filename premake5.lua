@@ -10,7 +10,8 @@ include "dependencies.lua"
 workspace "GameEngine"
   architecture "x64"
   startproject "Editor"
-  configurations { "Debug", "Release" }
+  -- Profile is Release with the CPU zones and the memory tracker, shipping builds don't pay for them
+  configurations { "Debug", "Release", "Profile" }
   flags { "MultiProcessorCompile" }
   defines {
     "_SILENCE_STDEXT_ARR_ITERS_DEPRECATION_WARNING",
@@ -22,12 +23,20 @@ workspace "GameEngine"
   filter "configurations:Debug"
     defines {
       "ENABLE_ENGINE_LOGGING",
-      "ENABLE_APP_LOGGING"
+      "ENABLE_APP_LOGGING",
+      "ENABLE_PROFILING",
+      "ENABLE_MEMORY_TRACKING"
     }
   filter "configurations:Release"
     defines {
       "ENABLE_APP_LOGGING"
     }
+  filter "configurations:Profile"
+    defines {
+      "ENABLE_APP_LOGGING",
+      "ENABLE_PROFILING",
+      "ENABLE_MEMORY_TRACKING"
+    }
   filter "system:linux"
     buildoptions { "-gdwarf-2" }
     defines {
@@ -50,6 +59,7 @@ group ""
 
 group "Tools"
   include "Editor"
+  include "Benchmarks"
 group ""
 
 group "Runtime"